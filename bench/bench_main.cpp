@@ -0,0 +1,495 @@
+/**
+ * @file bench_main.cpp
+ * @brief Micro-benchmarks for the library's hot paths
+ *
+ * INDUSTRY PRACTICE #23: Measure, Don't Guess
+ * ============================================
+ * Performance work needs numbers that can be compared between
+ * releases. Each case here runs a fixed workload against an in-memory
+ * database and reports nanoseconds per operation, in a machine-readable
+ * format so CI can store and chart the results.
+ *
+ * Usage:
+ *   sqlite3db_bench                    # CSV on stdout
+ *   sqlite3db_bench --format=json      # JSON array on stdout
+ *   sqlite3db_bench --filter=batch     # Only cases whose name contains "batch"
+ *   sqlite3db_bench --scale=0.1        # Shrink workloads (quick smoke run)
+ */
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "sqlite3db/sqlite3db.hpp"
+
+using namespace sqlite3db;
+
+namespace {
+
+struct BenchResult {
+    std::string name;
+    int64_t operations;
+    int64_t totalNs;
+
+    double nsPerOp() const {
+        return operations > 0 ? static_cast<double>(totalNs) / static_cast<double>(operations) : 0.0;
+    }
+    double opsPerSec() const {
+        return totalNs > 0 ? static_cast<double>(operations) * 1e9 / static_cast<double>(totalNs) : 0.0;
+    }
+};
+
+struct BenchConfig {
+    std::string format = "csv";
+    std::string filter;
+    double scale = 1.0;
+};
+
+class Runner {
+public:
+    explicit Runner(BenchConfig config) : config_(std::move(config)) {}
+
+    int64_t scaled(int64_t n) const {
+        auto result = static_cast<int64_t>(static_cast<double>(n) * config_.scale);
+        return result > 0 ? result : 1;
+    }
+
+    /**
+     * @param setup Untimed preparation; returns the timed body
+     * @param operations Work units done by one call of the body
+     */
+    void run(const std::string& name, int64_t operations,
+             const std::function<std::function<void()>()>& setup) {
+        if (!config_.filter.empty() && name.find(config_.filter) == std::string::npos) {
+            return;
+        }
+        auto body = setup();
+        auto start = std::chrono::steady_clock::now();
+        body();
+        auto end = std::chrono::steady_clock::now();
+        auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+        results_.push_back({name, operations, static_cast<int64_t>(ns)});
+    }
+
+    void report(std::ostream& out) const {
+        if (config_.format == "json") {
+            out << "[\n";
+            for (size_t i = 0; i < results_.size(); ++i) {
+                const auto& r = results_[i];
+                out << "  {\"name\": \"" << r.name << "\", \"operations\": " << r.operations
+                    << ", \"total_ns\": " << r.totalNs << ", \"ns_per_op\": " << r.nsPerOp()
+                    << ", \"ops_per_sec\": " << r.opsPerSec() << "}"
+                    << (i + 1 < results_.size() ? ",\n" : "\n");
+            }
+            out << "]\n";
+        } else {
+            out << "name,operations,total_ns,ns_per_op,ops_per_sec\n";
+            for (const auto& r : results_) {
+                out << r.name << "," << r.operations << "," << r.totalNs << ","
+                    << r.nsPerOp() << "," << r.opsPerSec() << "\n";
+            }
+        }
+    }
+
+private:
+    BenchConfig config_;
+    std::vector<BenchResult> results_;
+};
+
+// Keep results observable so the optimizer can't drop the work
+volatile int64_t g_sink = 0;
+
+std::unique_ptr<Connection> openBenchDb(size_t cacheSize = 64) {
+    ConnectionOptions opts;
+    opts.statementCacheSize = cacheSize;
+    return Connection::inMemory(opts);
+}
+
+void fillTable(Connection& conn, int64_t rows) {
+    conn.execute("CREATE TABLE data (id INTEGER PRIMARY KEY, i INTEGER, r REAL, t TEXT, b BLOB)");
+    BatchInsertBuilder batch(conn, "data", {"i", "r", "t", "b"});
+    std::vector<uint8_t> blob(64, 0x5A);
+    int64_t next = 0;
+    batch.setBatchSize(10000).insertFrom([&](std::vector<Value>& row) {
+        if (next == rows) {
+            return false;
+        }
+        row.assign({Value{next}, Value{next * 0.5}, Value{"text value " + std::to_string(next)}, Value{blob}});
+        ++next;
+        return true;
+    });
+}
+
+// ========== Cases ==========
+
+void benchPrepare(Runner& runner) {
+    const std::string sql = "SELECT id, name FROM users WHERE id = ? AND name = ?";
+    int64_t n = runner.scaled(100000);
+
+    std::unique_ptr<Connection> conn;
+    auto setup = [&](size_t cacheSize) {
+        return [&, cacheSize]() -> std::function<void()> {
+            conn = openBenchDb(cacheSize);
+            conn->execute("CREATE TABLE users (id INTEGER PRIMARY KEY, name TEXT)");
+            return [&] {
+                for (int64_t i = 0; i < n; ++i) {
+                    auto stmt = conn->prepare(sql);
+                    g_sink = g_sink + stmt.columnCount();
+                }
+            };
+        };
+    };
+
+    runner.run("prepare_cache_hit", n, setup(64));
+    runner.run("prepare_cache_miss", n, setup(0));
+}
+
+void benchBind(Runner& runner) {
+    int64_t n = runner.scaled(500000);
+    std::unique_ptr<Connection> conn;
+    std::optional<Statement> stmt;
+    std::string text(256, 't');
+    std::vector<uint8_t> blob(256, 0x42);
+
+    auto setup = [&](std::function<void(Statement&, int64_t)> bindOne) {
+        return [&, bindOne]() -> std::function<void()> {
+            stmt.reset();
+            conn = openBenchDb();
+            stmt.emplace(conn->prepare("SELECT ?"));
+            return [&, bindOne] {
+                for (int64_t i = 0; i < n; ++i) {
+                    bindOne(*stmt, i);
+                }
+            };
+        };
+    };
+
+    runner.run("bind_int64", n, setup([](Statement& s, int64_t i) { s.bind(1, i); }));
+    runner.run("bind_double", n, setup([](Statement& s, int64_t i) { s.bind(1, i * 0.5); }));
+    runner.run("bind_text_256", n, setup([&](Statement& s, int64_t) { s.bind(1, text); }));
+    runner.run("bind_text_static_256", n, setup([&](Statement& s, int64_t) { s.bindStatic(1, std::string_view(text)); }));
+    runner.run("bind_blob_256", n, setup([&](Statement& s, int64_t) { s.bind(1, blob); }));
+    runner.run("bind_value_text_256", n, setup([&](Statement& s, int64_t) { s.bind(1, Value{text}); }));
+    stmt.reset();
+}
+
+void benchColumns(Runner& runner) {
+    int64_t rows = runner.scaled(100000);
+    std::unique_ptr<Connection> conn;
+
+    auto setup = [&](std::function<void(Statement&)> readRow) {
+        return [&, readRow]() -> std::function<void()> {
+            conn = openBenchDb();
+            fillTable(*conn, rows);
+            return [&, readRow] {
+                auto stmt = conn->prepare("SELECT i, r, t, b FROM data");
+                while (stmt.step()) {
+                    readRow(stmt);
+                }
+            };
+        };
+    };
+
+    runner.run("column_int64", rows, setup([](Statement& s) { g_sink = g_sink + s.columnInt64(0); }));
+    runner.run("column_double", rows, setup([](Statement& s) { g_sink = g_sink + static_cast<int64_t>(s.columnDouble(1)); }));
+    runner.run("column_string", rows, setup([](Statement& s) { g_sink = g_sink + static_cast<int64_t>(s.columnString(2).size()); }));
+    runner.run("column_string_view", rows, setup([](Statement& s) { g_sink = g_sink + static_cast<int64_t>(s.columnStringView(2).size()); }));
+    runner.run("column_blob", rows, setup([](Statement& s) { g_sink = g_sink + static_cast<int64_t>(s.columnBlob(3).size()); }));
+    runner.run("column_blob_view", rows, setup([](Statement& s) { g_sink = g_sink + static_cast<int64_t>(s.columnBlobView(3).size); }));
+    runner.run("column_value", rows, setup([](Statement& s) {
+        for (int i = 0; i < 4; ++i) g_sink = g_sink + static_cast<int64_t>(s.columnValue(i).index());
+    }));
+}
+
+void benchBatchInsert(Runner& runner) {
+    int64_t rows = runner.scaled(100000);
+    std::unique_ptr<Connection> conn;
+
+    for (size_t batchSize : {100u, 1000u, 10000u}) {
+        for (bool multiRow : {false, true}) {
+            std::string name = std::string("batch_insert_") + (multiRow ? "multirow" : "single") +
+                               "_" + std::to_string(batchSize);
+            std::unique_ptr<BatchInsertBuilder> batch;
+            runner.run(name, rows, [&]() -> std::function<void()> {
+                batch.reset();
+                conn = openBenchDb();
+                conn->execute("CREATE TABLE items (id INTEGER PRIMARY KEY, name TEXT, value INTEGER)");
+                batch = std::make_unique<BatchInsertBuilder>(
+                    *conn, "items", std::vector<std::string>{"name", "value"});
+                batch->setBatchSize(batchSize).setMultiRowValues(multiRow);
+                for (int64_t i = 0; i < rows; ++i) {
+                    batch->addRow({Value{"item" + std::to_string(i)}, Value{i}});
+                }
+                return [&] { g_sink = g_sink + batch->execute(); };
+            });
+            batch.reset();
+        }
+    }
+}
+
+void benchFetch(Runner& runner) {
+    int64_t rows = runner.scaled(100000);
+    std::unique_ptr<Connection> conn;
+
+    auto setup = [&](std::function<void()> body) {
+        return [&, body]() -> std::function<void()> {
+            conn = openBenchDb();
+            fillTable(*conn, rows);
+            return body;
+        };
+    };
+
+    runner.run("fetch_all", rows, setup([&] {
+        auto result = QueryBuilder(*conn, "data").select("i, t").fetchAll();
+        g_sink = g_sink + static_cast<int64_t>(result.size());
+    }));
+    runner.run("fetch_result_set", rows, setup([&] {
+        ResultSet result = QueryBuilder(*conn, "data").select("i, t").fetchResultSet();
+        g_sink = g_sink + static_cast<int64_t>(result.rowCount());
+    }));
+    runner.run("fetch_stream", rows, setup([&] {
+        for (const Row& row : QueryBuilder(*conn, "data").select("i, t").stream()) {
+            g_sink = g_sink + row.int64(0) + static_cast<int64_t>(row.text(1).size());
+        }
+    }));
+    runner.run("fetch_columnar", rows, setup([&] {
+        auto reader = QueryBuilder(*conn, "data").select("i, t").columnar();
+        RecordBatch batch;
+        while (reader.next(batch)) {
+            for (int64_t v : batch.column(0).ints) {
+                g_sink = g_sink + v;
+            }
+            g_sink = g_sink + static_cast<int64_t>(batch.column(1).data.size());
+        }
+    }));
+}
+
+void benchBuilders(Runner& runner) {
+    int64_t n = runner.scaled(100000);
+    std::unique_ptr<Connection> conn;
+
+    auto setup = [&](std::function<void()> body) {
+        return [&, body]() -> std::function<void()> {
+            conn = openBenchDb();
+            fillTable(*conn, 1000);
+            return body;
+        };
+    };
+
+    runner.run("builder_point_query", n, setup([&] {
+        for (int64_t i = 0; i < n; ++i) {
+            auto row = QueryBuilder(*conn, "data").select("i, t").where("id", "=", Value{i % 1000 + 1}).fetchOne();
+            g_sink = g_sink + (row ? 1 : 0);
+        }
+    }));
+    runner.run("compiled_point_query", n, setup([&] {
+        auto query = QueryBuilder(*conn, "data").select("i, t").where("id", "=", Value{int64_t(0)}).compile();
+        std::vector<Value> params(1);
+        for (int64_t i = 0; i < n; ++i) {
+            params[0] = i % 1000 + 1;
+            auto row = query.fetchOne(params);
+            g_sink = g_sink + (row ? 1 : 0);
+        }
+    }));
+}
+
+uint64_t fnv1a(std::string_view s) {
+    uint64_t h = 14695981039346656037ull;
+    for (char c : s) {
+        h = (h ^ static_cast<uint8_t>(c)) * 1099511628211ull;
+    }
+    return h;
+}
+
+void benchFunctions(Runner& runner) {
+    int64_t rows = runner.scaled(100000);
+    std::unique_ptr<Connection> conn;
+
+    auto setup = [&](std::function<void()> body) {
+        return [&, body]() -> std::function<void()> {
+            conn = openBenchDb();
+            fillTable(*conn, rows);
+            conn->registerFunction("fnv1a", [](std::string_view s) {
+                return static_cast<int64_t>(fnv1a(s) % 100);
+            });
+            return body;
+        };
+    };
+
+    // 1% of rows match a predicate SQL can't express natively
+    runner.run("filter_fetch_cpp", rows, setup([&] {
+        for (const auto& row : QueryBuilder(*conn, "data").select("id, t").fetchAll()) {
+            if (fnv1a(std::get<std::string>(row[1])) % 100 == 0) {
+                g_sink = g_sink + std::get<int64_t>(row[0]);
+            }
+        }
+    }));
+    runner.run("filter_sql_function", rows, setup([&] {
+        auto stmt = conn->prepare("SELECT id FROM data WHERE fnv1a(t) = 0");
+        while (stmt.step()) {
+            g_sink = g_sink + stmt.columnInt64(0);
+        }
+    }));
+}
+
+void benchMigrations(Runner& runner) {
+    int64_t count = runner.scaled(400);
+    std::unique_ptr<Connection> conn;
+    MigrationManager migrations;
+
+    for (int64_t v = 1; v <= count; ++v) {
+        std::string table = "t" + std::to_string(v);
+        migrations.add(static_cast<int>(v), "create " + table, [table](Connection& db) {
+            db.execute("CREATE TABLE " + table + " (id INTEGER PRIMARY KEY, a TEXT, b INTEGER)");
+            db.execute("CREATE INDEX idx_" + table + "_b ON " + table + "(b)");
+        });
+    }
+
+    runner.run("migration_apply_fresh", count, [&]() -> std::function<void()> {
+        conn = openBenchDb();
+        return [&] { migrations.apply(*conn); };
+    });
+    runner.run("migration_apply_up_to_date", 1, [&]() -> std::function<void()> {
+        if (!conn) {
+            conn = openBenchDb();
+            migrations.apply(*conn);
+        }
+        return [&] { migrations.apply(*conn); };
+    });
+}
+
+void benchBlobs(Runner& runner) {
+    int64_t rows = runner.scaled(32);
+    constexpr int64_t kBlobBytes = 1 << 20;
+    std::unique_ptr<Connection> conn;
+
+    auto setup = [&]() {
+        conn = openBenchDb();
+        conn->execute("CREATE TABLE files (id INTEGER PRIMARY KEY, data BLOB)");
+        auto insert = conn->prepare("INSERT INTO files (data) VALUES (randomblob(?))");
+        for (int64_t i = 0; i < rows; ++i) {
+            insert.bind(1, kBlobBytes).execute();
+        }
+    };
+
+    // Whole-BLOB copies vs 64 KiB chunks through one reopened handle
+    runner.run("blob_read_column", rows, [&]() -> std::function<void()> {
+        setup();
+        return [&] {
+            auto stmt = conn->prepare("SELECT data FROM files");
+            while (stmt.step()) {
+                auto blob = stmt.columnBlob(0);
+                g_sink = g_sink + blob[blob.size() / 2];
+            }
+        };
+    });
+    runner.run("blob_read_stream", rows, [&]() -> std::function<void()> {
+        setup();
+        return [&] {
+            BlobStream stream(*conn, "files", "data", 1);
+            for (int64_t id = 1; id <= rows; ++id) {
+                if (id > 1) {
+                    stream.reopen(id);
+                }
+                stream.forEachChunk([](BlobView chunk) { g_sink = g_sink + chunk[0]; });
+            }
+        };
+    });
+}
+
+void benchImport(Runner& runner) {
+    int64_t rows = runner.scaled(100000);
+    std::unique_ptr<Connection> conn;
+
+    std::string csv = "id,name,score\n";
+    for (int64_t i = 0; i < rows; ++i) {
+        csv += std::to_string(i) + ",name_" + std::to_string(i) + "," + std::to_string(i % 1000) + ".5\n";
+    }
+
+    auto setup = [&]() {
+        conn = openBenchDb();
+        conn->execute("CREATE TABLE trades (id INTEGER, name TEXT, score REAL)");
+    };
+
+    // Split into strings and bind copies vs views bound in place
+    runner.run("import_split_loop", rows, [&]() -> std::function<void()> {
+        setup();
+        return [&] {
+            Transaction txn(*conn);
+            auto insert = conn->prepare("INSERT INTO trades VALUES (?, ?, ?)");
+            size_t pos = csv.find('\n') + 1;
+            while (pos < csv.size()) {
+                size_t end = csv.find('\n', pos);
+                std::string line = csv.substr(pos, end - pos);
+                size_t a = line.find(',');
+                size_t b = line.find(',', a + 1);
+                insert.bind(1, line.substr(0, a))
+                      .bind(2, line.substr(a + 1, b - a - 1))
+                      .bind(3, line.substr(b + 1))
+                      .execute();
+                pos = end + 1;
+            }
+            txn.commit();
+        };
+    });
+    runner.run("import_text", rows, [&]() -> std::function<void()> {
+        setup();
+        return [&] {
+            g_sink = g_sink + importText(*conn, "trades", csv);
+        };
+    });
+}
+
+BenchConfig parseArgs(int argc, char** argv) {
+    BenchConfig config;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg.rfind("--format=", 0) == 0) {
+            config.format = arg.substr(9);
+        } else if (arg.rfind("--filter=", 0) == 0) {
+            config.filter = arg.substr(9);
+        } else if (arg.rfind("--scale=", 0) == 0) {
+            config.scale = std::stod(arg.substr(8));
+        } else {
+            std::cerr << "Usage: " << argv[0]
+                      << " [--format=csv|json] [--filter=substring] [--scale=factor]\n";
+            std::exit(2);
+        }
+    }
+    if (config.format != "csv" && config.format != "json") {
+        std::cerr << "Unknown format: " << config.format << "\n";
+        std::exit(2);
+    }
+    return config;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Runner runner(parseArgs(argc, argv));
+
+    try {
+        benchPrepare(runner);
+        benchBind(runner);
+        benchColumns(runner);
+        benchBatchInsert(runner);
+        benchFetch(runner);
+        benchBuilders(runner);
+        benchFunctions(runner);
+        benchMigrations(runner);
+        benchBlobs(runner);
+        benchImport(runner);
+    } catch (const DatabaseException& e) {
+        std::cerr << "Benchmark failed: " << e.what() << "\n";
+        return 1;
+    }
+
+    runner.report(std::cout);
+    return 0;
+}
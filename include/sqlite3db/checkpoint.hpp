@@ -0,0 +1,201 @@
+/**
+ * @file checkpoint.hpp
+ * @brief Background WAL checkpointing with escalation and metrics
+ *
+ * INDUSTRY PRACTICE #28: Own Your Checkpoints
+ * ============================================
+ * In WAL mode, commits append to the -wal file and a checkpoint later
+ * copies those pages back into the database. By default the checkpoint
+ * runs inside whichever COMMIT crosses 1000 frames. Two problems follow:
+ * - That writer stalls for the whole copy (a random p99 spike)
+ * - A checkpoint cannot pass a page an open reader still needs, so with
+ *   long-lived readers the WAL only grows, and every read has to search
+ *   a bigger WAL index
+ *
+ * CheckpointManager moves checkpoints to a background thread with its
+ * own connection. Attached writers hand their frame counts to it via
+ * sqlite3_wal_hook, which also turns off the inline auto-checkpoint:
+ *
+ *   CheckpointManager checkpoints("app.db");
+ *   checkpoints.attach(writer);   // Writer no longer checkpoints inline
+ *   ...
+ *   auto m = checkpoints.metrics();
+ *   report(m.walSizeBytes, m.framesCheckpointed, m.lastDurationNs);
+ *
+ * Every run starts PASSIVE, which never blocks anyone. If passive runs
+ * keep leaving frames behind, the manager escalates to RESTART or
+ * TRUNCATE. These wait for readers (up to the busy timeout) so that the
+ * WAL can be reset. TRUNCATE also shrinks the file once it is fully
+ * checkpointed but still oversized.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include "connection.hpp"
+
+namespace sqlite3db {
+
+/**
+ * @brief sqlite3_wal_checkpoint_v2 modes
+ */
+enum class CheckpointMode {
+    Passive,   // Copy what it can without waiting for anyone
+    Full,      // Wait for writers, then copy everything
+    Restart,   // Full, then wait for readers so the WAL restarts from the start
+    Truncate   // Restart, then truncate the -wal file to zero bytes
+};
+
+/**
+ * @brief Outcome of one checkpoint
+ */
+struct CheckpointResult {
+    CheckpointMode mode = CheckpointMode::Passive;
+    int resultCode = SQLITE_OK;   // SQLITE_BUSY if it could not finish
+    int framesInLog = 0;          // WAL frames at the time of the checkpoint
+    int framesCheckpointed = 0;   // Of those, copied into the database
+    int64_t durationNs = 0;
+
+    bool complete() const { return resultCode == SQLITE_OK && framesCheckpointed >= framesInLog; }
+};
+
+/**
+ * @brief Configuration for a CheckpointManager
+ */
+struct CheckpointOptions {
+    // How often the WAL size is polled
+    std::chrono::milliseconds pollInterval{1000};
+
+    // Checkpoint when the -wal file is at least this big
+    int64_t walSizeThresholdBytes = int64_t(16) << 20;
+
+    // Checkpoint when an attached writer's commit leaves this many frames
+    // (the same trigger as wal_autocheckpoint, minus the inline stall)
+    int frameThreshold = 1000;
+
+    // Consecutive incomplete PASSIVE runs before escalating
+    int passiveRunsBeforeEscalation = 3;
+
+    // Escalate to TRUNCATE (true) or RESTART (false)
+    bool truncateOnEscalation = true;
+
+    // A fully checkpointed WAL larger than this is truncated (0 = never)
+    int64_t truncateSizeBytes = int64_t(64) << 20;
+
+    // Options for the manager's own connection (its busy timeout bounds
+    // how long RESTART/TRUNCATE wait for readers)
+    ConnectionOptions connectionOptions;
+};
+
+/**
+ * @brief Cumulative checkpoint statistics
+ */
+struct CheckpointMetrics {
+    int64_t walSizeBytes = 0;        // Last observed -wal file size
+    uint64_t checkpoints = 0;
+    uint64_t passiveCheckpoints = 0;
+    uint64_t restartCheckpoints = 0;
+    uint64_t truncateCheckpoints = 0;
+    uint64_t busyCheckpoints = 0;    // Could not finish (readers or a writer active)
+    uint64_t framesCheckpointed = 0;
+    int lastFramesInLog = 0;
+    int64_t lastDurationNs = 0;
+    int64_t maxDurationNs = 0;
+    int64_t totalDurationNs = 0;
+    int lastErrorCode = SQLITE_OK;   // Last failure other than SQLITE_BUSY
+};
+
+/**
+ * @brief Checkpoints a WAL database from a background thread
+ *
+ * Attached connections must be detached (or closed) before the manager
+ * is destroyed.
+ */
+class CheckpointManager {
+public:
+    /**
+     * @brief Open a checkpointing connection and start the thread
+     * @throws ConnectionException if the database cannot be opened
+     */
+    explicit CheckpointManager(const std::string& dbPath,
+                               const CheckpointOptions& options = CheckpointOptions{});
+
+    ~CheckpointManager();
+
+    CheckpointManager(const CheckpointManager&) = delete;
+    CheckpointManager& operator=(const CheckpointManager&) = delete;
+
+    /**
+     * @brief Route a writer's commits to this manager
+     *
+     * Installs sqlite3_wal_hook on the connection, replacing its
+     * auto-checkpoint. Use it from the thread that owns the connection.
+     */
+    void attach(Connection& writer);
+
+    /**
+     * @brief Remove the hook and restore the writer's auto-checkpoint
+     *
+     * Restores the wal_autocheckpoint the writer had when attached (1000,
+     * SQLite's default, for a writer that was never attached).
+     */
+    void detach(Connection& writer);
+
+    /**
+     * @brief Run a checkpoint now, on the calling thread
+     */
+    CheckpointResult checkpoint(CheckpointMode mode = CheckpointMode::Passive);
+
+    /**
+     * @brief Wake the background thread for a checkpoint
+     */
+    void requestCheckpoint();
+
+    /**
+     * @brief Current size of the -wal file in bytes (0 if absent)
+     */
+    int64_t walSizeBytes() const;
+
+    CheckpointMetrics metrics() const;
+
+    /**
+     * @brief Stop the background thread (checkpoint() keeps working)
+     */
+    void stop();
+
+private:
+    static int walHook(void* context, sqlite3* db, const char* dbName, int frames);
+    void workerLoop();
+    void runScheduled();
+
+    CheckpointOptions options_;
+    std::string walPath_;
+
+    // wal_autocheckpoint of each attached writer, restored on detach
+    // (guarded by mutex_)
+    std::unordered_map<sqlite3*, int> savedAutoCheckpoint_;
+    std::unique_ptr<Connection> conn_;
+
+    // Serializes checkpoints on conn_ (background vs checkpoint())
+    std::mutex checkpointMutex_;
+    int incompleteRuns_ = 0;
+
+    mutable std::mutex mutex_;
+    std::condition_variable wake_;
+    bool requested_ = false;
+    bool stopping_ = false;
+    CheckpointMetrics metrics_;
+
+    std::thread worker_;
+};
+
+} // namespace sqlite3db
@@ -25,13 +25,54 @@
 #pragma once
 
 #include <string>
+#include <chrono>
 #include <memory>
 #include <functional>
+#include <optional>
+#include <cstdint>
+#include <utility>
 #include <sqlite3.h>
 #include "exceptions.hpp"
+#include "statement_cache.hpp"
+#include "profiler.hpp"
+#include "result_cache.hpp"
+#include "backup.hpp"
+#include "sql_function.hpp"
+#include "resource_limits.hpp"
 
 namespace sqlite3db {
 
+/**
+ * @brief PRAGMA synchronous: how hard SQLite works to make commits durable
+ *
+ * With WAL, Normal only risks losing the last commits on power loss (never
+ * corruption) and skips most fsyncs; Full syncs on every commit.
+ */
+enum class SynchronousMode {
+    Off,     // No syncs; a crash of the OS can corrupt the database
+    Normal,  // WAL: durable except at power loss; the usual production choice
+    Full,    // Sync on every commit
+    Extra    // Full plus syncing the directory (rollback journal mode)
+};
+
+/**
+ * @brief PRAGMA temp_store: where temporary tables and indices live
+ */
+enum class TempStore {
+    Default,  // Compile-time default (usually a file)
+    File,
+    Memory    // Faster sorts/GROUP BY on big results, costs RAM
+};
+
+/**
+ * @brief Mutex mode requested at open (SQLITE_OPEN_NOMUTEX / FULLMUTEX)
+ */
+enum class ThreadingMode {
+    Default,      // Whatever the library was compiled/configured with
+    MultiThread,  // No connection mutex: the connection must stay on one thread at a time
+    Serialized    // Connection mutex: calls from several threads are serialized
+};
+
 /**
  * @brief Configuration options for database connection
  *
@@ -60,11 +101,75 @@ struct ConnectionOptions {
 
     // Enable extended result codes for more detailed error info
     bool extendedResultCodes = true;
+
+    // Number of idle prepared statements to keep for reuse (0 disables caching)
+    // Repeated prepare() calls with the same SQL skip the SQL compiler
+    size_t statementCacheSize = 64;
+
+    // ---- Performance PRAGMAs (unset = SQLite's default) ----
+    // Applied together in one sqlite3_exec() at open.
+
+    // Bytes of the file to memory-map for reads (PRAGMA mmap_size)
+    // Avoids a copy from the OS page cache per page read
+    std::optional<int64_t> mmapSize;
+
+    // Page cache size in KiB, > 0 (PRAGMA cache_size = -N)
+    std::optional<int64_t> cacheSizeKiB;
+
+    std::optional<SynchronousMode> synchronous;
+
+    std::optional<TempStore> tempStore;
+
+    // Page size in bytes, power of two in [512, 65536] (PRAGMA page_size)
+    // Only takes effect on a new database (before the first table)
+    std::optional<int> pageSize;
+
+    // WAL frames before an automatic checkpoint (0 disables; default 1000)
+    std::optional<int> walAutoCheckpoint;
+
+    ThreadingMode threadingMode = ThreadingMode::Default;
+
+    // ---- Resource limits (unset = SQLite's default) ----
+    // See resource_limits.hpp; Connection::setLimit() covers the rest.
+
+    // Longest SQL text prepare() accepts (SQLITE_LIMIT_SQL_LENGTH)
+    std::optional<int> maxSqlLength;
+
+    // Highest ? parameter index (SQLITE_LIMIT_VARIABLE_NUMBER)
+    std::optional<int> maxVariables;
+
+    // Largest string or BLOB value (SQLITE_LIMIT_LENGTH)
+    std::optional<int> maxValueLength;
+
+    // A step()/execute() call running longer is interrupted
+    // (InterruptedException)
+    std::optional<std::chrono::milliseconds> queryTimeout;
+
+    // ---- Presets ----
+
+    /**
+     * @brief Many readers, few writes: large mmap and cache, synchronous=NORMAL
+     */
+    static ConnectionOptions readHeavy();
+
+    /**
+     * @brief One-off imports: no syncs, no auto-checkpoints, big cache
+     *
+     * Not crash safe (synchronous=OFF). Checkpoint and reopen with a
+     * regular profile when the load is done.
+     */
+    static ConnectionOptions bulkLoad();
+
+    /**
+     * @brief Every commit survives power loss: synchronous=FULL
+     */
+    static ConnectionOptions durable();
 };
 
 // Forward declarations
 class Statement;
 class Transaction;
+class SchemaCatalog;
 
 /**
  * @brief RAII wrapper for SQLite database connection
@@ -153,9 +258,168 @@ public:
      * - Prevents SQL injection attacks
      * - Better performance for repeated queries (compiled once)
      * - Type-safe parameter binding
+     *
+     * Handles come from the connection's statement cache when the same
+     * SQL was prepared before; they are returned to the cache when the
+     * Statement is destroyed (see ConnectionOptions::statementCacheSize).
      */
     Statement prepare(const std::string& sql);
 
+    /**
+     * @brief Access the prepared statement cache
+     */
+    StatementCache& statementCache() { return *statementCache_; }
+
+    /**
+     * @brief Hit/miss/eviction counters for the statement cache
+     */
+    const StatementCacheStats& statementCacheStats() const { return statementCache_->stats(); }
+
+    /**
+     * @brief Start collecting per-statement timing and planner counters
+     *
+     * Replaces any active profiler (statistics start from zero).
+     * See profiler.hpp.
+     */
+    void enableProfiling(const ProfilingOptions& options = ProfilingOptions{});
+
+    /**
+     * @brief Stop profiling and discard the collected statistics
+     */
+    void disableProfiling();
+
+    /**
+     * @brief The active profiler, or nullptr when profiling is off
+     */
+    QueryProfiler* profiler() const { return profiler_.get(); }
+
+    /**
+     * @brief Start caching results of queries that opt in
+     *        (QueryBuilder::cached()); see result_cache.hpp
+     *
+     * Replaces any existing cache (it starts empty).
+     */
+    void enableResultCache(const ResultCacheOptions& options = ResultCacheOptions{});
+
+    /**
+     * @brief Drop the result cache and its hooks
+     */
+    void disableResultCache();
+
+    /**
+     * @brief The result cache, or nullptr when disabled
+     */
+    ResultCache* resultCache() const { return resultCache_.get(); }
+
+    /**
+     * @brief Snapshot of the schema (see schema_catalog.hpp)
+     *
+     * Loaded on first use and kept until PRAGMA schema_version changes;
+     * each call costs one pragma read while the schema is unchanged.
+     * The returned snapshot stays valid after later reloads.
+     */
+    std::shared_ptr<const SchemaCatalog> schemaCatalog();
+
+    /**
+     * @brief Copy this database into destination with the online backup
+     *        API (see backup.hpp), replacing its content
+     * @throws InterruptedException if options.onProgress cancelled the copy
+     * @throws BusyException / DatabaseException if the copy failed; the
+     *         destination keeps its old content
+     */
+    void backupTo(Connection& destination, const BackupOptions& options = BackupOptions{});
+
+    /**
+     * @brief Copy this database into the file at path (created if missing)
+     */
+    void backupTo(const std::string& path, const BackupOptions& options = BackupOptions{});
+
+    /**
+     * @brief Replace this database's content with the file at path,
+     *        e.g. to warm-load an in-memory database
+     */
+    void loadFrom(const std::string& path, const BackupOptions& options = BackupOptions{});
+
+    /**
+     * @brief Write a compacted snapshot to a new file with VACUUM INTO
+     * @throws QueryException if path already exists or can't be written
+     */
+    void vacuumInto(const std::string& path);
+
+    /**
+     * @brief Make a C++ callable available to SQL on this connection
+     *        (see sql_function.hpp)
+     *
+     * The SQL argument count and conversions come from fn's signature,
+     * or from Signature when fn is generic or overloaded:
+     *   conn.registerFunction<int64_t(std::string_view)>("fnv1a", hasher);
+     *
+     * Registering the same name and argument count again replaces the
+     * function.
+     * @throws DatabaseException if SQLite rejects the registration (e.g.
+     *         replacing a function a running statement uses)
+     */
+    template<typename Signature = void, typename Fn>
+    void registerFunction(const std::string& name, Fn&& fn,
+                          const FunctionOptions& options = FunctionOptions{}) {
+        using Resolved = typename detail::ResolveSignature<Signature, std::decay_t<Fn>>::type;
+        detail::registerScalar<Resolved>(db_, name, std::forward<Fn>(fn), options);
+    }
+
+    /**
+     * @brief Register Aggregate (step()/finalize(), optionally
+     *        inverse()/value() for windows) as an aggregate function
+     */
+    template<typename Aggregate>
+    void registerAggregate(const std::string& name,
+                           const FunctionOptions& options = FunctionOptions{}) {
+        detail::registerAggregate<Aggregate>(db_, name, options);
+    }
+
+    /**
+     * @brief Remove the function registered with name and argCount
+     */
+    void removeFunction(const std::string& name, int argCount);
+
+    /**
+     * @brief Memory held by this connection and its page cache counters
+     * @param resetCounters Restart the hit/miss/write/spill counts and
+     *        the lookaside highwater
+     */
+    ConnectionMemoryStats memoryStats(bool resetCounters = false) const;
+
+    /**
+     * @brief Free as much of this connection's page cache as possible
+     */
+    void releaseMemory();
+
+    /**
+     * @brief Current value of a sqlite3_limit category
+     */
+    int limit(SqlLimit category) const;
+
+    /**
+     * @brief Lower (or raise, up to the compile-time maximum) a limit
+     * @return The previous value
+     */
+    int setLimit(SqlLimit category, int value);
+
+    /**
+     * @brief Interrupt step()/execute() calls running longer than timeout
+     *        (0 removes the deadline)
+     */
+    void setQueryTimeout(std::chrono::milliseconds timeout);
+
+    /**
+     * @brief The progress-handler watchdog, installed on first use
+     */
+    QueryWatchdog& enableQueryWatchdog();
+
+    /**
+     * @brief The watchdog, or nullptr when none is installed
+     */
+    QueryWatchdog* queryWatchdog() const { return queryWatchdog_.get(); }
+
     /**
      * @brief Begin a new transaction
      * @return Transaction RAII guard
@@ -215,6 +479,15 @@ private:
 
     sqlite3* db_ = nullptr;
     std::string dbPath_;
+    // Heap-allocated so its address survives moves of the Connection
+    std::unique_ptr<StatementCache> statementCache_;
+    // Heap-allocated because SQLite holds its address as the trace context
+    std::unique_ptr<QueryProfiler> profiler_;
+    // Heap-allocated because SQLite holds its address as the hook context
+    std::unique_ptr<ResultCache> resultCache_;
+    std::shared_ptr<const SchemaCatalog> schemaCatalog_;
+    // Heap-allocated because SQLite holds its address as the progress context
+    std::unique_ptr<QueryWatchdog> queryWatchdog_;
 };
 
 } // namespace sqlite3db
@@ -0,0 +1,171 @@
+/**
+ * @file connection_pool.hpp
+ * @brief Thread-safe pool of reader connections plus a single writer
+ *
+ * INDUSTRY PRACTICE #20: Connection Pooling
+ * ==========================================
+ * Opening a connection is not free: the file is opened, the schema is
+ * parsed, and every PRAGMA in applyOptions() runs again. Services that
+ * open a connection per thread (or per request) pay that cost over and
+ * over, and their writers end up fighting each other for the lock.
+ *
+ * A pool opens connections once and lends them out:
+ * - N read-only connections: in WAL mode, readers never block each other
+ *   or the writer, so reads scale across cores
+ * - Exactly one writer connection: SQLite allows one writer at a time
+ *   anyway, so queueing writers in the pool replaces SQLITE_BUSY
+ *   retries with an orderly wait
+ *
+ * Checkout is RAII: the PooledConnection returns itself on destruction.
+ *
+ *   ConnectionPool pool("app.db");
+ *   {
+ *       auto reader = pool.acquireReader();
+ *       auto rows = QueryBuilder(*reader, "users").fetchAll();
+ *   }  // Returned to the pool here
+ */
+
+#pragma once
+
+#include <string>
+#include <memory>
+#include <vector>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include "connection.hpp"
+
+namespace sqlite3db {
+
+/**
+ * @brief Configuration for a ConnectionPool
+ */
+struct PoolOptions {
+    // Number of read-only connections to keep open
+    size_t readerCount = 4;
+
+    // How long acquire*() waits for a free connection before throwing
+    std::chrono::milliseconds acquireTimeout{5000};
+
+    // Run a trivial query on checkout and reopen the connection if it fails
+    bool healthCheckOnAcquire = true;
+
+    // Options for the writer; readers use the same options opened read-only
+    // (WAL should stay enabled so readers and the writer don't block each other)
+    ConnectionOptions connectionOptions;
+};
+
+class ConnectionPool;
+
+/**
+ * @brief RAII lease of a pooled connection
+ *
+ * Behaves like a pointer to Connection. Returns the connection to
+ * the pool when destroyed. The pool must outlive all of its leases.
+ */
+class PooledConnection {
+public:
+    PooledConnection() = default;
+    ~PooledConnection();
+
+    PooledConnection(const PooledConnection&) = delete;
+    PooledConnection& operator=(const PooledConnection&) = delete;
+
+    PooledConnection(PooledConnection&& other) noexcept;
+    PooledConnection& operator=(PooledConnection&& other) noexcept;
+
+    Connection& operator*() const { return *conn_; }
+    Connection* operator->() const { return conn_.get(); }
+    Connection* get() const { return conn_.get(); }
+
+    explicit operator bool() const { return conn_ != nullptr; }
+
+    /**
+     * @brief True if this lease holds the pool's writer connection
+     */
+    bool isWriter() const { return writer_; }
+
+    /**
+     * @brief Return the connection to the pool early
+     */
+    void release();
+
+private:
+    friend class ConnectionPool;
+
+    PooledConnection(ConnectionPool* pool, std::unique_ptr<Connection> conn, bool writer)
+        : pool_(pool), conn_(std::move(conn)), writer_(writer) {}
+
+    ConnectionPool* pool_ = nullptr;
+    std::unique_ptr<Connection> conn_;
+    bool writer_ = false;
+};
+
+/**
+ * @brief Pool of N read-only connections and one writer to the same file
+ *
+ * All methods are thread-safe. Each leased connection is used by one
+ * thread at a time, which is how SQLite connections should be used.
+ */
+class ConnectionPool {
+public:
+    /**
+     * @brief Open the writer and all reader connections
+     * @param dbPath Database file (in-memory databases cannot be shared)
+     * @param options Pool configuration
+     * @throws ConnectionException if any connection fails to open
+     */
+    explicit ConnectionPool(const std::string& dbPath,
+                            const PoolOptions& options = PoolOptions{});
+
+    ~ConnectionPool() = default;
+
+    // Non-copyable, non-moveable: leases hold a pointer to the pool
+    ConnectionPool(const ConnectionPool&) = delete;
+    ConnectionPool& operator=(const ConnectionPool&) = delete;
+
+    /**
+     * @brief Borrow a read-only connection
+     * @throws ConnectionException if none becomes free within the timeout
+     */
+    PooledConnection acquireReader();
+    PooledConnection acquireReader(std::chrono::milliseconds timeout);
+
+    /**
+     * @brief Borrow the writer connection
+     * @throws ConnectionException if it is not returned within the timeout
+     */
+    PooledConnection acquireWriter();
+    PooledConnection acquireWriter(std::chrono::milliseconds timeout);
+
+    /**
+     * @brief Check all idle connections and reopen any that are broken
+     * @return Number of connections that were replaced
+     */
+    size_t checkHealth();
+
+    size_t readerCount() const { return options_.readerCount; }
+    size_t idleReaders() const;
+    bool writerIdle() const;
+
+    const std::string& path() const { return dbPath_; }
+
+private:
+    friend class PooledConnection;
+
+    void release(std::unique_ptr<Connection> conn, bool writer) noexcept;
+    std::unique_ptr<Connection> openConnection(bool writer) const;
+    bool isHealthy(Connection& conn) const;
+    void ensureHealthy(std::unique_ptr<Connection>& conn, bool writer) const;
+
+    std::string dbPath_;
+    PoolOptions options_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable readerReturned_;
+    std::condition_variable writerReturned_;
+    std::vector<std::unique_ptr<Connection>> idleReaders_;
+    std::unique_ptr<Connection> idleWriter_;
+};
+
+} // namespace sqlite3db
@@ -0,0 +1,144 @@
+/**
+ * @file cursor.hpp
+ * @brief Lazy, range-for friendly iteration over query results
+ *
+ * INDUSTRY PRACTICE #21: Streaming Result Sets
+ * =============================================
+ * Materializing a result (fetchAll(), findAll()) allocates every row
+ * before the first one can be used. For big scans that means memory
+ * grows with the table, and latency to the first row grows with it.
+ *
+ * A cursor steps the underlying statement on demand instead:
+ *
+ *   for (const Row& row : QueryBuilder(conn, "events").stream()) {
+ *       if (row.int64(0) == 42) break;  // Early exit is fine
+ *       process(row.text(1));           // Borrowed, no copy
+ *   }
+ *
+ * Only the current row exists at any time, so memory stays flat no
+ * matter how many rows are scanned. Leaving the loop (normally, by
+ * break, or by exception) releases the statement and its read lock.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <iterator>
+#include "statement.hpp"
+
+namespace sqlite3db {
+
+/**
+ * @brief Lightweight view of the cursor's current row
+ *
+ * Borrowed accessors (view(), text(), blob()) are valid until the
+ * cursor advances; value() makes an owning copy.
+ */
+class Row {
+public:
+    explicit Row(Statement& stmt) : stmt_(&stmt) {}
+
+    int columnCount() const { return stmt_->columnCount(); }
+    std::string columnName(int index) const { return stmt_->columnName(index); }
+    bool isNull(int index) const { return stmt_->isNull(index); }
+
+    int64_t int64(int index) const { return stmt_->columnInt64(index); }
+    double real(int index) const { return stmt_->columnDouble(index); }
+    std::string_view text(int index) const { return stmt_->columnStringView(index); }
+    BlobView blob(int index) const { return stmt_->columnBlobView(index); }
+
+    ValueView view(int index) const { return stmt_->columnValueView(index); }
+    Value value(int index) const { return stmt_->columnValue(index); }
+
+    /**
+     * @brief Copy the whole row into owning values
+     */
+    std::vector<Value> values() const;
+
+    /**
+     * @brief The underlying statement (e.g. for Repository::fromRow)
+     */
+    Statement& statement() const { return *stmt_; }
+
+private:
+    Statement* stmt_;
+};
+
+/**
+ * @brief Forward-only cursor over a prepared, bound statement
+ *
+ * Single pass: begin() may be called once. Move-only, because it owns
+ * the statement.
+ */
+class Cursor {
+public:
+    class Iterator {
+    public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type = Row;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const Row*;
+        using reference = const Row&;
+
+        Iterator() = default;
+
+        reference operator*() const { return cursor_->row_; }
+        pointer operator->() const { return &cursor_->row_; }
+
+        Iterator& operator++() {
+            if (!cursor_->advance()) {
+                cursor_ = nullptr;
+            }
+            return *this;
+        }
+
+        // Input iterators need only `++it`; callers shouldn't use the copy
+        void operator++(int) { ++*this; }
+
+        bool operator==(const Iterator& other) const { return cursor_ == other.cursor_; }
+        bool operator!=(const Iterator& other) const { return cursor_ != other.cursor_; }
+
+    private:
+        friend class Cursor;
+        explicit Iterator(Cursor* cursor) : cursor_(cursor) {}
+
+        Cursor* cursor_ = nullptr;  // nullptr == end
+    };
+
+    explicit Cursor(Statement stmt);
+
+    Cursor(const Cursor&) = delete;
+    Cursor& operator=(const Cursor&) = delete;
+    Cursor(Cursor&& other) noexcept;
+    Cursor& operator=(Cursor&& other) = delete;
+
+    /**
+     * @brief Step to the first row
+     * @throws QueryException if called twice or the query fails
+     */
+    Iterator begin();
+    Iterator end() { return Iterator(); }
+
+    /**
+     * @brief Step to the next row manually
+     * @return false when there are no more rows
+     */
+    bool next() { return advance(); }
+
+    /**
+     * @brief The current row (valid after next() returned true)
+     */
+    const Row& row() const { return row_; }
+
+    Statement& statement() { return stmt_; }
+
+private:
+    bool advance();
+
+    Statement stmt_;
+    Row row_;
+    bool started_ = false;
+    bool done_ = false;
+};
+
+} // namespace sqlite3db
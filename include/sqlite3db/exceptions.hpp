@@ -89,6 +89,41 @@ private:
     std::string sql_;
 };
 
+/**
+ * @brief Thrown when a query fails because of lock contention
+ *
+ * SQLITE_BUSY (another connection holds a conflicting lock) and
+ * SQLITE_LOCKED (a conflict within the same process) are transient: the
+ * same work usually succeeds if it is retried after the other side
+ * finishes. Inside a transaction, the whole transaction has to be rolled
+ * back and rerun; see withTransaction(conn, RetryPolicy, ...).
+ */
+class BusyException : public QueryException {
+public:
+    BusyException(const std::string& message, const std::string& sql, int errorCode)
+        : QueryException(message, sql, errorCode) {}
+};
+
+/**
+ * @brief Thrown when a query was stopped by sqlite3_interrupt()
+ *
+ * Raised for SQLITE_INTERRUPT, e.g. when an AsyncTask is cancelled
+ * while its statement runs, or before it started.
+ */
+class InterruptedException : public QueryException {
+public:
+    InterruptedException(const std::string& message, const std::string& sql)
+        : QueryException(message, sql, SQLITE_INTERRUPT) {}
+};
+
+/**
+ * @brief True for SQLITE_BUSY / SQLITE_LOCKED and their extended codes
+ */
+inline bool isBusyError(int errorCode) noexcept {
+    int primary = errorCode & 0xFF;
+    return primary == SQLITE_BUSY || primary == SQLITE_LOCKED;
+}
+
 /**
  * @brief Thrown when schema validation fails
  */
@@ -133,4 +168,25 @@ private:
     int version_;
 };
 
+/**
+ * @brief Throw the exception type matching a failed SQLite result code
+ *
+ * Constraint violations become ConstraintException, lock contention
+ * BusyException, interrupts InterruptedException, and everything else
+ * QueryException. Extended result
+ * codes are matched on their primary code (result & 0xFF).
+ */
+[[noreturn]] inline void throwQueryError(const std::string& message, const std::string& sql, int errorCode) {
+    if ((errorCode & 0xFF) == SQLITE_CONSTRAINT) {
+        throw ConstraintException(message, errorCode);
+    }
+    if (isBusyError(errorCode)) {
+        throw BusyException(message, sql, errorCode);
+    }
+    if ((errorCode & 0xFF) == SQLITE_INTERRUPT) {
+        throw InterruptedException(message, sql);
+    }
+    throw QueryException(message, sql, errorCode);
+}
+
 } // namespace sqlite3db
@@ -0,0 +1,181 @@
+/**
+ * @file index_advisor.hpp
+ * @brief Find missing indexes from EXPLAIN QUERY PLAN and suggest them
+ *
+ * INDUSTRY PRACTICE #39: Read the Query Plan Before Production Does
+ * ==================================================================
+ * A query without a usable index works fine on a developer's 100-row
+ * database and scans a million rows in production. The planner tells
+ * you this in advance, through EXPLAIN QUERY PLAN:
+ * - "SCAN orders": every row is read
+ * - "SEARCH o USING AUTOMATIC COVERING INDEX (user_id=?)": SQLite
+ *   builds a throwaway index for this one statement, then drops it
+ * - "USE TEMP B-TREE FOR ORDER BY": the result is sorted separately
+ *
+ * IndexAdvisor runs the plan for a query, flags these steps, and works
+ * out an index that removes them:
+ *
+ *   IndexAdvisor advisor(conn);
+ *   QueryAnalysis a = advisor.analyze(
+ *       QueryBuilder(conn, "orders").where("user_id", "=", Value{int64_t{1}})
+ *                                    .orderBy("created_at"));
+ *   for (const auto& s : a.suggestions) std::cout << s.createSql() << "\n";
+ *   // CREATE INDEX IF NOT EXISTS idx_orders_user_id_created_at
+ *   //     ON "orders" ("user_id", "created_at")
+ *
+ * Candidates are built from the columns the SQL compares with =/IN
+ * (first), ranges and ORDER BY / GROUP BY, then tried one by one on an
+ * empty in-memory copy of the schema, which keeps the check cheap
+ * however big the tables are. A candidate is suggested only if the
+ * planner actually uses it and it constrains more columns or removes a
+ * sort. Without ANALYZE statistics the planner assumes every index is
+ * selective, so treat suggestions as leads (as with the sqlite3 shell's
+ * .expert), not as proof.
+ *
+ * Other inputs and outputs:
+ * - analyzeProfile(): the statements the profiler saw scanning, sorting
+ *   or building automatic indexes, costliest first
+ * - checkRequiredIndexes(): SchemaValidator::requireIndex() indexes
+ *   that none of the analyzed queries used
+ * - toMigration(): the suggestions as a reversible Migration
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+#include "connection.hpp"
+#include "migration.hpp"
+#include "profiler.hpp"
+#include "repository.hpp"
+
+namespace sqlite3db {
+
+/**
+ * @brief One row of EXPLAIN QUERY PLAN
+ */
+struct PlanStep {
+    int id = 0;
+    int parent = 0;
+    std::string detail;  // e.g. "SEARCH users USING INDEX idx_users_email (email=?)"
+};
+
+enum class PlanIssueKind {
+    FullScan,        // SCAN of a table
+    AutomaticIndex,  // Index built for one statement and thrown away
+    TempBTree        // Separate sort for ORDER BY / GROUP BY / DISTINCT
+};
+
+struct PlanIssue {
+    PlanIssueKind kind;
+    std::string table;   // Empty for TempBTree
+    std::string detail;  // The plan step
+};
+
+/**
+ * @brief An index the advisor expects to help
+ */
+struct IndexSuggestion {
+    std::string table;
+    std::vector<std::string> columns;  // Equality columns first
+
+    // idx_<table>_<columns...>
+    std::string name() const;
+    std::string createSql() const;
+    std::string dropSql() const;
+};
+
+struct QueryAnalysis {
+    std::string sql;
+    std::vector<PlanStep> plan;
+    std::vector<PlanIssue> issues;
+    std::vector<IndexSuggestion> suggestions;
+    std::vector<std::string> indexesUsed;
+
+    bool clean() const { return issues.empty(); }
+
+    /**
+     * @brief The plan as text, one step per line, children indented
+     */
+    std::string planText() const;
+};
+
+/**
+ * @brief Runs and interprets query plans against one connection
+ *
+ * Keeps every analysis (history()) for checkRequiredIndexes(),
+ * suggestions() and toMigration(). Not thread-safe; the connection
+ * must outlive the advisor.
+ */
+class IndexAdvisor {
+public:
+    explicit IndexAdvisor(Connection& conn);
+    ~IndexAdvisor();
+
+    IndexAdvisor(const IndexAdvisor&) = delete;
+    IndexAdvisor& operator=(const IndexAdvisor&) = delete;
+
+    /**
+     * @brief Explain sql (placeholders may stay unbound) and suggest indexes
+     * @throws QueryException if sql doesn't compile
+     */
+    QueryAnalysis analyze(const std::string& sql);
+
+    /**
+     * @brief analyze(query.toSql())
+     */
+    QueryAnalysis analyze(const QueryBuilder& query);
+
+    /**
+     * @brief Analyze the statements profiler recorded full-scan steps,
+     *        sorts or automatic indexes for, most total time first
+     * @param maxStatements Stop after this many
+     *
+     * Statements that no longer compile (e.g. their table was dropped)
+     * are skipped.
+     */
+    std::vector<QueryAnalysis> analyzeProfile(const QueryProfiler& profiler,
+                                              size_t maxStatements = 20);
+
+    const std::vector<QueryAnalysis>& history() const { return history_; }
+
+    /**
+     * @brief Suggestions from all analyses, without duplicates
+     *
+     * A suggestion whose columns start another's on the same table is
+     * left out: the longer index serves both.
+     */
+    std::vector<IndexSuggestion> suggestions() const;
+
+    /**
+     * @brief validator's required indexes that no analyzed query used
+     * @return One "unused_index" error per such index
+     */
+    std::vector<SchemaValidator::ValidationError> checkRequiredIndexes(
+        const SchemaValidator& validator) const;
+
+    /**
+     * @brief suggestions() as a migration (CREATE INDEX IF NOT EXISTS up,
+     *        DROP INDEX down)
+     */
+    Migration toMigration(int version,
+                          const std::string& description = "Add advised indexes") const;
+
+    /**
+     * @brief Forget the history
+     */
+    void clear() { history_.clear(); }
+
+private:
+    struct Scratch;
+
+    Scratch& scratch(const SchemaCatalog& catalog);
+
+    Connection& conn_;
+    std::unique_ptr<Scratch> scratch_;
+    std::vector<QueryAnalysis> history_;
+};
+
+} // namespace sqlite3db
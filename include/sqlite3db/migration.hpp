@@ -25,6 +25,16 @@
  * A new installation runs all migrations.
  * An existing v2 database only runs migration 3.
  *
+ * Long histories make both ends slow: a fresh database replays every
+ * migration, and each one pays for its own transaction (a journal sync
+ * per COMMIT). Two options keep startup fast:
+ * - A baseline: a schema snapshot equal to migrations 1..N. An empty
+ *   database runs the snapshot instead of replaying them, in one
+ *   transaction, and records 1..N as applied.
+ * - Single-transaction mode: all pending migrations and their
+ *   __migrations rows commit together, with the check for pending work
+ *   done under the same write lock.
+ *
  * INDUSTRY PRACTICE #13: Schema Validation
  * ==========================================
  * Beyond migrations, validate that the schema is correct:
@@ -40,7 +50,9 @@
 #include <vector>
 #include <functional>
 #include <map>
+#include <utility>
 #include "connection.hpp"
+#include "schema_catalog.hpp"
 
 namespace sqlite3db {
 
@@ -121,6 +133,39 @@ public:
      */
     void add(Migration migration);
 
+    /**
+     * @brief Squash migrations 1..version into a schema snapshot
+     * @param version Last migration the snapshot includes
+     * @param schemaSql SQL script creating that schema (e.g. from
+     *        snapshotSchema() on a fully migrated database)
+     * @throws MigrationException if version is not positive
+     *
+     * Used only on an empty database whose target is at least version.
+     * Migrations <= version must still be registered to upgrade existing
+     * databases older than the baseline.
+     */
+    void setBaseline(int version, std::string schemaSql);
+
+    /**
+     * @brief Dump the schema as a script suitable for setBaseline()
+     *
+     * CREATE statements for tables, then indexes, views and triggers,
+     * excluding SQLite's internal tables and __migrations. Rows are not
+     * included: put seed data in a migration after the baseline.
+     */
+    static std::string snapshotSchema(Connection& conn);
+
+    /**
+     * @brief Apply all pending migrations in one transaction
+     *
+     * Fewer commits make large upgrades much faster, and the IMMEDIATE
+     * transaction keeps two processes from applying the same migration.
+     * If any migration fails, none of them are applied. Off by default:
+     * each migration gets its own transaction, and a failure keeps the
+     * ones before it.
+     */
+    MigrationManager& setSingleTransaction(bool enable = true);
+
     /**
      * @brief Apply all pending migrations
      * @param conn Database connection
@@ -129,6 +174,7 @@ public:
      * Migrations are applied in a transaction:
      * - If a migration fails, all changes are rolled back
      * - The database version remains at the last successful migration
+     *   (or unchanged, in single-transaction mode)
      */
     void apply(Connection& conn);
 
@@ -171,10 +217,18 @@ public:
 
 private:
     void ensureMigrationTable(Connection& conn) const;
-    void recordMigration(Connection& conn, int version) const;
+    int readVersion(Connection& conn) const;
+    bool isEmptyDatabase(Connection& conn) const;
+    std::vector<int> versionsBetween(int current, int targetVersion) const;
+    void runMigration(Connection& conn, int version) const;
+    void applyBaseline(Connection& conn) const;
+    void recordMigrations(Connection& conn, const std::vector<int>& versions) const;
     void removeMigrationRecord(Connection& conn, int version) const;
 
     std::map<int, Migration> migrations_;
+    int baselineVersion_ = 0;  // 0 = no baseline
+    std::string baselineSql_;
+    bool singleTransaction_ = false;
 };
 
 /**
@@ -232,13 +286,26 @@ public:
     SchemaValidator& requireIndex(const std::string& tableName,
                                    const std::string& indexName);
 
+    /**
+     * @brief (table, index) pairs passed to requireIndex()
+     */
+    std::vector<std::pair<std::string, std::string>> requiredIndexes() const;
+
     /**
      * @brief Run validation
      * @param conn Database connection
      * @return List of validation errors (empty if valid)
+     *
+     * Checks against conn.schemaCatalog(): one schema query however many
+     * requirements there are, none while the schema is unchanged.
      */
     std::vector<ValidationError> validate(Connection& conn) const;
 
+    /**
+     * @brief Run validation against an already loaded schema snapshot
+     */
+    std::vector<ValidationError> validate(const SchemaCatalog& catalog) const;
+
     /**
      * @brief Validate and throw if errors found
      * @throws SchemaException with all validation errors
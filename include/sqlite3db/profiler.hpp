@@ -0,0 +1,174 @@
+/**
+ * @file profiler.hpp
+ * @brief Per-statement latency and planner statistics, slow-query hooks
+ *
+ * INDUSTRY PRACTICE #24: Always-On Query Instrumentation
+ * =======================================================
+ * "Which query is slow?" should be answerable from production metrics,
+ * not from an incident post-mortem. SQLite can report, for every
+ * statement run:
+ * - Wall time (sqlite3_trace_v2 with SQLITE_TRACE_PROFILE)
+ * - Rows scanned without an index (SQLITE_STMTSTATUS_FULLSCAN_STEP)
+ * - Sorts and automatic indexes the planner had to add
+ * - Virtual machine steps (a hardware-independent cost measure)
+ *
+ * The profiler aggregates these per SQL text into a latency histogram
+ * and counters, and calls a slow-query callback above a threshold:
+ *
+ *   ProfilingOptions opts;
+ *   opts.slowQueryThreshold = std::chrono::milliseconds(50);
+ *   opts.onSlowQuery = [](const SlowQuery& q) { log(q.sql, q.durationNs); };
+ *   conn.enableProfiling(opts);
+ *   ...
+ *   for (const auto& s : conn.profiler()->snapshot()) report(s);
+ *
+ * Cost per statement execution is one callback, a hash lookup by handle,
+ * and a few counter reads, so it can stay enabled in production.
+ */
+
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <sqlite3.h>
+
+namespace sqlite3db {
+
+/**
+ * @brief Information passed to the slow-query callback
+ */
+struct SlowQuery {
+    std::string sql;           // SQL text (with bound values if expandSlowQuerySql)
+    int64_t durationNs = 0;
+    int64_t fullScanSteps = 0;
+    int64_t sorts = 0;
+    int64_t autoIndexes = 0;
+    int64_t vmSteps = 0;
+};
+
+/**
+ * @brief Configuration for Connection::enableProfiling()
+ */
+struct ProfilingOptions {
+    // Executions at or above this duration trigger onSlowQuery (0 = never)
+    std::chrono::microseconds slowQueryThreshold{0};
+
+    // Called on the connection's thread; must not use the connection
+    std::function<void(const SlowQuery&)> onSlowQuery;
+
+    // Include bound parameter values in SlowQuery::sql.
+    // Off by default: values may contain user data.
+    bool expandSlowQuerySql = false;
+
+    // Count rows returned per statement (adds one callback per row)
+    bool countRows = false;
+
+    // Distinct SQL texts tracked; further ones are merged into "<other>"
+    size_t maxTrackedStatements = 1000;
+};
+
+/**
+ * @brief Aggregated statistics for one SQL text
+ */
+struct QueryStats {
+    // Bucket i counts executions taking [2^(i-1), 2^i) microseconds;
+    // bucket 0 is < 1us, the last bucket is open-ended
+    static constexpr size_t kLatencyBuckets = 26;
+
+    std::string sql;
+    uint64_t executions = 0;
+    int64_t totalNs = 0;
+    int64_t minNs = 0;
+    int64_t maxNs = 0;
+    uint64_t rows = 0;           // Only with ProfilingOptions::countRows
+    int64_t fullScanSteps = 0;
+    int64_t sorts = 0;
+    int64_t autoIndexes = 0;
+    int64_t vmSteps = 0;
+    std::array<uint64_t, kLatencyBuckets> latencyHistogram{};
+
+    double meanNs() const {
+        return executions == 0 ? 0.0 : static_cast<double>(totalNs) / static_cast<double>(executions);
+    }
+
+    /**
+     * @brief Approximate latency percentile (upper bound of the bucket)
+     * @param p Percentile in [0, 100]
+     */
+    int64_t percentileNs(double p) const;
+};
+
+/**
+ * @brief Collects statistics from SQLite's trace hooks for one connection
+ *
+ * Created by Connection::enableProfiling(). snapshot() and reset() may
+ * be called from other threads (e.g. a metrics exporter).
+ */
+class QueryProfiler {
+public:
+    explicit QueryProfiler(ProfilingOptions options);
+
+    QueryProfiler(const QueryProfiler&) = delete;
+    QueryProfiler& operator=(const QueryProfiler&) = delete;
+
+    /**
+     * @brief Statistics per SQL text, most total time first
+     */
+    std::vector<QueryStats> snapshot() const;
+
+    /**
+     * @brief Statistics for one SQL text, if it has run
+     */
+    QueryStats stats(const std::string& sql) const;
+
+    /**
+     * @brief Total statement executions observed
+     */
+    uint64_t totalExecutions() const;
+
+    /**
+     * @brief Number of slow-query callbacks fired
+     */
+    uint64_t slowQueries() const;
+
+    /**
+     * @brief Clear all statistics
+     */
+    void reset();
+
+    const ProfilingOptions& options() const { return options_; }
+
+    /**
+     * @brief Mask of SQLITE_TRACE_* events this profiler needs
+     */
+    unsigned traceMask() const;
+
+    /**
+     * @brief sqlite3_trace_v2 callback; context is the profiler
+     */
+    static int traceCallback(unsigned type, void* context, void* p, void* x);
+
+private:
+    void onProfile(sqlite3_stmt* stmt, int64_t ns);
+    void onRow(sqlite3_stmt* stmt);
+    QueryStats& entryFor(sqlite3_stmt* stmt);
+
+    ProfilingOptions options_;
+
+    mutable std::mutex mutex_;
+    std::unordered_map<std::string, QueryStats> stats_;
+    // Fast path: handle -> entry, verified against the SQL text on use
+    // because finalized handles can be reused for other statements
+    std::unordered_map<sqlite3_stmt*, QueryStats*> byHandle_;
+    std::unordered_map<sqlite3_stmt*, uint64_t> pendingRows_;
+    uint64_t totalExecutions_ = 0;
+    uint64_t slowQueries_ = 0;
+};
+
+} // namespace sqlite3db
@@ -54,12 +54,104 @@
 #include <optional>
 #include <functional>
 #include <sstream>
+#include <algorithm>
+#include <type_traits>
 #include "connection.hpp"
 #include "statement.hpp"
 #include "transaction.hpp"
+#include "cursor.hpp"
+#include "columnar.hpp"
+#include "result_set.hpp"
+#include "blob_stream.hpp"
 
 namespace sqlite3db {
 
+/**
+ * @brief A SELECT built once and re-run with new parameter values
+ *
+ * INDUSTRY PRACTICE #32: Build Once, Bind Many
+ * =============================================
+ * A builder used per request pays for string concatenation, a statement
+ * cache lookup (hashing the SQL), and copies of its Values every time,
+ * even though only the values change. compile() does the SQL generation
+ * and prepare() once and keeps the statement checked out:
+ *
+ *   // At startup
+ *   auto byEmail = QueryBuilder(conn, "users").where("email", "=", Value{""}).compile();
+ *
+ *   // Per request: bind + step only
+ *   auto user = byEmail.fetchOne({Value{email}});
+ *
+ * Parameters are positional, in the order the builder added them (WHERE
+ * values, then the HAVING value). The values given to the builder are
+ * kept as defaults for the no-argument overloads. The connection must
+ * outlive the compiled query. Not thread-safe, like Statement.
+ */
+class CompiledQuery {
+public:
+    CompiledQuery(Statement stmt, std::vector<Value> defaults);
+
+    std::vector<std::vector<Value>> fetchAll() { return fetchAll(defaults_); }
+    std::vector<std::vector<Value>> fetchAll(const std::vector<Value>& params);
+
+    std::optional<std::vector<Value>> fetchOne() { return fetchOne(defaults_); }
+    std::optional<std::vector<Value>> fetchOne(const std::vector<Value>& params);
+
+    ResultSet fetchResultSet() { return fetchResultSet(defaults_); }
+    ResultSet fetchResultSet(const std::vector<Value>& params);
+
+    /**
+     * @brief Call fn(const Row&) for each row without materializing them
+     */
+    template<typename Func>
+    void forEach(const std::vector<Value>& params, Func&& fn) {
+        ScopedReset guard(stmt_);
+        bindAll(params);
+        Row row(stmt_);
+        while (stmt_.step()) {
+            fn(static_cast<const Row&>(row));
+        }
+    }
+
+    /**
+     * @brief Number of ? placeholders the SQL expects
+     */
+    int parameterCount() const { return sqlite3_bind_parameter_count(stmt_.handle()); }
+
+    const std::string& sql() const { return stmt_.sql(); }
+    Statement& statement() { return stmt_; }
+
+private:
+    void bindAll(const std::vector<Value>& params);
+
+    Statement stmt_;
+    std::vector<Value> defaults_;
+};
+
+/**
+ * @brief An INSERT (or upsert) built once and re-run with new values
+ *
+ * See CompiledQuery. Values are bound in the builder's column order.
+ */
+class CompiledInsert {
+public:
+    CompiledInsert(Statement stmt, Connection& conn);
+
+    /**
+     * @brief Insert one row
+     * @return Last insert row ID
+     * @throws QueryException if the value count doesn't match the columns
+     */
+    int64_t execute(const std::vector<Value>& values);
+
+    int parameterCount() const { return sqlite3_bind_parameter_count(stmt_.handle()); }
+    const std::string& sql() const { return stmt_.sql(); }
+
+private:
+    Statement stmt_;
+    Connection& conn_;
+};
+
 /**
  * @brief Simple query builder for SELECT statements
  *
@@ -84,8 +176,8 @@ public:
     QueryBuilder& from(const std::string& table);
 
     // WHERE clauses
-    QueryBuilder& where(const std::string& column, const std::string& op, const Value& value);
-    QueryBuilder& where(const std::string& rawCondition, const Value& value);
+    QueryBuilder& where(const std::string& column, const std::string& op, Value value);
+    QueryBuilder& where(const std::string& rawCondition, Value value);
     QueryBuilder& whereNull(const std::string& column);
     QueryBuilder& whereNotNull(const std::string& column);
     QueryBuilder& whereIn(const std::string& column, const std::vector<Value>& values);
@@ -103,21 +195,69 @@ public:
 
     // GROUP BY / HAVING
     QueryBuilder& groupBy(const std::string& column);
-    QueryBuilder& having(const std::string& condition, const Value& value);
+    QueryBuilder& having(const std::string& condition, Value value);
+
+    /**
+     * @brief Serve fetchAll/fetchOne/count from the connection's result cache
+     *
+     * No effect unless Connection::enableResultCache() was called.
+     * Invalidation tracks the FROM and JOIN tables only.
+     */
+    QueryBuilder& cached(bool enable = true);
 
     // Execute and fetch
     std::vector<std::vector<Value>> fetchAll();
     std::optional<std::vector<Value>> fetchOne();
+
+    /**
+     * @brief Fetch all rows into one arena-backed ResultSet
+     *
+     * Same rows as fetchAll(), without a heap allocation per row or per
+     * TEXT/BLOB cell. Not served from the result cache.
+     */
+    ResultSet fetchResultSet();
     int64_t count();
 
+    /**
+     * @brief Lazily iterate the results, one row per step
+     *
+     *   for (const Row& row : qb.stream()) { ... }
+     *
+     * Memory stays flat regardless of result size.
+     */
+    Cursor stream();
+
+    /**
+     * @brief Read the results as column-major record batches
+     *
+     *   auto reader = qb.columnar();
+     *   RecordBatch batch;
+     *   while (reader.next(batch)) { sum(batch.column("amount").reals); }
+     */
+    ColumnarReader columnar(const ColumnarOptions& options = ColumnarOptions{});
+
+    /**
+     * @brief Generate and prepare the SQL once (see CompiledQuery)
+     */
+    CompiledQuery compile() const;
+
     // Get the built SQL (for debugging)
     std::string toSql() const;
 
+    const std::string& table() const { return table_; }
+
 private:
+    Statement prepareBound(const std::string& sql) const;
+    std::vector<Value> parameters() const;
+    ResultCache* activeCache() const;
+    std::string cacheKey(const std::string& sql) const;
+    std::vector<std::string> sourceTables() const;
+
     Connection& conn_;
     std::string table_;
     std::string selectClause_ = "*";
     std::vector<std::string> joins_;
+    std::vector<std::string> joinTables_;
     std::vector<std::string> whereClauses_;
     std::vector<Value> whereValues_;
     std::string orderByClause_;
@@ -127,6 +267,7 @@ private:
     bool hasHaving_ = false;
     int limit_ = -1;
     int offset_ = -1;
+    bool cached_ = false;
 };
 
 /**
@@ -146,7 +287,7 @@ public:
     /**
      * @brief Add a column-value pair
      */
-    InsertBuilder& value(const std::string& column, const Value& val);
+    InsertBuilder& value(const std::string& column, Value val);
 
     /**
      * @brief Execute the insert
@@ -162,9 +303,24 @@ public:
      */
     int64_t upsert();
 
+    /**
+     * @brief Prepare the INSERT once for the builder's columns
+     *
+     * Values added with value() are not used; pass them to execute().
+     */
+    CompiledInsert compile() const;
+
+    /**
+     * @brief Prepare the INSERT OR REPLACE once
+     */
+    CompiledInsert compileUpsert() const;
+
     std::string toSql() const;
 
 private:
+    std::string buildSql(const char* verb) const;
+    int64_t run(const std::string& sql);
+
     Connection& conn_;
     std::string table_;
     std::vector<std::string> columns_;
@@ -192,9 +348,38 @@ private:
  *   batch.execute();  // Single transaction for all rows
  *
  * Performance difference: 10-100x faster for large inserts!
+ *
+ * Multi-row VALUES mode goes one step further: instead of one
+ * sqlite3_step per row, many rows are packed into a single
+ *   INSERT INTO t (a, b) VALUES (?, ?), (?, ?), ...
+ * statement, sized to stay under SQLite's bound-parameter limit:
+ *   batch.setMultiRowValues(true).execute();
+ *
+ * Streaming mode keeps memory flat for huge imports: every batchSize
+ * rows are written and committed as soon as they arrive, and execute()
+ * only flushes the tail:
+ *   batch.setStreaming(true);
+ *   while (reader.next(row)) batch.addRow(std::move(row));
+ *   batch.execute();
+ *
+ * Upsert mode turns every INSERT into
+ *   INSERT ... ON CONFLICT (key) DO UPDATE SET col = excluded.col
+ * which updates an existing row in place. INSERT OR REPLACE instead
+ * deletes it and inserts a new one: every index entry is rewritten,
+ * delete triggers fire, and a rowid not given explicitly changes.
+ *   BatchUpsertBuilder sync(conn, "users", {"email", "name"}, {"email"});
  */
 class BatchInsertBuilder {
 public:
+    /**
+     * @brief Upper bound on parameters per multi-row statement
+     *
+     * Very long VALUES lists cost more to compile than they save in
+     * stepping; around a thousand parameters is the measured sweet spot
+     * (see the batch_insert_multirow_* benchmarks).
+     */
+    static constexpr int kMaxMultiRowVariables = 999;
+
     BatchInsertBuilder(Connection& conn, const std::string& table,
                        const std::vector<std::string>& columns);
 
@@ -203,12 +388,38 @@ public:
      */
     BatchInsertBuilder& addRow(const std::vector<Value>& values);
 
+    /**
+     * @brief Add a row by moving its values in (no copy)
+     */
+    BatchInsertBuilder& addRow(std::vector<Value>&& values);
+
     /**
      * @brief Execute the batch insert
-     * @return Number of rows inserted
+     * @return Number of rows inserted (in streaming mode, including
+     *         batches already flushed by addRow)
      */
     int64_t execute();
 
+    /**
+     * @brief Insert rows pulled from a producer callback
+     * @param producer Fills the given row and returns true, or returns
+     *                 false when there are no more rows
+     * @return Number of rows inserted
+     *
+     * Rows are bound straight from the producer's buffer, which is reused
+     * for every row, and committed every batchSize rows. Nothing is
+     * buffered in the builder.
+     */
+    int64_t insertFrom(const std::function<bool(std::vector<Value>&)>& producer);
+
+    /**
+     * @brief Flush and commit every batchSize rows as they are added
+     *
+     * Call execute() at the end to write the final partial batch;
+     * rows still buffered when the builder is destroyed are discarded.
+     */
+    BatchInsertBuilder& setStreaming(bool enable = true);
+
     /**
      * @brief Set batch size for very large inserts
      *
@@ -217,6 +428,37 @@ public:
      */
     BatchInsertBuilder& setBatchSize(size_t size);
 
+    /**
+     * @brief Insert many rows per statement with a multi-row VALUES list
+     *
+     * Rows per statement = min(batch size, variable budget / column count),
+     * where the budget is the connection's variable limit capped at
+     * kMaxMultiRowVariables.
+     * The full-size statement is prepared once and reused; only the final
+     * partial chunk of each batch uses a shorter statement.
+     */
+    BatchInsertBuilder& setMultiRowValues(bool enable = true);
+
+    /**
+     * @brief Upsert: update rows that conflict on conflictColumns in place
+     * @param conflictColumns Columns of a PRIMARY KEY or UNIQUE index
+     * @param updateColumns Columns set from the new row; defaults to every
+     *        column not in conflictColumns. With none, conflicting rows
+     *        are left as they are (DO NOTHING).
+     * @throws QueryException if conflictColumns is empty
+     */
+    BatchInsertBuilder& onConflictUpdate(const std::vector<std::string>& conflictColumns,
+                                         const std::vector<std::string>& updateColumns = {});
+
+    /**
+     * @brief In upsert mode, skip conflicting rows whose update columns
+     *        already hold the new values
+     *
+     * Unchanged rows then cost a lookup instead of a page write, which
+     * is most rows of a typical re-sync.
+     */
+    BatchInsertBuilder& setUpdateOnlyChanged(bool enable = true);
+
     /**
      * @brief Clear all rows (for reuse)
      */
@@ -224,12 +466,60 @@ public:
 
     size_t rowCount() const { return rows_.size(); }
 
+    /**
+     * @brief Rows packed into each statement in multi-row mode
+     */
+    size_t rowsPerStatement() const;
+
 private:
+    std::string buildSql(size_t rowCount) const;
+    void buildUpsertClause();
+    void resetStatements();
+    int64_t insertRange(size_t begin, size_t end);
+    void bindRows(Statement& stmt, size_t begin, size_t end);
+    void checkRowSize(const std::vector<Value>& values) const;
+    void flushIfFull();
+    Statement& rowStatement();
+
     Connection& conn_;
     std::string table_;
     std::vector<std::string> columns_;
     std::vector<std::vector<Value>> rows_;
     size_t batchSize_ = 1000;  // Default: 1000 rows per batch
+    bool multiRow_ = false;
+    bool streaming_ = false;
+    int64_t flushedRows_ = 0;  // Streaming: rows already committed
+
+    // Upsert mode (empty conflictColumns_ = plain INSERT)
+    std::vector<std::string> conflictColumns_;
+    std::vector<std::string> updateColumns_;
+    bool updateOnlyChanged_ = false;
+    std::string upsertClause_;
+
+    // Prepared statements kept across batches and execute() calls
+    std::optional<Statement> rowStmt_;
+    std::optional<Statement> multiStmt_;
+    size_t multiStmtRows_ = 0;
+};
+
+/**
+ * @brief BatchInsertBuilder in upsert mode (see onConflictUpdate())
+ *
+ *   BatchUpsertBuilder sync(conn, "products", {"sku", "name", "price"}, {"sku"});
+ *   sync.setMultiRowValues().setUpdateOnlyChanged();
+ *   for (const auto& p : feed) sync.addRow({p.sku, p.name, p.price});
+ *   sync.execute();  // One transaction per batch, updates in place
+ */
+class BatchUpsertBuilder : public BatchInsertBuilder {
+public:
+    BatchUpsertBuilder(Connection& conn, const std::string& table,
+                       const std::vector<std::string>& columns,
+                       const std::vector<std::string>& conflictColumns,
+                       const std::vector<std::string>& updateColumns = {})
+        : BatchInsertBuilder(conn, table, columns)
+    {
+        onConflictUpdate(conflictColumns, updateColumns);
+    }
 };
 
 /**
@@ -263,8 +553,19 @@ private:
 template<typename T>
 class Repository {
 public:
+    /**
+     * @brief Number of ids fetched per statement by findByIds()
+     */
+    static constexpr size_t kFindByIdsChunkSize = 64;
+
     Repository(Connection& conn, const std::string& tableName)
-        : conn_(conn), tableName_(tableName) {}
+        : conn_(conn)
+        , tableName_(tableName)
+        , findByIdSql_("SELECT * FROM " + tableName + " WHERE id = ?")
+        , deleteByIdSql_("DELETE FROM " + tableName + " WHERE id = ?")
+        , countSql_("SELECT COUNT(*) FROM " + tableName)
+        , existsSql_("SELECT 1 FROM " + tableName + " WHERE id = ? LIMIT 1")
+    {}
 
     virtual ~Repository() = default;
 
@@ -272,13 +573,59 @@ public:
      * @brief Find entity by primary key
      */
     std::optional<T> findById(int64_t id) {
-        auto stmt = conn_.prepare(
-            "SELECT * FROM " + tableName_ + " WHERE id = ?");
-        stmt.bind(1, id);
-        if (stmt.step()) {
-            return fromRow(stmt);
+        if (findByIdActive_) {
+            // fromRow() called back in while the cached statement is mid-step
+            Statement nested = conn_.prepare(findByIdSql_);
+            return findByIdWith(nested, id);
+        }
+        ActiveFlag active(findByIdActive_);
+        return findByIdWith(cached(findByIdStmt_, findByIdSql_), id);
+    }
+
+    /**
+     * @brief Find several entities by primary key
+     *
+     * Ids are fetched kFindByIdsChunkSize at a time with a single cached
+     * "WHERE id IN (...)" statement, instead of one query per id.
+     * Missing ids are skipped; results are in no particular order.
+     */
+    std::vector<T> findByIds(const std::vector<int64_t>& ids) {
+        std::vector<T> results;
+        if (ids.empty()) {
+            return results;
+        }
+        results.reserve(ids.size());
+
+        if (findByIdsActive_) {
+            Statement nested = conn_.prepare(findByIdsSql());
+            findByIdsWith(nested, ids, results);
+            return results;
+        }
+        ActiveFlag active(findByIdsActive_);
+        if (!findByIdsStmt_) {
+            findByIdsStmt_.emplace(conn_.prepare(findByIdsSql()));
+        }
+        findByIdsWith(*findByIdsStmt_, ids, results);
+        return results;
+    }
+
+    /**
+     * @brief Visit every entity without materializing the whole table
+     * @param fn Called with each entity; may return bool, false stops early
+     */
+    template<typename Func>
+    void forEach(Func&& fn) {
+        Cursor cursor(conn_.prepare("SELECT * FROM " + tableName_));
+        while (cursor.next()) {
+            T entity = fromRow(cursor.statement());
+            if constexpr (std::is_same_v<std::invoke_result_t<Func&, T&>, bool>) {
+                if (!fn(entity)) {
+                    return;
+                }
+            } else {
+                fn(entity);
+            }
         }
-        return std::nullopt;
     }
 
     /**
@@ -293,13 +640,23 @@ public:
         return results;
     }
 
+    /**
+     * @brief Get all rows as an arena-backed ResultSet instead of entities
+     *
+     * For bulk reads where building a T per row is the cost to avoid.
+     */
+    ResultSet findAllResultSet() {
+        auto stmt = conn_.prepare("SELECT * FROM " + tableName_);
+        return ResultSet::read(stmt);
+    }
+
     /**
      * @brief Delete by primary key
      * @return true if entity was deleted
      */
     bool deleteById(int64_t id) {
-        auto stmt = conn_.prepare(
-            "DELETE FROM " + tableName_ + " WHERE id = ?");
+        Statement& stmt = cached(deleteByIdStmt_, deleteByIdSql_);
+        ScopedReset guard(stmt);
         stmt.bind(1, id);
         stmt.execute();
         return conn_.changes() > 0;
@@ -309,8 +666,8 @@ public:
      * @brief Count all entities
      */
     int64_t count() {
-        auto stmt = conn_.prepare(
-            "SELECT COUNT(*) FROM " + tableName_);
+        Statement& stmt = cached(countStmt_, countSql_);
+        ScopedReset guard(stmt);
         stmt.step();
         return stmt.columnInt64(0);
     }
@@ -319,12 +676,24 @@ public:
      * @brief Check if entity exists
      */
     bool exists(int64_t id) {
-        auto stmt = conn_.prepare(
-            "SELECT 1 FROM " + tableName_ + " WHERE id = ? LIMIT 1");
+        Statement& stmt = cached(existsStmt_, existsSql_);
+        ScopedReset guard(stmt);
         stmt.bind(1, id);
         return stmt.step();
     }
 
+    /**
+     * @brief Stream a large column of one entity instead of loading it
+     *
+     * Lets fromRow() skip multi-MB fields (select them out, or leave them
+     * unread) and fetch them on demand in chunks. Requires id to be the
+     * table's INTEGER PRIMARY KEY, i.e. the rowid.
+     * @throws DatabaseException if there is no such entity or column
+     */
+    BlobStream openBlob(int64_t id, const std::string& column, BlobMode mode = BlobMode::ReadOnly) {
+        return BlobStream(conn_, tableName_, column, id, mode);
+    }
+
 protected:
     /**
      * @brief Convert a database row to entity
@@ -340,6 +709,75 @@ protected:
 
     Connection& conn_;
     std::string tableName_;
+
+private:
+    // Marks a cached statement as being stepped for the current scope
+    struct ActiveFlag {
+        explicit ActiveFlag(bool& flag) : flag_(flag) { flag_ = true; }
+        ~ActiveFlag() { flag_ = false; }
+        bool& flag_;
+    };
+
+    std::optional<T> findByIdWith(Statement& stmt, int64_t id) {
+        ScopedReset guard(stmt);
+        stmt.bind(1, id);
+        if (stmt.step()) {
+            return fromRow(stmt);
+        }
+        return std::nullopt;
+    }
+
+    void findByIdsWith(Statement& stmt, const std::vector<int64_t>& ids, std::vector<T>& results) {
+        for (size_t start = 0; start < ids.size(); start += kFindByIdsChunkSize) {
+            size_t end = std::min(start + kFindByIdsChunkSize, ids.size());
+            ScopedReset guard(stmt);
+
+            // A short final chunk repeats its last id to fill the
+            // remaining slots, so one statement shape serves every chunk
+            for (size_t slot = 0; slot < kFindByIdsChunkSize; ++slot) {
+                size_t idx = std::min(start + slot, end - 1);
+                stmt.bind(static_cast<int>(slot + 1), ids[idx]);
+            }
+
+            while (stmt.step()) {
+                results.push_back(fromRow(stmt));
+            }
+        }
+    }
+
+    // Prepared lazily on first use: the table may not exist yet
+    // when the repository is constructed
+    Statement& cached(std::optional<Statement>& slot, const std::string& sql) {
+        if (!slot) {
+            slot.emplace(conn_.prepare(sql));
+        }
+        return *slot;
+    }
+
+    std::string findByIdsSql() const {
+        std::string sql = "SELECT * FROM " + tableName_ + " WHERE id IN (?";
+        for (size_t i = 1; i < kFindByIdsChunkSize; ++i) {
+            sql += ", ?";
+        }
+        sql += ")";
+        return sql;
+    }
+
+    // Fixed query set, built once per repository
+    std::string findByIdSql_;
+    std::string deleteByIdSql_;
+    std::string countSql_;
+    std::string existsSql_;
+
+    std::optional<Statement> findByIdStmt_;
+    std::optional<Statement> findByIdsStmt_;
+    std::optional<Statement> deleteByIdStmt_;
+    std::optional<Statement> countStmt_;
+    std::optional<Statement> existsStmt_;
+
+    // The statement is being stepped, so fromRow() may not reuse it
+    bool findByIdActive_ = false;
+    bool findByIdsActive_ = false;
 };
 
 } // namespace sqlite3db
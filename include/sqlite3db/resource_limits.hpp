@@ -0,0 +1,202 @@
+/**
+ * @file resource_limits.hpp
+ * @brief Memory accounting, heap limits, sqlite3_limit caps and query deadlines
+ *
+ * INDUSTRY PRACTICE #40: Bound What One Connection Can Take
+ * ==========================================================
+ * A process with dozens of connections has dozens of page caches,
+ * statement caches and result caches, and no single number for what
+ * they add up to. One runaway query (a cross join, a 10 MB IN list)
+ * can then take the whole node down.
+ *
+ * Measure per connection and for the library:
+ *
+ *   ConnectionMemoryStats m = conn.memoryStats();
+ *   gauge("sqlite.cache_bytes", m.cacheBytes);
+ *   gauge("sqlite.cache_hit_rate", m.cacheHitRate());
+ *   gauge("sqlite.heap_bytes", libraryMemoryStats().usedBytes);
+ *
+ * and limit:
+ *
+ *   setSoftHeapLimit(512 << 20);       // Caches shrink past 512 MiB
+ *   ConnectionOptions opts;
+ *   opts.cacheSizeKiB = 16 * 1024;     // Page cache per connection
+ *   opts.maxSqlLength = 100000;        // Reject huge generated SQL
+ *   opts.maxVariables = 2000;          // ... and huge IN (?, ?, ...) lists
+ *   opts.queryTimeout = std::chrono::seconds(2);
+ *
+ * The query timeout is enforced by a QueryWatchdog installed as the
+ * connection's progress handler: every kCheckInterval VM instructions it
+ * checks the deadline of the running step() / execute() call, and
+ * interrupts it once passed (InterruptedException). It is the single
+ * owner of the progress handler; AsyncExecutor adds its cancel flag to
+ * it rather than replacing it.
+ *
+ * Heap limits are process-wide. Past the soft limit SQLite frees cache
+ * pages before allocating more; past the hard limit allocations fail
+ * with SQLITE_NOMEM.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <utility>
+#include <sqlite3.h>
+
+namespace sqlite3db {
+
+/**
+ * @brief Per-connection memory and page cache counters (sqlite3_db_status)
+ */
+struct ConnectionMemoryStats {
+    int64_t cacheBytes = 0;         // Page cache (SQLITE_DBSTATUS_CACHE_USED)
+    int64_t schemaBytes = 0;        // Parsed schema (SCHEMA_USED)
+    int64_t statementBytes = 0;     // Prepared statements, incl. cached ones (STMT_USED)
+    int64_t lookasideSlots = 0;     // Lookaside slots in use (LOOKASIDE_USED)
+    int64_t lookasideHighwater = 0;
+
+    // Page cache activity since open (or the last reset)
+    int64_t cacheHits = 0;
+    int64_t cacheMisses = 0;
+    int64_t cacheWrites = 0;
+    int64_t cacheSpills = 0;        // Dirty pages written mid-transaction for lack of room
+
+    // Library-side buffers
+    size_t resultCacheBytes = 0;    // Connection::resultCache(), if enabled
+    size_t cachedStatements = 0;    // Idle handles in the statement cache
+
+    int64_t totalBytes() const {
+        return cacheBytes + schemaBytes + statementBytes + static_cast<int64_t>(resultCacheBytes);
+    }
+
+    double cacheHitRate() const {
+        int64_t total = cacheHits + cacheMisses;
+        return total == 0 ? 0.0 : static_cast<double>(cacheHits) / static_cast<double>(total);
+    }
+};
+
+/**
+ * @brief Process-wide SQLite heap counters (sqlite3_status64)
+ *
+ * Zero when SQLite was built with SQLITE_DEFAULT_MEMSTATUS=0.
+ */
+struct MemoryStats {
+    int64_t usedBytes = 0;
+    int64_t highwaterBytes = 0;
+    int64_t allocations = 0;        // Outstanding allocations
+    int64_t largestAllocation = 0;  // Largest request seen
+    int64_t softHeapLimit = 0;      // 0 = none
+    int64_t hardHeapLimit = 0;      // 0 = none
+};
+
+/**
+ * @param resetHighwater Start highwater and largestAllocation over
+ */
+MemoryStats libraryMemoryStats(bool resetHighwater = false);
+
+/**
+ * @brief sqlite3_soft_heap_limit64: past it, caches shrink before growing
+ * @param bytes 0 removes the limit
+ * @return The previous limit
+ */
+int64_t setSoftHeapLimit(int64_t bytes);
+
+/**
+ * @brief sqlite3_hard_heap_limit64: past it, allocations fail (SQLITE_NOMEM)
+ * @param bytes 0 removes the limit
+ * @return The previous limit
+ */
+int64_t setHardHeapLimit(int64_t bytes);
+
+/**
+ * @brief sqlite3_limit categories
+ */
+enum class SqlLimit {
+    Length = SQLITE_LIMIT_LENGTH,                 // Largest string or BLOB
+    SqlLength = SQLITE_LIMIT_SQL_LENGTH,          // Longest SQL text
+    Column = SQLITE_LIMIT_COLUMN,
+    ExprDepth = SQLITE_LIMIT_EXPR_DEPTH,
+    CompoundSelect = SQLITE_LIMIT_COMPOUND_SELECT,
+    VdbeOp = SQLITE_LIMIT_VDBE_OP,
+    FunctionArg = SQLITE_LIMIT_FUNCTION_ARG,
+    Attached = SQLITE_LIMIT_ATTACHED,
+    LikePatternLength = SQLITE_LIMIT_LIKE_PATTERN_LENGTH,
+    VariableNumber = SQLITE_LIMIT_VARIABLE_NUMBER, // Highest ? index
+    TriggerDepth = SQLITE_LIMIT_TRIGGER_DEPTH,
+    WorkerThreads = SQLITE_LIMIT_WORKER_THREADS
+};
+
+/**
+ * @brief The connection's progress handler: query deadline plus an
+ *        optional cancel check
+ *
+ * Created by Connection::enableQueryWatchdog() (or a queryTimeout).
+ * The deadline covers one Statement::step(), Statement::execute() or
+ * Connection::execute() call; statements stepped through the raw handle
+ * aren't timed. Used on the connection's thread only.
+ */
+class QueryWatchdog {
+public:
+    // VM instructions between checks
+    static constexpr int kCheckInterval = 1000;
+
+    QueryWatchdog() = default;
+    QueryWatchdog(const QueryWatchdog&) = delete;
+    QueryWatchdog& operator=(const QueryWatchdog&) = delete;
+
+    /**
+     * @brief Longest a single call may run (0 = no deadline)
+     */
+    void setTimeout(std::chrono::milliseconds timeout) { timeout_ = timeout; }
+    std::chrono::milliseconds timeout() const { return timeout_; }
+
+    /**
+     * @brief Also interrupt whenever check() returns true
+     */
+    void setCancelCheck(std::function<bool()> check) { cancelCheck_ = std::move(check); }
+
+    /**
+     * @brief Statements interrupted by the deadline so far
+     */
+    uint64_t timeouts() const { return timeouts_; }
+
+    /**
+     * @brief Arms the deadline for one call; nested calls (e.g. from a
+     *        SQL function) keep the outer deadline
+     */
+    class Scope {
+    public:
+        explicit Scope(QueryWatchdog* watchdog);
+        ~Scope();
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+        /**
+         * @brief Message for a failed call: the timeout if it caused it,
+         *        else sqlite3_errmsg(db)
+         */
+        std::string errorMessage(sqlite3* db) const;
+
+    private:
+        QueryWatchdog* watchdog_;
+    };
+
+    /**
+     * @brief sqlite3_progress_handler callback; context is the watchdog
+     */
+    static int progressCallback(void* context);
+
+private:
+    std::chrono::milliseconds timeout_{0};
+    std::chrono::steady_clock::time_point deadline_;
+    int depth_ = 0;
+    bool timedOut_ = false;
+    uint64_t timeouts_ = 0;
+    std::function<bool()> cancelCheck_;
+};
+
+} // namespace sqlite3db
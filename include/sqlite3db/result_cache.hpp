@@ -0,0 +1,159 @@
+/**
+ * @file result_cache.hpp
+ * @brief Per-connection read-through cache of query results
+ *
+ * INDUSTRY PRACTICE #29: Cache Reads, Invalidate on Writes
+ * =========================================================
+ * Dashboards and config lookups run the same SELECT with the same
+ * parameters over and over against tables that rarely change. Even with
+ * a prepared statement, each run steps the VM through the same pages.
+ *
+ * The result cache keeps materialized results keyed on the SQL text
+ * plus the bound values:
+ *
+ *   conn.enableResultCache();
+ *   auto rows = QueryBuilder(conn, "settings").where("scope", "=", "ui").cached().fetchAll();
+ *
+ * A hit copies the stored rows and never touches SQLite's VM.
+ * Invalidation is per table:
+ * - sqlite3_update_hook bumps a table's generation on every write made
+ *   through this connection. Entries remember the generations they were
+ *   built from and are dropped on mismatch.
+ * - Results seen inside a transaction that already wrote to the table
+ *   are not stored, because it may still roll back.
+ * - PRAGMA data_version (one cached statement, a counter read) detects
+ *   commits by other connections or processes and clears the cache.
+ * - If total_changes() moves without matching hook calls (WITHOUT ROWID
+ *   tables, the truncate optimization) the cache is cleared as well.
+ *
+ * Table names are compared case-insensitively.
+ * Schema changes are not tracked: call invalidateAll() after DDL.
+ * Only the tables named in the builder (FROM and JOINs) are tracked, so
+ * don't cache queries whose raw conditions read other tables.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <sqlite3.h>
+#include "statement.hpp"
+
+namespace sqlite3db {
+
+/**
+ * @brief Limits for a ResultCache
+ */
+struct ResultCacheOptions {
+    // Total estimated size of cached results
+    size_t maxBytes = size_t(16) << 20;
+
+    // Most results kept (least recently used are evicted first)
+    size_t maxEntries = 4096;
+
+    // Results larger than this are not cached at all
+    size_t maxResultBytes = size_t(1) << 20;
+};
+
+struct ResultCacheStats {
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+    uint64_t stores = 0;
+    uint64_t evictions = 0;      // Dropped for space
+    uint64_t invalidations = 0;  // Dropped because a table changed
+    uint64_t fullClears = 0;     // External or untracked changes
+    size_t entries = 0;
+    size_t bytes = 0;
+
+    double hitRate() const {
+        uint64_t total = hits + misses;
+        return total == 0 ? 0.0 : static_cast<double>(hits) / static_cast<double>(total);
+    }
+};
+
+/**
+ * @brief Result cache bound to one connection (see file comment)
+ *
+ * Created by Connection::enableResultCache(). Like the connection, it
+ * is not thread-safe.
+ */
+class ResultCache {
+public:
+    using Rows = std::vector<std::vector<Value>>;
+
+    ResultCache(sqlite3* db, const ResultCacheOptions& options);
+    ~ResultCache();
+
+    ResultCache(const ResultCache&) = delete;
+    ResultCache& operator=(const ResultCache&) = delete;
+
+    /**
+     * @brief Build the cache key for a query: SQL plus encoded parameters
+     * @param extra Optional parameter bound after params (e.g. HAVING value)
+     */
+    static std::string makeKey(const std::string& sql, const std::vector<Value>& params,
+                               const Value* extra = nullptr);
+
+    /**
+     * @brief Cached rows for key, or nullptr on a miss
+     */
+    std::shared_ptr<const Rows> lookup(const std::string& key);
+
+    /**
+     * @brief Remember rows produced from the given tables
+     */
+    void store(const std::string& key, const std::vector<std::string>& tables, Rows rows);
+
+    void invalidateTable(const std::string& table);
+    void invalidateAll();
+
+    const ResultCacheStats& stats() const { return stats_; }
+    void resetStats();
+
+    const ResultCacheOptions& options() const { return options_; }
+
+private:
+    struct Entry {
+        std::string key;
+        std::shared_ptr<const Rows> rows;
+        std::vector<std::pair<std::string, uint64_t>> tableGenerations;
+        size_t bytes = 0;
+    };
+    using EntryList = std::list<Entry>;
+
+    static void updateHook(void* context, int op, const char* dbName, const char* table, sqlite3_int64 rowid);
+
+    void onWrite(const char* table);
+    // No transaction open: forget tables written by the previous one
+    void endTransactionIfIdle();
+    // Clears everything if another connection committed or changes went untracked
+    void checkExternalChanges();
+    int64_t readDataVersion();
+    bool isCurrent(const Entry& entry) const;
+    void erase(EntryList::iterator it);
+    uint64_t generation(const std::string& table) const;
+
+    sqlite3* db_;
+    ResultCacheOptions options_;
+    ResultCacheStats stats_;
+
+    EntryList lru_;  // Front = most recently used
+    std::unordered_map<std::string, EntryList::iterator> index_;
+
+    std::unordered_map<std::string, uint64_t> generations_;
+    std::vector<std::string> writtenInTransaction_;
+    std::string lastWrittenTable_;  // Skips repeated bumps during bulk writes
+    bool lastWriteCounted_ = false;
+    bool lastWriteInTransaction_ = false;
+
+    sqlite3_stmt* dataVersionStmt_ = nullptr;
+    int64_t dataVersion_ = 0;
+    int64_t changesBaseline_ = 0;   // total_changes() minus hooked rows
+    int64_t hookedRows_ = 0;
+};
+
+} // namespace sqlite3db
@@ -0,0 +1,181 @@
+/**
+ * @file result_set.hpp
+ * @brief Materialized query results backed by a single arena
+ *
+ * INDUSTRY PRACTICE #31: One Allocation Per Result, Not Per Cell
+ * ===============================================================
+ * fetchAll() returns std::vector<std::vector<Value>>: every row is a
+ * heap vector, and every TEXT or BLOB cell longer than the small-string
+ * buffer is another malloc, later followed by a free. A 100k-row result
+ * means hundreds of thousands of allocator calls on both ends.
+ *
+ * ResultSet stores the same data in three pieces:
+ * - One contiguous array of 16-byte cells (rows x columns)
+ * - One arena of large blocks that all TEXT/BLOB bytes are copied into
+ * - The column names
+ *
+ *   ResultSet users = QueryBuilder(conn, "users").fetchResultSet();
+ *   for (const auto& row : users) {
+ *       std::string_view email = row.text(2);  // Points into the arena
+ *   }
+ *
+ * Cells are trivially copyable views. Destroying the result frees a
+ * handful of blocks, no matter how many cells there were. Views stay
+ * valid as long as the ResultSet (moving it keeps them valid too).
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "statement.hpp"
+
+namespace sqlite3db {
+
+/**
+ * @brief Arena-backed, read-only query result (see file comment)
+ *
+ * Move-only.
+ */
+class ResultSet {
+public:
+    /**
+     * @brief A borrowed row of a ResultSet
+     *
+     * Typed accessors return 0 / empty for NULL or a different storage
+     * type; use view() to inspect the actual type.
+     */
+    class RowRef {
+    public:
+        RowRef(const ResultSet* result, size_t row) : result_(result), row_(row) {}
+
+        int columnCount() const { return result_->columnCount(); }
+        bool isNull(int column) const { return result_->cell(row_, column).type == SQLITE_NULL; }
+
+        int64_t int64(int column) const;
+        double real(int column) const;
+        std::string_view text(int column) const;
+        BlobView blob(int column) const;
+
+        ValueView view(int column) const { return result_->view(row_, column); }
+        Value value(int column) const { return toValue(view(column)); }
+        std::vector<Value> values() const;
+
+        size_t index() const { return row_; }
+
+    private:
+        const ResultSet* result_;
+        size_t row_;
+    };
+
+    class Iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = RowRef;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const RowRef*;
+        using reference = RowRef;
+
+        Iterator(const ResultSet* result, size_t row) : result_(result), row_(row) {}
+
+        RowRef operator*() const { return RowRef(result_, row_); }
+        Iterator& operator++() { ++row_; return *this; }
+        Iterator operator++(int) { Iterator old = *this; ++row_; return old; }
+
+        bool operator==(const Iterator& other) const { return row_ == other.row_; }
+        bool operator!=(const Iterator& other) const { return row_ != other.row_; }
+
+    private:
+        const ResultSet* result_;
+        size_t row_;
+    };
+
+    ResultSet() = default;
+
+    ResultSet(const ResultSet&) = delete;
+    ResultSet& operator=(const ResultSet&) = delete;
+    ResultSet(ResultSet&&) noexcept = default;
+    ResultSet& operator=(ResultSet&&) noexcept = default;
+
+    /**
+     * @brief Step stmt to the end, copying every row
+     * @throws QueryException if stepping fails
+     */
+    static ResultSet read(Statement& stmt);
+
+    /**
+     * @brief Copy the statement's current row (after a successful step())
+     *
+     * The first row fixes the column count and names.
+     */
+    void append(Statement& stmt);
+
+    size_t rowCount() const { return columns_ == 0 ? 0 : cells_.size() / static_cast<size_t>(columns_); }
+    int columnCount() const { return columns_; }
+    bool empty() const { return cells_.empty(); }
+
+    const std::string& columnName(int column) const { return names_.at(static_cast<size_t>(column)); }
+
+    /**
+     * @return Index of the named column, or -1
+     */
+    int columnIndex(const std::string& name) const;
+
+    RowRef row(size_t index) const { return RowRef(this, index); }
+    RowRef operator[](size_t index) const { return RowRef(this, index); }
+
+    Iterator begin() const { return Iterator(this, 0); }
+    Iterator end() const { return Iterator(this, rowCount()); }
+
+    ValueView view(size_t row, int column) const;
+
+    /**
+     * @brief Copy into the row-major Value layout fetchAll() returns
+     */
+    std::vector<std::vector<Value>> toValues() const;
+
+    /**
+     * @brief Bytes held by the arena (TEXT/BLOB data plus block slack)
+     */
+    size_t arenaBytes() const { return arenaBytes_; }
+
+    /**
+     * @brief Number of arena blocks, i.e. allocations for all cell data
+     */
+    size_t arenaBlocks() const { return blocks_.size(); }
+
+private:
+    // 16 bytes, trivially copyable; bytes point into blocks_
+    struct Cell {
+        union {
+            int64_t integer;
+            double real;
+            const char* bytes;
+        };
+        uint32_t size;
+        int32_t type;  // SQLITE_INTEGER etc.
+    };
+
+    const Cell& cell(size_t row, int column) const {
+        return cells_[row * static_cast<size_t>(columns_) + static_cast<size_t>(column)];
+    }
+
+    void captureColumns(Statement& stmt);
+    const char* copyToArena(const void* data, size_t size);
+
+    int columns_ = 0;
+    std::vector<std::string> names_;
+    std::vector<Cell> cells_;
+
+    std::vector<std::unique_ptr<char[]>> blocks_;
+    char* blockCursor_ = nullptr;
+    size_t blockRemaining_ = 0;
+    size_t arenaBytes_ = 0;
+};
+
+} // namespace sqlite3db
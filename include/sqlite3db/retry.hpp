@@ -0,0 +1,112 @@
+/**
+ * @file retry.hpp
+ * @brief Retry with jittered exponential backoff for lock contention
+ *
+ * INDUSTRY PRACTICE #25: Retry Transient Failures, Not Bugs
+ * ==========================================================
+ * SQLITE_BUSY is not an error in the usual sense: it means another
+ * connection holds a lock right now. busy_timeout makes SQLite wait and
+ * retry internally, but it cannot resolve one case: a DEFERRED
+ * transaction that read first and then tries to write while another
+ * writer committed in between. Waiting never helps there. The only fix
+ * is to roll back and run the whole transaction again.
+ *
+ *   RetryPolicy policy;
+ *   policy.maxAttempts = 8;
+ *   withTransaction(conn, policy, [&](Transaction&) {
+ *       // Must be safe to run more than once (no side effects outside the DB)
+ *       conn.execute("UPDATE counters SET n = n + 1 WHERE id = 1");
+ *   });
+ *
+ * Backoff grows exponentially so a burst of writers spreads out instead
+ * of colliding again. Each delay is randomized ("full jitter") so the
+ * writers don't all wake at the same moment.
+ * Only BusyException-class failures are retried; real errors propagate
+ * on the first attempt.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include "exceptions.hpp"
+
+namespace sqlite3db {
+
+/**
+ * @brief How often and how patiently to retry contended work
+ */
+struct RetryPolicy {
+    // Total attempts including the first (1 = no retry)
+    int maxAttempts = 5;
+
+    // Delay before the first retry; doubles (by multiplier) each time
+    std::chrono::milliseconds initialBackoff{2};
+
+    // Upper bound for a single delay
+    std::chrono::milliseconds maxBackoff{250};
+
+    double multiplier = 2.0;
+
+    // Give up once this much time has passed since the first attempt
+    // (0 = limited by maxAttempts only)
+    std::chrono::milliseconds deadline{0};
+
+    // Randomize each delay in [0, backoff] to de-synchronize writers
+    bool jitter = true;
+
+    /**
+     * @brief Policy that never retries
+     */
+    static RetryPolicy none() {
+        RetryPolicy policy;
+        policy.maxAttempts = 1;
+        return policy;
+    }
+
+    /**
+     * @brief Delay before retry number `retry` (1-based)
+     */
+    std::chrono::microseconds backoff(int retry) const;
+};
+
+/**
+ * @brief True if a failure is worth retrying (lock contention)
+ *
+ * Also matches busy errors that arrive wrapped, e.g. a
+ * TransactionException from a BEGIN or COMMIT that hit SQLITE_BUSY.
+ */
+inline bool isRetryable(const DatabaseException& e) noexcept {
+    return isBusyError(e.errorCode());
+}
+
+/**
+ * @brief Run func, retrying it on busy errors according to policy
+ *
+ * func must be safe to rerun: any partial work of a failed attempt has
+ * to be undone by the time it throws (e.g. by a Transaction guard).
+ * The last busy exception is rethrown when the policy is exhausted.
+ */
+template<typename Func>
+auto withRetry(const RetryPolicy& policy, Func&& func) -> decltype(func()) {
+    const auto start = std::chrono::steady_clock::now();
+    for (int attempt = 1;; ++attempt) {
+        try {
+            return func();
+        } catch (const DatabaseException& e) {
+            if (!isRetryable(e) || attempt >= policy.maxAttempts) {
+                throw;
+            }
+            auto delay = policy.backoff(attempt);
+            if (policy.deadline.count() > 0 &&
+                std::chrono::steady_clock::now() + delay - start > policy.deadline) {
+                throw;
+            }
+            std::this_thread::sleep_for(delay);
+        }
+    }
+}
+
+} // namespace sqlite3db
@@ -0,0 +1,130 @@
+/**
+ * @file schema_catalog.hpp
+ * @brief In-memory snapshot of tables, columns and indexes
+ *
+ * INDUSTRY PRACTICE #34: Read the Schema Once
+ * ============================================
+ * Checking a schema one question at a time is a prepare, a step and a
+ * finalize per question: a sqlite_master lookup per table, PRAGMA
+ * table_info per column, another lookup per index. A few hundred startup
+ * checks become a few hundred queries.
+ *
+ * The table-valued pragma functions let one query return the whole
+ * schema, joined over sqlite_master:
+ *
+ *   SELECT m.name, p.name, p.type FROM sqlite_master AS m
+ *   JOIN pragma_table_info(m.name) AS p
+ *
+ * SchemaCatalog runs that once (with pragma_index_list for indexes) and
+ * answers every later question from memory:
+ *
+ *   auto schema = conn.schemaCatalog();
+ *   if (const auto* users = schema->table("users")) {
+ *       bool hasEmail = users->column("email") != nullptr;
+ *   }
+ *
+ * Views are read one by one afterwards, so a stale view (over a dropped
+ * table) can't fail the load; it is listed without columns.
+ *
+ * Connection::schemaCatalog() keeps the snapshot and reloads it only
+ * when PRAGMA schema_version changes, which SQLite bumps on every schema
+ * change made by any connection.
+ *
+ * Names are matched case-insensitively (ASCII), as SQLite does.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "connection.hpp"
+
+namespace sqlite3db {
+
+/**
+ * @brief name as a double-quoted SQL identifier, embedded quotes doubled
+ *
+ * For names that come from data (CSV headers, JSON keys) or the schema,
+ * which may contain spaces or be keywords such as "order".
+ */
+std::string quoteIdentifier(const std::string& name);
+
+/**
+ * @brief One column, as reported by PRAGMA table_info
+ */
+struct ColumnInfo {
+    std::string name;
+    std::string type;      // Declared type, as written
+    bool notNull = false;
+    int primaryKey = 0;    // 1-based position in the primary key, 0 if not part of it
+};
+
+/**
+ * @brief One index, as reported by PRAGMA index_list
+ */
+struct IndexInfo {
+    std::string name;
+    bool unique = false;
+    std::string origin;    // "c" (CREATE INDEX), "u" (UNIQUE) or "pk"
+    bool partial = false;
+};
+
+/**
+ * @brief A table or view with its columns and indexes
+ */
+struct TableInfo {
+    std::string name;
+    bool isView = false;
+    std::vector<ColumnInfo> columns;   // In declaration order
+    std::vector<IndexInfo> indexes;
+
+    /**
+     * @return The named column, or nullptr
+     */
+    const ColumnInfo* column(const std::string& name) const;
+
+    /**
+     * @return The named index, or nullptr
+     */
+    const IndexInfo* index(const std::string& name) const;
+};
+
+/**
+ * @brief Snapshot of the main schema's tables and views
+ *
+ * Immutable once loaded; share it through the std::shared_ptr that
+ * Connection::schemaCatalog() returns.
+ */
+class SchemaCatalog {
+public:
+    /**
+     * @brief Read the schema in a single query
+     * @throws QueryException if the schema can't be read
+     */
+    static SchemaCatalog load(Connection& conn);
+
+    /**
+     * @return The named table or view, or nullptr
+     */
+    const TableInfo* table(const std::string& name) const;
+
+    /**
+     * @return All tables and views, in no particular order
+     */
+    std::vector<const TableInfo*> tables() const;
+
+    size_t tableCount() const { return tables_.size(); }
+
+    /**
+     * @brief PRAGMA schema_version read before the schema was loaded
+     */
+    int64_t schemaVersion() const { return schemaVersion_; }
+
+private:
+    std::unordered_map<std::string, TableInfo> tables_;  // Keyed by lowercase name
+    int64_t schemaVersion_ = 0;
+};
+
+} // namespace sqlite3db
@@ -79,9 +79,29 @@
 #include "exceptions.hpp"
 #include "connection.hpp"
 #include "statement.hpp"
+#include "statement_cache.hpp"
+#include "sql_function.hpp"
+#include "resource_limits.hpp"
+#include "profiler.hpp"
+#include "result_cache.hpp"
+#include "retry.hpp"
 #include "transaction.hpp"
+#include "cursor.hpp"
+#include "blob_stream.hpp"
+#include "columnar.hpp"
+#include "result_set.hpp"
+#include "schema_catalog.hpp"
 #include "migration.hpp"
+#include "index_advisor.hpp"
 #include "repository.hpp"
+#include "typed_repository.hpp"
+#include "connection_pool.hpp"
+#include "parallel_query.hpp"
+#include "write_queue.hpp"
+#include "async_executor.hpp"
+#include "checkpoint.hpp"
+#include "backup.hpp"
+#include "bulk_io.hpp"
 
 /**
  * @namespace sqlite3db
@@ -28,6 +28,7 @@
 #pragma once
 
 #include <string>
+#include <string_view>
 #include <vector>
 #include <optional>
 #include <variant>
@@ -37,8 +38,9 @@
 
 namespace sqlite3db {
 
-// Forward declaration
+// Forward declarations
 class Connection;
+class StatementCache;
 
 /**
  * @brief Represents a NULL value for binding
@@ -61,6 +63,47 @@ static constexpr NullValue null{};
  */
 using Value = std::variant<NullValue, int64_t, double, std::string, std::vector<uint8_t>>;
 
+/**
+ * @brief Borrowed, read-only view of a BLOB (C++17 stand-in for std::span)
+ */
+struct BlobView {
+    const uint8_t* data = nullptr;
+    size_t size = 0;
+
+    const uint8_t* begin() const { return data; }
+    const uint8_t* end() const { return data + size; }
+    bool empty() const { return size == 0; }
+    uint8_t operator[](size_t i) const { return data[i]; }
+
+    std::vector<uint8_t> toVector() const { return std::vector<uint8_t>(begin(), end()); }
+};
+
+/**
+ * @brief Borrowed counterpart of Value
+ *
+ * TEXT and BLOB alternatives point into SQLite's own row buffer instead
+ * of owning a copy. Like the column*View accessors that produce them,
+ * they are only valid until the next step(), reset(), or destruction
+ * of the statement.
+ */
+using ValueView = std::variant<NullValue, int64_t, double, std::string_view, BlobView>;
+
+/**
+ * @brief Copy a borrowed view into an owning Value
+ */
+inline Value toValue(const ValueView& view) {
+    return std::visit([](const auto& v) -> Value {
+        using T = std::decay_t<decltype(v)>;
+        if constexpr (std::is_same_v<T, std::string_view>) {
+            return std::string(v);
+        } else if constexpr (std::is_same_v<T, BlobView>) {
+            return v.toVector();
+        } else {
+            return v;
+        }
+    }, view);
+}
+
 /**
  * @brief RAII wrapper for prepared statement
  *
@@ -77,6 +120,9 @@ public:
      * @param conn Parent connection (must outlive this statement!)
      * @param sql SQL text with ? placeholders
      * @throws QueryException if SQL is invalid
+     *
+     * The handle is taken from the connection's statement cache when
+     * possible, and returned to it (reset, bindings cleared) on destruction.
      */
     Statement(Connection& conn, const std::string& sql);
 
@@ -120,6 +166,13 @@ public:
      */
     Statement& bind(int index, const std::vector<uint8_t>& value);
 
+    /**
+     * @brief Bind a BLOB of bytes zeros without allocating it
+     *
+     * Reserves space for BlobStream to fill in chunks afterwards.
+     */
+    Statement& bindZeroBlob(int index, uint64_t bytes);
+
     /**
      * @brief Bind a NULL value
      */
@@ -130,6 +183,35 @@ public:
      */
     Statement& bind(int index, const Value& value);
 
+    /**
+     * @brief Bind caller-owned text/blob without copying (SQLITE_STATIC)
+     *
+     * INDUSTRY PRACTICE: Zero-Copy Binding
+     * The regular bind() overloads let SQLite copy the buffer, which is
+     * safe but doubles memory traffic for large payloads. These overloads
+     * make SQLite read the caller's buffer directly.
+     *
+     * IMPORTANT: The buffer must stay alive and unchanged until the
+     * statement has finished executing (execute(), or step() returning
+     * false) and been reset or re-bound. Temporaries are rejected at
+     * compile time for that reason; a null const char* binds NULL.
+     */
+    Statement& bindStatic(int index, std::string_view value);
+    Statement& bindStatic(int index, const std::string& value) { return bindStatic(index, std::string_view(value)); }
+    Statement& bindStatic(int index, std::string&& value) = delete;
+    Statement& bindStatic(int index, const char* value);
+    Statement& bindStatic(int index, BlobView value);
+
+    /**
+     * @brief Bind a variant, borrowing its TEXT/BLOB storage (SQLITE_STATIC)
+     *
+     * Numbers and NULL bind as usual; the same lifetime rule applies, so
+     * temporaries (including a std::vector<uint8_t> converted on the fly)
+     * are rejected.
+     */
+    Statement& bindStatic(int index, const Value& value);
+    Statement& bindStatic(int index, Value&& value) = delete;
+
     /**
      * @brief Bind a parameter by name
      *
@@ -231,6 +313,22 @@ public:
      */
     Value columnValue(int index) const;
 
+    /**
+     * @brief Zero-copy column access
+     *
+     * INDUSTRY PRACTICE: Borrow, Don't Copy
+     * For scans that only compare, hash, or parse a field, copying every
+     * TEXT/BLOB into a std::string costs one allocation per cell. These
+     * accessors return views into SQLite's row buffer instead.
+     *
+     * IMPORTANT: Views are valid only until the next step(), reset(),
+     * or column access of a different type on the same column.
+     * Copy the data (std::string(view), toValue(view)) to keep it.
+     */
+    std::string_view columnStringView(int index) const;
+    BlobView columnBlobView(int index) const;
+    ValueView columnValueView(int index) const;
+
     /**
      * @brief Get column value with optional (NULL-safe)
      *
@@ -247,13 +345,42 @@ public:
      */
     const std::string& sql() const { return sql_; }
 
+    /**
+     * @brief Get the raw SQLite statement handle (for advanced use)
+     */
+    sqlite3_stmt* handle() const { return stmt_; }
+
 private:
     void checkResult(int result, const std::string& operation);
     void finalize();
 
     sqlite3_stmt* stmt_ = nullptr;
     Connection* conn_;
+    StatementCache* cache_ = nullptr;  // Where to return the handle, if anywhere
     std::string sql_;
 };
 
+/**
+ * @brief Resets a reused statement and clears its bindings at scope exit
+ *
+ * For statements that are kept and re-executed (e.g. by repositories):
+ * releases the read lock and bound buffers even if row processing
+ * throws. Errors from the last step have already been reported, so the
+ * reset result is deliberately ignored.
+ */
+class ScopedReset {
+public:
+    explicit ScopedReset(Statement& stmt) : stmt_(stmt) {}
+    ~ScopedReset() {
+        sqlite3_reset(stmt_.handle());
+        sqlite3_clear_bindings(stmt_.handle());
+    }
+
+    ScopedReset(const ScopedReset&) = delete;
+    ScopedReset& operator=(const ScopedReset&) = delete;
+
+private:
+    Statement& stmt_;
+};
+
 } // namespace sqlite3db
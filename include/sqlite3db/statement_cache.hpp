@@ -0,0 +1,115 @@
+/**
+ * @file statement_cache.hpp
+ * @brief Per-connection LRU cache of prepared statement handles
+ *
+ * INDUSTRY PRACTICE #19: Statement Caching
+ * =========================================
+ * Compiling SQL (sqlite3_prepare_v2) is often more expensive than
+ * running it. Hot code paths tend to issue the same few SQL strings
+ * over and over, so re-parsing them on every call is wasted work.
+ *
+ * The cache keeps idle, already-compiled handles keyed by SQL text:
+ * - Connection::prepare() checks the cache first (hit = no parse)
+ * - When a Statement is destroyed, its handle is reset, its bindings
+ *   are cleared, and it goes back to the cache instead of being finalized
+ * - The least recently used handle is finalized when the cache is full
+ *
+ * Callers don't need to change anything: the Statement RAII wrapper
+ * handles checkout and return automatically.
+ */
+
+#pragma once
+
+#include <string>
+#include <list>
+#include <unordered_map>
+#include <cstddef>
+#include <cstdint>
+#include <sqlite3.h>
+
+namespace sqlite3db {
+
+/**
+ * @brief Counters for sizing the statement cache
+ *
+ * A low hit rate with many evictions means the capacity is too small
+ * for the working set of SQL strings.
+ */
+struct StatementCacheStats {
+    uint64_t hits = 0;       // prepare() served from the cache
+    uint64_t misses = 0;     // prepare() had to compile the SQL
+    uint64_t evictions = 0;  // Idle handles finalized to make room
+
+    double hitRate() const {
+        uint64_t total = hits + misses;
+        return total == 0 ? 0.0 : static_cast<double>(hits) / static_cast<double>(total);
+    }
+};
+
+/**
+ * @brief LRU cache of idle prepared statement handles
+ *
+ * Owned by a Connection; not thread-safe (neither is the connection).
+ * Only idle handles live in the cache: a handle that is checked out by a
+ * Statement is owned by that Statement until it is released.
+ */
+class StatementCache {
+public:
+    /**
+     * @param capacity Maximum number of idle handles to keep (0 disables caching)
+     */
+    explicit StatementCache(size_t capacity);
+
+    // Finalizes all idle handles
+    ~StatementCache();
+
+    StatementCache(const StatementCache&) = delete;
+    StatementCache& operator=(const StatementCache&) = delete;
+
+    /**
+     * @brief Take an idle handle for the given SQL out of the cache
+     * @return The handle, or nullptr on a miss (caller must prepare)
+     */
+    sqlite3_stmt* acquire(const std::string& sql);
+
+    /**
+     * @brief Return a handle to the cache
+     *
+     * The handle is reset and its bindings cleared. If the cache is
+     * disabled, or an idle handle for the same SQL is already cached,
+     * the handle is finalized instead.
+     */
+    void release(const std::string& sql, sqlite3_stmt* stmt);
+
+    /**
+     * @brief Finalize all idle handles
+     */
+    void clear();
+
+    /**
+     * @brief Change the capacity, evicting handles if necessary
+     */
+    void setCapacity(size_t capacity);
+
+    size_t capacity() const { return capacity_; }
+    size_t size() const { return entries_.size(); }
+    bool enabled() const { return capacity_ > 0; }
+
+    const StatementCacheStats& stats() const { return stats_; }
+    void resetStats() { stats_ = StatementCacheStats{}; }
+
+private:
+    struct Entry {
+        std::string sql;
+        sqlite3_stmt* stmt;
+    };
+
+    void evictOverflow();
+
+    size_t capacity_;
+    std::list<Entry> entries_;  // Front = most recently used
+    std::unordered_map<std::string, std::list<Entry>::iterator> index_;
+    StatementCacheStats stats_;
+};
+
+} // namespace sqlite3db
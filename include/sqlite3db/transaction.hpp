@@ -38,8 +38,10 @@
 #pragma once
 
 #include <string>
+#include <type_traits>
 #include <sqlite3.h>
 #include "exceptions.hpp"
+#include "retry.hpp"
 
 namespace sqlite3db {
 
@@ -208,4 +210,33 @@ auto withTransactionVoid(Connection& conn, Func&& func) -> void {
     txn.commit();
 }
 
+/**
+ * @brief Run func in a transaction, restarting it on lock contention
+ *
+ * Each attempt begins a fresh transaction and calls func. If BEGIN, the
+ * body, or COMMIT fails with SQLITE_BUSY/SQLITE_LOCKED, the attempt is
+ * rolled back and the whole body runs again after a backoff (see
+ * RetryPolicy). func may return void or a value.
+ *
+ * Prefer TransactionType::Immediate for read-modify-write bodies: the
+ * write lock is then taken (or refused) at BEGIN. A deferred transaction
+ * that upgrades later can fail only after doing its reads.
+ */
+template<typename Func>
+auto withTransaction(Connection& conn, const RetryPolicy& policy, Func&& func,
+                     TransactionType type = TransactionType::Deferred)
+    -> decltype(func(std::declval<Transaction&>())) {
+    return withRetry(policy, [&]() -> decltype(func(std::declval<Transaction&>())) {
+        Transaction txn(conn, type);
+        if constexpr (std::is_void_v<decltype(func(txn))>) {
+            func(txn);
+            txn.commit();
+        } else {
+            auto result = func(txn);
+            txn.commit();
+            return result;
+        }
+    });
+}
+
 } // namespace sqlite3db
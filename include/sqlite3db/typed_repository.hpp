@@ -0,0 +1,372 @@
+/**
+ * @file typed_repository.hpp
+ * @brief Compile-time column mapping for entities (no virtuals, no variants)
+ *
+ * INDUSTRY PRACTICE #22: Static Schemas for Hot Paths
+ * ====================================================
+ * Repository<T> maps rows through virtual fromRow()/bindForInsert()
+ * hooks, and the generic builders move data through Value, a
+ * std::variant holding strings and vectors. That is flexible, but every
+ * cell pays for a virtual call or a variant visit.
+ *
+ * When the columns of an entity are known at compile time, declare them
+ * once and let templates generate the mapping:
+ *
+ *   struct User { int64_t id; std::string name; std::optional<int> age; };
+ *
+ *   template<> struct EntitySchema<User> {
+ *       static constexpr const char* table = "users";
+ *       static constexpr auto primaryKey = column("id", &User::id);
+ *       static constexpr auto columns = std::make_tuple(
+ *           column("name", &User::name),
+ *           column("age", &User::age));
+ *   };
+ *
+ *   TypedRepository<User> users(conn);
+ *   int64_t id = users.insert(User{0, "Alice", 30});
+ *   auto alice = users.findById(id);
+ *
+ * Column indices are compile-time constants, and each field is bound
+ * and read by a ColumnCodec chosen by its C++ type, which inlines to
+ * the matching sqlite3_bind_* / sqlite3_column_* call.
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <optional>
+#include <tuple>
+#include <utility>
+#include <cstdint>
+#include <type_traits>
+#include "connection.hpp"
+#include "statement.hpp"
+
+namespace sqlite3db {
+
+/**
+ * @brief A named column bound to an entity data member
+ */
+template<typename Entity, typename Field>
+struct Column {
+    using entity_type = Entity;
+    using field_type = Field;
+
+    const char* name;
+    Field Entity::* member;
+};
+
+template<typename Entity, typename Field>
+constexpr Column<Entity, Field> column(const char* name, Field Entity::* member) {
+    return Column<Entity, Field>{name, member};
+}
+
+/**
+ * @brief Specialize for each entity (see file comment)
+ *
+ * Required members:
+ * - static constexpr const char* table
+ * - static constexpr auto primaryKey   (column(...) of an integer field)
+ * - static constexpr auto columns      (std::tuple of column(...), excluding the key)
+ */
+template<typename T>
+struct EntitySchema;
+
+namespace detail {
+
+inline void checkBind(int result, sqlite3_stmt* stmt) {
+    if (result != SQLITE_OK) {
+        sqlite3* db = sqlite3_db_handle(stmt);
+        const char* sql = sqlite3_sql(stmt);
+        throw QueryException(std::string("bind failed: ") + sqlite3_errmsg(db),
+                             sql ? sql : "", result);
+    }
+}
+
+} // namespace detail
+
+/**
+ * @brief Binds and reads one C++ type; specialize for custom field types
+ *
+ * Parameter indices are 1-based, column indices 0-based (SQLite convention).
+ */
+template<typename T, typename Enable = void>
+struct ColumnCodec;
+
+template<typename T>
+struct ColumnCodec<T, std::enable_if_t<std::is_integral_v<T>>> {
+    static void bind(sqlite3_stmt* stmt, int index, T value) {
+        detail::checkBind(sqlite3_bind_int64(stmt, index, static_cast<sqlite3_int64>(value)), stmt);
+    }
+    static T read(sqlite3_stmt* stmt, int index) {
+        return static_cast<T>(sqlite3_column_int64(stmt, index));
+    }
+};
+
+template<typename T>
+struct ColumnCodec<T, std::enable_if_t<std::is_floating_point_v<T>>> {
+    static void bind(sqlite3_stmt* stmt, int index, T value) {
+        detail::checkBind(sqlite3_bind_double(stmt, index, static_cast<double>(value)), stmt);
+    }
+    static T read(sqlite3_stmt* stmt, int index) {
+        return static_cast<T>(sqlite3_column_double(stmt, index));
+    }
+};
+
+template<>
+struct ColumnCodec<std::string> {
+    // The entity outlives the step, so its buffer can be bound in place
+    static void bind(sqlite3_stmt* stmt, int index, const std::string& value) {
+        detail::checkBind(sqlite3_bind_text64(stmt, index, value.c_str(), value.size(),
+                                              SQLITE_STATIC, SQLITE_UTF8), stmt);
+    }
+    static std::string read(sqlite3_stmt* stmt, int index) {
+        const unsigned char* text = sqlite3_column_text(stmt, index);
+        int size = sqlite3_column_bytes(stmt, index);
+        return text ? std::string(reinterpret_cast<const char*>(text), static_cast<size_t>(size))
+                    : std::string();
+    }
+};
+
+template<>
+struct ColumnCodec<std::vector<uint8_t>> {
+    static void bind(sqlite3_stmt* stmt, int index, const std::vector<uint8_t>& value) {
+        if (value.empty()) {
+            detail::checkBind(sqlite3_bind_zeroblob(stmt, index, 0), stmt);
+            return;
+        }
+        detail::checkBind(sqlite3_bind_blob64(stmt, index, value.data(), value.size(),
+                                              SQLITE_STATIC), stmt);
+    }
+    static std::vector<uint8_t> read(sqlite3_stmt* stmt, int index) {
+        const auto* data = static_cast<const uint8_t*>(sqlite3_column_blob(stmt, index));
+        int size = sqlite3_column_bytes(stmt, index);
+        return data ? std::vector<uint8_t>(data, data + size) : std::vector<uint8_t>();
+    }
+};
+
+template<typename T>
+struct ColumnCodec<std::optional<T>> {
+    static void bind(sqlite3_stmt* stmt, int index, const std::optional<T>& value) {
+        if (value) {
+            ColumnCodec<T>::bind(stmt, index, *value);
+        } else {
+            detail::checkBind(sqlite3_bind_null(stmt, index), stmt);
+        }
+    }
+    static std::optional<T> read(sqlite3_stmt* stmt, int index) {
+        if (sqlite3_column_type(stmt, index) == SQLITE_NULL) {
+            return std::nullopt;
+        }
+        return ColumnCodec<T>::read(stmt, index);
+    }
+};
+
+/**
+ * @brief Repository generated from an EntitySchema at compile time
+ *
+ * Selects "key, columns..." in declaration order, so the key is column 0
+ * and the I-th declared column is column I + 1. Statements are prepared
+ * lazily and reused for the life of the repository.
+ */
+template<typename T, typename Schema = EntitySchema<T>>
+class TypedRepository {
+    using KeyColumn = std::decay_t<decltype(Schema::primaryKey)>;
+    using Key = typename KeyColumn::field_type;
+    using Columns = std::decay_t<decltype(Schema::columns)>;
+    static constexpr size_t kColumnCount = std::tuple_size_v<Columns>;
+
+public:
+    explicit TypedRepository(Connection& conn)
+        : conn_(conn)
+    {
+        std::string table = Schema::table;
+        std::string key = Schema::primaryKey.name;
+        std::string columns = columnList(", ");
+
+        selectAllSql_ = "SELECT " + key + (kColumnCount > 0 ? ", " + columns : "") + " FROM " + table;
+        findByIdSql_ = selectAllSql_ + " WHERE " + key + " = ?";
+        insertSql_ = "INSERT INTO " + table + " (" + columns + ") VALUES (" + placeholders() + ")";
+        updateSql_ = "UPDATE " + table + " SET " + columnList(" = ?, ") + " = ? WHERE " + key + " = ?";
+        deleteSql_ = "DELETE FROM " + table + " WHERE " + key + " = ?";
+        countSql_ = "SELECT COUNT(*) FROM " + table;
+    }
+
+    static constexpr const char* tableName() { return Schema::table; }
+
+    std::optional<T> findById(Key id) {
+        Statement& stmt = cached(findByIdStmt_, findByIdSql_);
+        ScopedReset guard(stmt);
+        ColumnCodec<Key>::bind(stmt.handle(), 1, id);
+        if (stmt.step()) {
+            return read(stmt.handle());
+        }
+        return std::nullopt;
+    }
+
+    std::vector<T> findAll() {
+        std::vector<T> results;
+        forEach([&](T& entity) { results.push_back(std::move(entity)); });
+        return results;
+    }
+
+    /**
+     * @brief Visit every entity; fn may return bool, false stops early
+     *
+     * fn may call findAll() / forEach() again: the nested scan gets its
+     * own statement instead of resetting the one being stepped.
+     */
+    template<typename Func>
+    void forEach(Func&& fn) {
+        if (scanning_) {
+            Statement nested = conn_.prepare(selectAllSql_);
+            visit(nested, fn);
+            return;
+        }
+        Statement& stmt = cached(selectAllStmt_, selectAllSql_);
+        ScopedReset guard(stmt);
+        scanning_ = true;
+        try {
+            visit(stmt, fn);
+        } catch (...) {
+            scanning_ = false;
+            throw;
+        }
+        scanning_ = false;
+    }
+
+    /**
+     * @brief Insert all non-key columns
+     * @return The new row id
+     */
+    int64_t insert(const T& entity) {
+        Statement& stmt = cached(insertStmt_, insertSql_);
+        ScopedReset guard(stmt);
+        bindColumns(stmt.handle(), entity, std::make_index_sequence<kColumnCount>{});
+        stmt.execute();
+        return conn_.lastInsertRowId();
+    }
+
+    /**
+     * @brief Update all non-key columns of the row with the entity's key
+     * @return true if a row was updated
+     */
+    bool update(const T& entity) {
+        Statement& stmt = cached(updateStmt_, updateSql_);
+        ScopedReset guard(stmt);
+        bindColumns(stmt.handle(), entity, std::make_index_sequence<kColumnCount>{});
+        ColumnCodec<Key>::bind(stmt.handle(), static_cast<int>(kColumnCount + 1),
+                               entity.*(Schema::primaryKey.member));
+        stmt.execute();
+        return conn_.changes() > 0;
+    }
+
+    bool deleteById(Key id) {
+        Statement& stmt = cached(deleteStmt_, deleteSql_);
+        ScopedReset guard(stmt);
+        ColumnCodec<Key>::bind(stmt.handle(), 1, id);
+        stmt.execute();
+        return conn_.changes() > 0;
+    }
+
+    int64_t count() {
+        Statement& stmt = cached(countStmt_, countSql_);
+        ScopedReset guard(stmt);
+        stmt.step();
+        return stmt.columnInt64(0);
+    }
+
+    /**
+     * @brief Read the current row of a statement selecting "key, columns..."
+     */
+    static T read(sqlite3_stmt* stmt) {
+        T entity{};
+        entity.*(Schema::primaryKey.member) = ColumnCodec<Key>::read(stmt, 0);
+        readColumns(stmt, entity, std::make_index_sequence<kColumnCount>{});
+        return entity;
+    }
+
+private:
+    template<typename Func>
+    static void visit(Statement& stmt, Func& fn) {
+        while (stmt.step()) {
+            T entity = read(stmt.handle());
+            if constexpr (std::is_same_v<std::invoke_result_t<Func&, T&>, bool>) {
+                if (!fn(entity)) {
+                    return;
+                }
+            } else {
+                fn(entity);
+            }
+        }
+    }
+
+    template<size_t... I>
+    static void readColumns(sqlite3_stmt* stmt, T& entity, std::index_sequence<I...>) {
+        (readColumn<I>(stmt, entity), ...);
+    }
+
+    template<size_t I>
+    static void readColumn(sqlite3_stmt* stmt, T& entity) {
+        constexpr auto col = std::get<I>(Schema::columns);
+        using Field = typename std::decay_t<decltype(col)>::field_type;
+        entity.*(col.member) = ColumnCodec<Field>::read(stmt, static_cast<int>(I + 1));
+    }
+
+    template<size_t... I>
+    static void bindColumns(sqlite3_stmt* stmt, const T& entity, std::index_sequence<I...>) {
+        (bindColumn<I>(stmt, entity), ...);
+    }
+
+    template<size_t I>
+    static void bindColumn(sqlite3_stmt* stmt, const T& entity) {
+        constexpr auto col = std::get<I>(Schema::columns);
+        using Field = typename std::decay_t<decltype(col)>::field_type;
+        ColumnCodec<Field>::bind(stmt, static_cast<int>(I + 1), entity.*(col.member));
+    }
+
+    static std::string columnList(const char* separator) {
+        std::string result;
+        std::apply([&](const auto&... cols) {
+            ((result += (result.empty() ? "" : separator), result += cols.name), ...);
+        }, Schema::columns);
+        return result;
+    }
+
+    static std::string placeholders() {
+        std::string result;
+        for (size_t i = 0; i < kColumnCount; ++i) {
+            result += (i == 0 ? "?" : ", ?");
+        }
+        return result;
+    }
+
+    Statement& cached(std::optional<Statement>& slot, const std::string& sql) {
+        if (!slot) {
+            slot.emplace(conn_.prepare(sql));
+        }
+        return *slot;
+    }
+
+    Connection& conn_;
+
+    std::string selectAllSql_;
+    std::string findByIdSql_;
+    std::string insertSql_;
+    std::string updateSql_;
+    std::string deleteSql_;
+    std::string countSql_;
+
+    std::optional<Statement> selectAllStmt_;
+    std::optional<Statement> findByIdStmt_;
+    std::optional<Statement> insertStmt_;
+    std::optional<Statement> updateStmt_;
+    std::optional<Statement> deleteStmt_;
+    std::optional<Statement> countStmt_;
+
+    // selectAllStmt_ is being stepped by forEach()
+    bool scanning_ = false;
+};
+
+} // namespace sqlite3db
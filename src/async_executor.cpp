@@ -0,0 +1,117 @@
+/**
+ * @file async_executor.cpp
+ * @brief Implementation of AsyncExecutor
+ */
+
+#include "sqlite3db/async_executor.hpp"
+#include <algorithm>
+
+namespace sqlite3db {
+
+AsyncExecutor::AsyncExecutor(const std::string& dbPath, const ConnectionOptions& options)
+    : conn_(Connection::open(dbPath, options))
+{
+    start();
+}
+
+AsyncExecutor::AsyncExecutor(std::unique_ptr<Connection> conn)
+    : conn_(std::move(conn))
+{
+    if (!conn_ || !conn_->isOpen()) {
+        throw ConnectionException("AsyncExecutor needs an open connection");
+    }
+    start();
+}
+
+AsyncExecutor::~AsyncExecutor() {
+    stop();
+}
+
+void AsyncExecutor::start() {
+    // sqlite3_interrupt() only reaches statements that are running at the
+    // time. The watchdog's cancel check also stops statements the cancelled
+    // task starts afterwards.
+    conn_->enableQueryWatchdog().setCancelCheck([this] {
+        return cancelRunning_.load(std::memory_order_relaxed);
+    });
+    worker_ = std::thread([this] { workerLoop(); });
+}
+
+void AsyncExecutor::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    workAvailable_.notify_all();
+    if (worker_.joinable()) {
+        worker_.join();
+    }
+}
+
+size_t AsyncExecutor::pending() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return queue_.size();
+}
+
+uint64_t AsyncExecutor::enqueue(std::unique_ptr<Job> job) {
+    uint64_t id = 0;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (stopping_) {
+            throw DatabaseException("AsyncExecutor is stopped");
+        }
+        id = nextId_++;
+        job->id = id;
+        queue_.push_back(std::move(job));
+    }
+    workAvailable_.notify_one();
+    return id;
+}
+
+bool AsyncExecutor::cancel(uint64_t taskId) {
+    std::unique_ptr<Job> removed;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (runningId_ == taskId) {
+            // Holding the lock keeps the worker from starting the next task,
+            // so neither signal can reach another task
+            cancelRunning_.store(true, std::memory_order_relaxed);
+            sqlite3_interrupt(conn_->handle());
+            return true;
+        }
+        auto it = std::find_if(queue_.begin(), queue_.end(),
+                               [&](const std::unique_ptr<Job>& job) { return job->id == taskId; });
+        if (it == queue_.end()) {
+            return false;
+        }
+        removed = std::move(*it);
+        queue_.erase(it);
+    }
+    removed->fail(std::make_exception_ptr(
+        InterruptedException("Task cancelled before it started", "")));
+    return true;
+}
+
+void AsyncExecutor::workerLoop() {
+    for (;;) {
+        std::unique_ptr<Job> job;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            workAvailable_.wait(lock, [&] { return stopping_ || !queue_.empty(); });
+            if (queue_.empty()) {
+                return;  // Stopping and fully drained
+            }
+            job = std::move(queue_.front());
+            queue_.pop_front();
+            runningId_ = job->id;
+            cancelRunning_.store(false, std::memory_order_relaxed);
+        }
+
+        job->run(*conn_);
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        runningId_ = 0;
+    }
+}
+
+} // namespace sqlite3db
@@ -0,0 +1,110 @@
+/**
+ * @file backup.cpp
+ * @brief Implementation of Backup
+ */
+
+#include "sqlite3db/backup.hpp"
+#include <algorithm>
+#include <thread>
+#include "sqlite3db/connection.hpp"
+
+namespace sqlite3db {
+
+Backup::Backup(Connection& destination, Connection& source,
+               const std::string& destinationSchema, const std::string& sourceSchema)
+    : destination_(destination)
+{
+    if (&destination == &source) {
+        throw DatabaseException("Cannot back up a connection into itself");
+    }
+    backup_ = sqlite3_backup_init(destination.handle(), destinationSchema.c_str(),
+                                  source.handle(), sourceSchema.c_str());
+    if (!backup_) {
+        throw DatabaseException("Failed to start backup: " +
+                                std::string(sqlite3_errmsg(destination.handle())),
+                                sqlite3_extended_errcode(destination.handle()));
+    }
+}
+
+Backup::~Backup() {
+    if (backup_) {
+        sqlite3_backup_finish(backup_);
+    }
+}
+
+bool Backup::step(int pages) {
+    if (done_) {
+        return true;
+    }
+
+    int result = sqlite3_backup_step(backup_, pages);
+    remaining_ = sqlite3_backup_remaining(backup_);
+    pageCount_ = sqlite3_backup_pagecount(backup_);
+
+    if (result == SQLITE_OK) {
+        return false;
+    }
+    if (result == SQLITE_DONE) {
+        finish();
+        return true;
+    }
+    if (isBusyError(result)) {
+        throw BusyException("Backup step blocked: " + std::string(sqlite3_errstr(result)), "", result);
+    }
+    throw DatabaseException("Backup failed: " + std::string(sqlite3_errstr(result)), result);
+}
+
+void Backup::finish() {
+    int result = sqlite3_backup_finish(backup_);
+    backup_ = nullptr;
+    done_ = true;
+    if (result != SQLITE_OK) {
+        throw DatabaseException("Backup failed: " + std::string(sqlite3_errmsg(destination_.handle())),
+                                result);
+    }
+
+    // The update hook never saw the copied pages
+    if (ResultCache* cache = destination_.resultCache()) {
+        cache->invalidateAll();
+    }
+}
+
+void Backup::run(const BackupOptions& options) {
+    // A busy retry always waits a little, even without a step delay
+    auto busyDelay = std::max(options.stepDelay, std::chrono::milliseconds(1));
+    int busySteps = 0;
+
+    while (true) {
+        bool finished = false;
+        try {
+            finished = step(options.pagesPerStep);
+        } catch (const BusyException&) {
+            if (++busySteps > options.maxBusyRetries) {
+                throw;
+            }
+            std::this_thread::sleep_for(busyDelay);
+            continue;
+        }
+        busySteps = 0;
+
+        bool proceed = !options.onProgress || options.onProgress(progress());
+        if (finished) {
+            return;
+        }
+        if (!proceed) {
+            throw InterruptedException("Backup cancelled", "");
+        }
+        if (options.stepDelay.count() > 0) {
+            std::this_thread::sleep_for(options.stepDelay);
+        }
+    }
+}
+
+BackupProgress Backup::progress() const {
+    BackupProgress progress;
+    progress.remaining = remaining_;
+    progress.pageCount = pageCount_;
+    return progress;
+}
+
+} // namespace sqlite3db
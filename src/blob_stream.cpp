@@ -0,0 +1,180 @@
+/**
+ * @file blob_stream.cpp
+ * @brief Implementation of BlobStream
+ */
+
+#include "sqlite3db/blob_stream.hpp"
+#include <algorithm>
+#include <limits>
+#include <utility>
+#include "sqlite3db/connection.hpp"
+
+namespace sqlite3db {
+
+BlobStream::BlobStream(Connection& conn, const std::string& table, const std::string& column,
+                       int64_t rowid, BlobMode mode, const std::string& schema)
+    : db_(conn.handle())
+    , rowid_(rowid)
+{
+    int result = sqlite3_blob_open(db_, schema.c_str(), table.c_str(), column.c_str(), rowid,
+                                   mode == BlobMode::ReadWrite ? 1 : 0, &blob_);
+    if (result != SQLITE_OK) {
+        // sqlite3_blob_open may allocate a handle even when it fails
+        sqlite3_blob_close(blob_);
+        blob_ = nullptr;
+        throw DatabaseException("Failed to open BLOB " + table + "." + column + " at rowid " +
+                                std::to_string(rowid) + ": " + sqlite3_errmsg(db_), result);
+    }
+    size_ = static_cast<size_t>(sqlite3_blob_bytes(blob_));
+}
+
+BlobStream::~BlobStream() {
+    close();
+}
+
+BlobStream::BlobStream(BlobStream&& other) noexcept
+    : db_(other.db_)
+    , blob_(std::exchange(other.blob_, nullptr))
+    , rowid_(other.rowid_)
+    , size_(std::exchange(other.size_, 0))
+    , position_(std::exchange(other.position_, 0))
+    , buffer_(std::move(other.buffer_))
+{}
+
+BlobStream& BlobStream::operator=(BlobStream&& other) noexcept {
+    if (this != &other) {
+        close();
+        db_ = other.db_;
+        blob_ = std::exchange(other.blob_, nullptr);
+        rowid_ = other.rowid_;
+        size_ = std::exchange(other.size_, 0);
+        position_ = std::exchange(other.position_, 0);
+        buffer_ = std::move(other.buffer_);
+    }
+    return *this;
+}
+
+void BlobStream::close() noexcept {
+    if (blob_) {
+        sqlite3_blob_close(blob_);
+        blob_ = nullptr;
+    }
+}
+
+void BlobStream::check(int result, const char* operation) const {
+    if (result == SQLITE_ABORT) {
+        throw DatabaseException(std::string("BLOB ") + operation + " failed: row " +
+                                std::to_string(rowid_) + " changed since the handle was opened",
+                                result);
+    }
+    if (result != SQLITE_OK) {
+        throw DatabaseException(std::string("BLOB ") + operation + " failed: " + sqlite3_errmsg(db_),
+                                result);
+    }
+}
+
+void BlobStream::checkRange(size_t offset, size_t bytes, const char* operation) const {
+    if (!blob_) {
+        throw DatabaseException(std::string("BLOB ") + operation + " on a closed stream");
+    }
+    if (offset > size_ || bytes > size_ - offset) {
+        throw DatabaseException(std::string("BLOB ") + operation + " of " + std::to_string(bytes) +
+                                " bytes at offset " + std::to_string(offset) +
+                                " passes the end (" + std::to_string(size_) + " bytes)");
+    }
+}
+
+void BlobStream::reopen(int64_t rowid) {
+    if (!blob_) {
+        throw DatabaseException("BLOB reopen on a closed stream");
+    }
+    int result = sqlite3_blob_reopen(blob_, rowid);
+    if (result != SQLITE_OK) {
+        // The handle is now aborted; only closing it remains valid
+        size_ = 0;
+        position_ = 0;
+        throw DatabaseException("Failed to reopen BLOB at rowid " + std::to_string(rowid) + ": " +
+                                sqlite3_errmsg(db_), result);
+    }
+    rowid_ = rowid;
+    size_ = static_cast<size_t>(sqlite3_blob_bytes(blob_));
+    position_ = 0;
+}
+
+void BlobStream::seek(size_t offset) {
+    checkRange(offset, 0, "seek");
+    position_ = offset;
+}
+
+size_t BlobStream::read(void* destination, size_t bytes) {
+    size_t count = std::min(bytes, remaining());
+    if (count > 0) {
+        readAt(position_, destination, count);
+        position_ += count;
+    }
+    return count;
+}
+
+void BlobStream::readAt(size_t offset, void* destination, size_t bytes) {
+    checkRange(offset, bytes, "read");
+    // Sizes fit in int: SQLite caps a BLOB at SQLITE_MAX_LENGTH (<= 2^31 - 1)
+    check(sqlite3_blob_read(blob_, destination, static_cast<int>(bytes), static_cast<int>(offset)),
+          "read");
+}
+
+BlobView BlobStream::readChunk(size_t maxBytes) {
+    size_t count = std::min(std::max<size_t>(maxBytes, 1), remaining());
+    if (count == 0) {
+        return BlobView{};
+    }
+    if (buffer_.size() < count) {
+        buffer_.resize(count);
+    }
+    read(buffer_.data(), count);
+    return BlobView{buffer_.data(), count};
+}
+
+void BlobStream::write(const void* data, size_t bytes) {
+    writeAt(position_, data, bytes);
+    position_ += bytes;
+}
+
+void BlobStream::writeAt(size_t offset, const void* data, size_t bytes) {
+    checkRange(offset, bytes, "write");
+    if (bytes == 0) {
+        return;
+    }
+    check(sqlite3_blob_write(blob_, data, static_cast<int>(bytes), static_cast<int>(offset)),
+          "write");
+}
+
+size_t BlobStream::copyTo(std::ostream& out, size_t chunkSize) {
+    size_t copied = 0;
+    forEachChunk([&](BlobView chunk) {
+        out.write(reinterpret_cast<const char*>(chunk.data), static_cast<std::streamsize>(chunk.size));
+        copied += chunk.size;
+    }, chunkSize);
+    return copied;
+}
+
+size_t BlobStream::copyFrom(std::istream& in, size_t chunkSize) {
+    chunkSize = std::max<size_t>(chunkSize, 1);
+    if (buffer_.size() < std::min(chunkSize, remaining())) {
+        buffer_.resize(std::min(chunkSize, remaining()));
+    }
+
+    size_t copied = 0;
+    while (remaining() > 0 && in) {
+        size_t want = std::min(chunkSize, remaining());
+        in.read(reinterpret_cast<char*>(buffer_.data()), static_cast<std::streamsize>(want));
+        auto got = static_cast<size_t>(in.gcount());
+        if (got == 0) {
+            break;
+        }
+        write(buffer_.data(), got);
+        copied += got;
+    }
+    return copied;
+}
+
+} // namespace sqlite3db
@@ -0,0 +1,1130 @@
+/**
+ * @file bulk_io.cpp
+ * @brief Implementation of CSV / NDJSON import and export
+ */
+
+#include "sqlite3db/bulk_io.hpp"
+#include <algorithm>
+#include <charconv>
+#include <cerrno>
+#include <cmath>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <exception>
+#include <fstream>
+#include <iterator>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <unordered_map>
+#include "sqlite3db/cursor.hpp"
+#include "sqlite3db/schema_catalog.hpp"
+#include "sqlite3db/transaction.hpp"
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace sqlite3db {
+
+namespace {
+
+// Rows handed from the parser to the inserter at a time
+constexpr size_t kParseChunkRows = 2048;
+constexpr size_t kOutputBufferBytes = 64 * 1024;
+
+// ========== Parsed rows ==========
+
+enum class FieldKind : uint8_t {
+    Text,
+    Null,
+    Integer,
+    Real
+};
+
+struct Field {
+    const char* data = nullptr;  // Text in the input
+    size_t offset = 0;           // Text in ParsedBatch::scratch (inScratch)
+    size_t size = 0;
+    FieldKind kind = FieldKind::Null;
+    bool inScratch = false;
+    int64_t integer = 0;
+    double real = 0.0;
+};
+
+struct ParsedBatch {
+    std::vector<Field> fields;  // rows x columns
+    std::string scratch;        // Unescaped text
+    size_t rows = 0;
+
+    void clear() {
+        fields.clear();
+        scratch.clear();
+        rows = 0;
+    }
+
+    std::string_view text(const Field& field) const {
+        return field.inScratch ? std::string_view(scratch.data() + field.offset, field.size)
+                               : std::string_view(field.data, field.size);
+    }
+};
+
+[[noreturn]] void throwParseError(const char* format, size_t where, const std::string& what) {
+    throw DatabaseException(std::string(format) + " " + std::to_string(where) + ": " + what);
+}
+
+// ========== CSV ==========
+
+class CsvParser {
+public:
+    CsvParser(std::string_view input, char delimiter, bool emptyAsNull)
+        : in_(input), delimiter_(delimiter), emptyAsNull_(emptyAsNull) {}
+
+    /**
+     * @brief Append the next record's fields to batch
+     * @return Number of fields, 0 at the end of the input
+     */
+    size_t next(ParsedBatch& batch) {
+        while (pos_ < in_.size() && (in_[pos_] == '\n' || in_[pos_] == '\r')) {
+            ++pos_;
+        }
+        if (pos_ >= in_.size()) {
+            return 0;
+        }
+        ++record_;
+
+        size_t count = 0;
+        while (true) {
+            Field field;
+            if (pos_ < in_.size() && in_[pos_] == '"') {
+                parseQuoted(batch, field);
+            } else {
+                size_t start = pos_;
+                while (pos_ < in_.size()) {
+                    char c = in_[pos_];
+                    if (c == delimiter_ || c == '\n' || c == '\r') {
+                        break;
+                    }
+                    ++pos_;
+                }
+                field.data = in_.data() + start;
+                field.size = pos_ - start;
+                field.kind = emptyAsNull_ && field.size == 0 ? FieldKind::Null : FieldKind::Text;
+            }
+            batch.fields.push_back(field);
+            ++count;
+
+            if (pos_ >= in_.size()) {
+                break;
+            }
+            char c = in_[pos_];
+            if (c == delimiter_) {
+                ++pos_;
+                continue;
+            }
+            // End of record: LF or CRLF
+            if (c == '\r') {
+                ++pos_;
+            }
+            if (pos_ < in_.size() && in_[pos_] == '\n') {
+                ++pos_;
+            }
+            break;
+        }
+        return count;
+    }
+
+    size_t record() const { return record_; }
+
+private:
+    void parseQuoted(ParsedBatch& batch, Field& field) {
+        ++pos_;  // Opening quote
+        size_t start = pos_;
+        bool escaped = false;
+        size_t scratchStart = batch.scratch.size();
+
+        while (true) {
+            const void* found = pos_ < in_.size()
+                ? std::memchr(in_.data() + pos_, '"', in_.size() - pos_) : nullptr;
+            if (!found) {
+                throwParseError("CSV record", record_, "unterminated quoted field");
+            }
+            size_t quote = static_cast<size_t>(static_cast<const char*>(found) - in_.data());
+            if (quote + 1 < in_.size() && in_[quote + 1] == '"') {
+                // "" inside quotes: copy up to and including one quote
+                batch.scratch.append(in_.data() + start, quote + 1 - start);
+                escaped = true;
+                pos_ = start = quote + 2;
+                continue;
+            }
+            if (escaped) {
+                batch.scratch.append(in_.data() + start, quote - start);
+                field.inScratch = true;
+                field.offset = scratchStart;
+                field.size = batch.scratch.size() - scratchStart;
+            } else {
+                field.data = in_.data() + start;
+                field.size = quote - start;
+            }
+            field.kind = FieldKind::Text;
+            pos_ = quote + 1;
+            break;
+        }
+
+        if (pos_ < in_.size() && in_[pos_] != delimiter_ && in_[pos_] != '\n' && in_[pos_] != '\r') {
+            throwParseError("CSV record", record_, "unexpected character after closing quote");
+        }
+    }
+
+    std::string_view in_;
+    size_t pos_ = 0;
+    char delimiter_;
+    bool emptyAsNull_;
+    size_t record_ = 0;
+};
+
+// ========== NDJSON ==========
+
+void appendUtf8(std::string& out, uint32_t code) {
+    if (code < 0x80) {
+        out.push_back(static_cast<char>(code));
+    } else if (code < 0x800) {
+        out.push_back(static_cast<char>(0xC0 | (code >> 6)));
+        out.push_back(static_cast<char>(0x80 | (code & 0x3F)));
+    } else if (code < 0x10000) {
+        out.push_back(static_cast<char>(0xE0 | (code >> 12)));
+        out.push_back(static_cast<char>(0x80 | ((code >> 6) & 0x3F)));
+        out.push_back(static_cast<char>(0x80 | (code & 0x3F)));
+    } else {
+        out.push_back(static_cast<char>(0xF0 | (code >> 18)));
+        out.push_back(static_cast<char>(0x80 | ((code >> 12) & 0x3F)));
+        out.push_back(static_cast<char>(0x80 | ((code >> 6) & 0x3F)));
+        out.push_back(static_cast<char>(0x80 | (code & 0x3F)));
+    }
+}
+
+class NdjsonParser {
+public:
+    /**
+     * @param columns Target columns; must outlive the parser
+     */
+    NdjsonParser(std::string_view input, const std::vector<std::string>& columns)
+        : in_(input), columnCount_(columns.size())
+    {
+        for (size_t i = 0; i < columns.size(); ++i) {
+            index_[columns[i]] = i;
+        }
+    }
+
+    /**
+     * @brief Append the next object as one row of columnCount fields
+     * @param keys When set, receives every key of the object (in order)
+     * @return false at the end of the input
+     */
+    bool next(ParsedBatch& batch, std::vector<std::string>* keys = nullptr) {
+        skipBlankLines();
+        if (pos_ >= in_.size()) {
+            return false;
+        }
+
+        size_t base = batch.fields.size();
+        batch.fields.resize(base + columnCount_);
+
+        expect('{');
+        skipSpace();
+        if (peek() == '}') {
+            ++pos_;
+        } else {
+            while (true) {
+                skipSpace();
+                expect('"');
+                std::string_view key = parseKey();
+                skipSpace();
+                expect(':');
+                skipSpace();
+
+                Field value;
+                parseValue(batch, value);
+                auto it = index_.find(key);
+                if (it != index_.end()) {
+                    batch.fields[base + it->second] = value;
+                }
+                if (keys) {
+                    keys->emplace_back(key);
+                }
+
+                skipSpace();
+                char c = peek();
+                ++pos_;
+                if (c == '}') {
+                    break;
+                }
+                if (c != ',') {
+                    fail("expected ',' or '}'");
+                }
+            }
+        }
+
+        skipSpace();
+        if (pos_ < in_.size() && in_[pos_] != '\n') {
+            fail("expected one object per line");
+        }
+        return true;
+    }
+
+    size_t line() const { return line_; }
+
+private:
+    [[noreturn]] void fail(const std::string& what) const {
+        throwParseError("NDJSON line", line_, what);
+    }
+
+    char peek() const {
+        if (pos_ >= in_.size()) {
+            fail("unexpected end of input");
+        }
+        return in_[pos_];
+    }
+
+    void expect(char c) {
+        if (peek() != c) {
+            fail(std::string("expected '") + c + "'");
+        }
+        ++pos_;
+    }
+
+    // Spaces within a line
+    void skipSpace() {
+        while (pos_ < in_.size() && (in_[pos_] == ' ' || in_[pos_] == '\t' || in_[pos_] == '\r')) {
+            ++pos_;
+        }
+    }
+
+    void skipBlankLines() {
+        while (pos_ < in_.size()) {
+            char c = in_[pos_];
+            if (c == '\n') {
+                ++line_;
+            } else if (c != ' ' && c != '\t' && c != '\r') {
+                break;
+            }
+            ++pos_;
+        }
+    }
+
+    // After the opening quote; returns the end of the raw string (the
+    // closing quote) and whether it holds escapes
+    size_t scanString(bool& escaped) {
+        escaped = false;
+        for (size_t i = pos_; i < in_.size(); ++i) {
+            char c = in_[i];
+            if (c == '"') {
+                return i;
+            }
+            if (c == '\\') {
+                escaped = true;
+                ++i;
+            } else if (c == '\n') {
+                break;
+            }
+        }
+        fail("unterminated string");
+    }
+
+    void decodeString(size_t end, std::string& out) {
+        for (size_t i = pos_; i < end; ++i) {
+            char c = in_[i];
+            if (c != '\\') {
+                out.push_back(c);
+                continue;
+            }
+            char e = in_[++i];
+            switch (e) {
+                case '"': out.push_back('"'); break;
+                case '\\': out.push_back('\\'); break;
+                case '/': out.push_back('/'); break;
+                case 'b': out.push_back('\b'); break;
+                case 'f': out.push_back('\f'); break;
+                case 'n': out.push_back('\n'); break;
+                case 'r': out.push_back('\r'); break;
+                case 't': out.push_back('\t'); break;
+                case 'u': {
+                    uint32_t code = hex4(i + 1, end);
+                    i += 4;
+                    if (code >= 0xD800 && code < 0xDC00 && i + 2 < end &&
+                        in_[i + 1] == '\\' && in_[i + 2] == 'u') {
+                        uint32_t low = hex4(i + 3, end);
+                        if (low >= 0xDC00 && low < 0xE000) {
+                            code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+                            i += 6;
+                        }
+                    }
+                    appendUtf8(out, code);
+                    break;
+                }
+                default:
+                    fail(std::string("invalid escape '\\") + e + "'");
+            }
+        }
+    }
+
+    uint32_t hex4(size_t at, size_t end) const {
+        if (at + 4 > end) {
+            fail("truncated \\u escape");
+        }
+        uint32_t code = 0;
+        auto result = std::from_chars(in_.data() + at, in_.data() + at + 4, code, 16);
+        if (result.ec != std::errc() || result.ptr != in_.data() + at + 4) {
+            fail("invalid \\u escape");
+        }
+        return code;
+    }
+
+    std::string_view parseKey() {
+        bool escaped = false;
+        size_t end = scanString(escaped);
+        std::string_view key;
+        if (escaped) {
+            keyBuffer_.clear();
+            decodeString(end, keyBuffer_);
+            key = keyBuffer_;
+        } else {
+            key = in_.substr(pos_, end - pos_);
+        }
+        pos_ = end + 1;
+        return key;
+    }
+
+    void parseValue(ParsedBatch& batch, Field& field) {
+        char c = peek();
+        if (c == '"') {
+            ++pos_;
+            bool escaped = false;
+            size_t end = scanString(escaped);
+            field.kind = FieldKind::Text;
+            if (escaped) {
+                field.inScratch = true;
+                field.offset = batch.scratch.size();
+                decodeString(end, batch.scratch);
+                field.size = batch.scratch.size() - field.offset;
+            } else {
+                field.data = in_.data() + pos_;
+                field.size = end - pos_;
+            }
+            pos_ = end + 1;
+        } else if (c == '{' || c == '[') {
+            // Nested JSON binds as its text
+            size_t start = pos_;
+            skipNested();
+            field.kind = FieldKind::Text;
+            field.data = in_.data() + start;
+            field.size = pos_ - start;
+        } else if (c == '-' || (c >= '0' && c <= '9')) {
+            parseNumber(field);
+        } else if (in_.compare(pos_, 4, "true") == 0) {
+            field.kind = FieldKind::Integer;
+            field.integer = 1;
+            pos_ += 4;
+        } else if (in_.compare(pos_, 5, "false") == 0) {
+            field.kind = FieldKind::Integer;
+            field.integer = 0;
+            pos_ += 5;
+        } else if (in_.compare(pos_, 4, "null") == 0) {
+            field.kind = FieldKind::Null;
+            pos_ += 4;
+        } else {
+            fail("invalid value");
+        }
+    }
+
+    void parseNumber(Field& field) {
+        size_t start = pos_;
+        bool real = false;
+        while (pos_ < in_.size()) {
+            char c = in_[pos_];
+            if (c == '.' || c == 'e' || c == 'E') {
+                real = true;
+            } else if (!(c == '-' || c == '+' || (c >= '0' && c <= '9'))) {
+                break;
+            }
+            ++pos_;
+        }
+        const char* first = in_.data() + start;
+        const char* last = in_.data() + pos_;
+
+        if (!real) {
+            auto result = std::from_chars(first, last, field.integer);
+            if (result.ec == std::errc() && result.ptr == last) {
+                field.kind = FieldKind::Integer;
+                return;
+            }
+            if (result.ec != std::errc::result_out_of_range) {
+                fail("invalid number");
+            }
+        }
+        // Also integers beyond int64
+        auto result = std::from_chars(first, last, field.real);
+        if (result.ec != std::errc() || result.ptr != last) {
+            fail("invalid number");
+        }
+        field.kind = FieldKind::Real;
+    }
+
+    void skipNested() {
+        int depth = 0;
+        while (pos_ < in_.size()) {
+            char c = in_[pos_];
+            if (c == '"') {
+                ++pos_;
+                bool escaped = false;
+                pos_ = scanString(escaped) + 1;
+                continue;
+            }
+            if (c == '\n') {
+                break;
+            }
+            ++pos_;
+            if (c == '{' || c == '[') {
+                ++depth;
+            } else if ((c == '}' || c == ']') && --depth == 0) {
+                return;
+            }
+        }
+        fail("unterminated nested value");
+    }
+
+    std::string_view in_;
+    size_t pos_ = 0;
+    size_t line_ = 1;
+    size_t columnCount_;
+    std::unordered_map<std::string_view, size_t> index_;
+    std::string keyBuffer_;
+};
+
+// ========== Input ==========
+
+// The whole file, memory-mapped where possible
+class InputFile {
+public:
+    explicit InputFile(const std::string& path) {
+#if !defined(_WIN32)
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            throw DatabaseException("Failed to open '" + path + "': " + std::strerror(errno));
+        }
+        struct stat info {};
+        if (::fstat(fd, &info) != 0 || !S_ISREG(info.st_mode)) {
+            // FIFOs, /dev/stdin, procfs: no usable size, read to EOF
+            readAll(fd, path);
+            return;
+        }
+        if (info.st_size > 0) {
+            size_ = static_cast<size_t>(info.st_size);
+            void* mapped = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (mapped != MAP_FAILED) {
+                ::madvise(mapped, size_, MADV_SEQUENTIAL);
+                mapped_ = static_cast<const char*>(mapped);
+            }
+        }
+        ::close(fd);
+        if (mapped_ || size_ == 0) {
+            return;
+        }
+#endif
+        // Fallback: one big read
+        std::ifstream in(path, std::ios::binary);
+        if (!in) {
+            throw DatabaseException("Failed to open '" + path + "'");
+        }
+        buffer_.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+        size_ = buffer_.size();
+    }
+
+    ~InputFile() {
+#if !defined(_WIN32)
+        if (mapped_) {
+            ::munmap(const_cast<char*>(mapped_), size_);
+        }
+#endif
+    }
+
+    InputFile(const InputFile&) = delete;
+    InputFile& operator=(const InputFile&) = delete;
+
+    std::string_view data() const {
+        return mapped_ ? std::string_view(mapped_, size_) : std::string_view(buffer_);
+    }
+
+private:
+#if !defined(_WIN32)
+    // Reads from the descriptor already open: reopening a FIFO would
+    // lose what the writer sent to this one. Closes fd.
+    void readAll(int fd, const std::string& path) {
+        char chunk[64 * 1024];
+        for (;;) {
+            ssize_t n = ::read(fd, chunk, sizeof(chunk));
+            if (n > 0) {
+                buffer_.append(chunk, static_cast<size_t>(n));
+            } else if (n == 0) {
+                break;
+            } else if (errno != EINTR) {
+                int error = errno;
+                ::close(fd);
+                throw DatabaseException("Failed to read '" + path + "': " + std::strerror(error));
+            }
+        }
+        ::close(fd);
+        size_ = buffer_.size();
+    }
+#endif
+
+    const char* mapped_ = nullptr;
+    size_t size_ = 0;
+    std::string buffer_;
+};
+
+// ========== Load environment ==========
+
+// synchronous=OFF and a big cache for the duration of the import
+class BulkLoadPragmas {
+public:
+    explicit BulkLoadPragmas(Connection& conn) : conn_(conn) {
+        synchronous_ = readPragma("synchronous");
+        cacheSize_ = readPragma("cache_size");
+        conn_.execute("PRAGMA synchronous = OFF; PRAGMA cache_size = -262144");
+    }
+
+    ~BulkLoadPragmas() {
+        try {
+            conn_.execute("PRAGMA synchronous = " + std::to_string(synchronous_) +
+                          "; PRAGMA cache_size = " + std::to_string(cacheSize_));
+        } catch (const DatabaseException&) {
+            // The import's own outcome matters more
+        }
+    }
+
+private:
+    int64_t readPragma(const std::string& name) {
+        auto stmt = conn_.prepare("PRAGMA " + name);
+        return stmt.step() ? stmt.columnInt64(0) : 0;
+    }
+
+    Connection& conn_;
+    int64_t synchronous_ = 2;
+    int64_t cacheSize_ = -2000;
+};
+
+// Non-unique indexes of a table, dropped and later recreated
+class IndexRebuild {
+public:
+    IndexRebuild(Connection& conn, const std::string& table) : conn_(conn) {
+        auto stmt = conn_.prepare(
+            "SELECT m.name, m.sql FROM sqlite_master AS m "
+            "JOIN pragma_index_list(m.tbl_name) AS il ON il.name = m.name "
+            "WHERE m.type = 'index' AND m.tbl_name = ? AND m.sql IS NOT NULL AND il.\"unique\" = 0");
+        stmt.bind(1, table);
+        std::vector<std::string> names;
+        while (stmt.step()) {
+            names.push_back(stmt.columnString(0));
+            definitions_.push_back(stmt.columnString(1));
+        }
+        stmt.reset();
+
+        Transaction txn(conn_);
+        for (const auto& name : names) {
+            conn_.execute("DROP INDEX " + quoteIdentifier(name));
+        }
+        txn.commit();
+    }
+
+    void recreate() {
+        Transaction txn(conn_);
+        for (const auto& sql : definitions_) {
+            conn_.execute(sql);
+        }
+        txn.commit();
+        definitions_.clear();
+    }
+
+    // After a failed import: put the schema back, keep the first error
+    void recoverQuietly() noexcept {
+        try {
+            recreate();
+        } catch (...) {
+        }
+    }
+
+private:
+    Connection& conn_;
+    std::vector<std::string> definitions_;
+};
+
+// ========== Import pipeline ==========
+
+class Importer {
+public:
+    Importer(Connection& conn, const std::string& table, std::string_view data,
+             const ImportOptions& options)
+        : conn_(conn)
+        , table_(table)
+        , options_(options)
+    {
+        if (options_.format == DataFormat::Csv) {
+            csv_.emplace(data, options_.delimiter, options_.emptyAsNull);
+            columns_ = options_.columns;
+            if (options_.header) {
+                ParsedBatch header;
+                csv_->next(header);
+                if (columns_.empty()) {
+                    for (const auto& field : header.fields) {
+                        columns_.emplace_back(header.text(field));
+                    }
+                }
+            }
+            if (columns_.empty()) {
+                auto schema = conn_.schemaCatalog();
+                const TableInfo* info = schema->table(table);
+                if (!info) {
+                    throw DatabaseException("Import target table '" + table + "' does not exist");
+                }
+                for (const auto& col : info->columns) {
+                    columns_.push_back(col.name);
+                }
+            }
+        } else {
+            columns_ = options_.columns;
+            if (columns_.empty()) {
+                // Keys of the first object
+                std::vector<std::string> none;
+                NdjsonParser probe(data, none);
+                ParsedBatch scratch;
+                probe.next(scratch, &columns_);
+            }
+            json_.emplace(data, columns_);
+        }
+
+        if (columns_.empty()) {
+            throw DatabaseException("Nothing to import into '" + table + "': no columns");
+        }
+
+        // Names come from the input: quote them as the shell's .import does
+        std::string sql = "INSERT INTO " + quoteIdentifier(table) + " (";
+        std::string params;
+        for (size_t i = 0; i < columns_.size(); ++i) {
+            sql += (i > 0 ? ", " : "") + quoteIdentifier(columns_[i]);
+            params += i > 0 ? ", ?" : "?";
+        }
+        sql += ") VALUES (" + params + ")";
+        insert_.emplace(conn_.prepare(sql));
+    }
+
+    int64_t run() {
+        std::optional<BulkLoadPragmas> pragmas;
+        if (options_.bulkLoadPragmas) {
+            pragmas.emplace(conn_);
+        }
+        std::optional<IndexRebuild> indexes;
+        if (options_.rebuildIndexes) {
+            indexes.emplace(conn_, table_);
+        }
+
+        try {
+            if (options_.parallelParse) {
+                runParallel();
+            } else {
+                ParsedBatch batch;
+                bool more = true;
+                while (more) {
+                    batch.clear();
+                    more = parse(batch);
+                    insert(batch);
+                }
+            }
+            commit();
+        } catch (...) {
+            txn_.reset();
+            if (indexes) {
+                indexes->recoverQuietly();
+            }
+            throw;
+        }
+
+        if (indexes) {
+            indexes->recreate();
+        }
+        return inserted_;
+    }
+
+private:
+    // Fill batch with up to kParseChunkRows rows; false once the input is done
+    bool parse(ParsedBatch& batch) {
+        size_t columns = columns_.size();
+        batch.fields.reserve(kParseChunkRows * columns);
+        while (batch.rows < kParseChunkRows) {
+            if (csv_) {
+                size_t count = csv_->next(batch);
+                if (count == 0) {
+                    return false;
+                }
+                if (count != columns) {
+                    throwParseError("CSV record", csv_->record(),
+                                    std::to_string(count) + " fields, expected " + std::to_string(columns));
+                }
+            } else if (!json_->next(batch)) {
+                return false;
+            }
+            ++batch.rows;
+        }
+        return true;
+    }
+
+    void insert(const ParsedBatch& batch) {
+        Statement& stmt = *insert_;
+        size_t columns = columns_.size();
+        size_t batchSize = std::max<size_t>(options_.batchSize, 1);
+
+        for (size_t row = 0; row < batch.rows; ++row) {
+            if (!txn_) {
+                txn_.emplace(conn_);
+            }
+            const Field* fields = batch.fields.data() + row * columns;
+            for (size_t col = 0; col < columns; ++col) {
+                const Field& field = fields[col];
+                int index = static_cast<int>(col + 1);
+                switch (field.kind) {
+                    // The batch outlives the step, so text binds in place
+                    case FieldKind::Text: stmt.bindStatic(index, batch.text(field)); break;
+                    case FieldKind::Null: stmt.bind(index, NullValue{}); break;
+                    case FieldKind::Integer: stmt.bind(index, field.integer); break;
+                    case FieldKind::Real: stmt.bind(index, field.real); break;
+                }
+            }
+            stmt.execute();
+            ++inserted_;
+            if (++inTransaction_ >= batchSize) {
+                commit();
+            }
+        }
+    }
+
+    void commit() {
+        if (txn_) {
+            txn_->commit();
+            txn_.reset();
+        }
+        inTransaction_ = 0;
+    }
+
+    // The worker parses into free batches while this thread inserts
+    // filled ones; three batches keep both sides busy
+    void runParallel() {
+        ParsedBatch batches[3];
+        std::mutex mutex;
+        std::condition_variable changed;
+        std::deque<ParsedBatch*> free{&batches[0], &batches[1], &batches[2]};
+        std::deque<ParsedBatch*> filled;
+        bool finished = false;
+        bool cancelled = false;
+        std::exception_ptr parseError;
+
+        std::thread worker([&] {
+            while (true) {
+                ParsedBatch* batch = nullptr;
+                {
+                    std::unique_lock<std::mutex> lock(mutex);
+                    changed.wait(lock, [&] { return cancelled || !free.empty(); });
+                    if (cancelled) {
+                        return;
+                    }
+                    batch = free.front();
+                    free.pop_front();
+                }
+
+                batch->clear();
+                bool more = false;
+                try {
+                    more = parse(*batch);
+                } catch (...) {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    parseError = std::current_exception();
+                    finished = true;
+                    changed.notify_all();
+                    return;
+                }
+
+                std::lock_guard<std::mutex> lock(mutex);
+                (batch->rows > 0 ? filled : free).push_back(batch);
+                finished = !more;
+                changed.notify_all();
+                if (!more) {
+                    return;
+                }
+            }
+        });
+
+        try {
+            while (true) {
+                ParsedBatch* batch = nullptr;
+                {
+                    std::unique_lock<std::mutex> lock(mutex);
+                    changed.wait(lock, [&] { return finished || !filled.empty(); });
+                    if (filled.empty()) {
+                        break;
+                    }
+                    batch = filled.front();
+                    filled.pop_front();
+                }
+
+                insert(*batch);
+
+                std::lock_guard<std::mutex> lock(mutex);
+                free.push_back(batch);
+                changed.notify_all();
+            }
+        } catch (...) {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                cancelled = true;
+                changed.notify_all();
+            }
+            worker.join();
+            throw;
+        }
+
+        worker.join();
+        if (parseError) {
+            std::rethrow_exception(parseError);
+        }
+    }
+
+    Connection& conn_;
+    std::string table_;
+    const ImportOptions& options_;
+    std::vector<std::string> columns_;
+    std::optional<CsvParser> csv_;
+    std::optional<NdjsonParser> json_;
+    std::optional<Statement> insert_;
+    std::optional<Transaction> txn_;
+    size_t inTransaction_ = 0;
+    int64_t inserted_ = 0;
+};
+
+// ========== Export ==========
+
+class OutputBuffer {
+public:
+    explicit OutputBuffer(std::ostream& out) : out_(out) {
+        buffer_.reserve(kOutputBufferBytes + 256);
+    }
+
+    std::string& text() { return buffer_; }
+
+    void flushIfFull() {
+        if (buffer_.size() >= kOutputBufferBytes) {
+            flush();
+        }
+    }
+
+    void flush() {
+        out_.write(buffer_.data(), static_cast<std::streamsize>(buffer_.size()));
+        buffer_.clear();
+    }
+
+private:
+    std::ostream& out_;
+    std::string buffer_;
+};
+
+void appendInteger(std::string& out, int64_t value) {
+    char digits[24];
+    auto result = std::to_chars(digits, digits + sizeof(digits), value);
+    out.append(digits, result.ptr);
+}
+
+// Shortest text that reads back as the same double
+void appendReal(std::string& out, double value) {
+    char digits[32];
+    auto result = std::to_chars(digits, digits + sizeof(digits), value);
+    out.append(digits, result.ptr);
+}
+
+void appendHex(std::string& out, const void* data, size_t size) {
+    static const char* const kHex = "0123456789abcdef";
+    const auto* bytes = static_cast<const unsigned char*>(data);
+    for (size_t i = 0; i < size; ++i) {
+        out.push_back(kHex[bytes[i] >> 4]);
+        out.push_back(kHex[bytes[i] & 0x0F]);
+    }
+}
+
+void appendCsvText(std::string& out, std::string_view text, char delimiter) {
+    bool quote = false;
+    for (char c : text) {
+        if (c == delimiter || c == '"' || c == '\n' || c == '\r') {
+            quote = true;
+            break;
+        }
+    }
+    if (!quote) {
+        out.append(text);
+        return;
+    }
+    out.push_back('"');
+    for (char c : text) {
+        if (c == '"') {
+            out.push_back('"');
+        }
+        out.push_back(c);
+    }
+    out.push_back('"');
+}
+
+void appendJsonString(std::string& out, std::string_view text) {
+    static const char* const kHex = "0123456789abcdef";
+    out.push_back('"');
+    for (char c : text) {
+        auto u = static_cast<unsigned char>(c);
+        switch (c) {
+            case '"': out.append("\\\""); break;
+            case '\\': out.append("\\\\"); break;
+            case '\n': out.append("\\n"); break;
+            case '\r': out.append("\\r"); break;
+            case '\t': out.append("\\t"); break;
+            case '\b': out.append("\\b"); break;
+            case '\f': out.append("\\f"); break;
+            default:
+                if (u < 0x20) {
+                    out.append("\\u00");
+                    out.push_back(kHex[u >> 4]);
+                    out.push_back(kHex[u & 0x0F]);
+                } else {
+                    out.push_back(c);
+                }
+        }
+    }
+    out.push_back('"');
+}
+
+void appendCell(std::string& out, sqlite3_stmt* stmt, int column, const ExportOptions& options) {
+    bool csv = options.format == DataFormat::Csv;
+    switch (sqlite3_column_type(stmt, column)) {
+        case SQLITE_NULL:
+            out.append(csv ? std::string_view(options.nullText) : std::string_view("null"));
+            break;
+        case SQLITE_INTEGER:
+            appendInteger(out, sqlite3_column_int64(stmt, column));
+            break;
+        case SQLITE_FLOAT: {
+            double value = sqlite3_column_double(stmt, column);
+            if (!csv && !std::isfinite(value)) {
+                out.append("null");
+            } else {
+                appendReal(out, value);
+            }
+            break;
+        }
+        case SQLITE_TEXT: {
+            const char* text = reinterpret_cast<const char*>(sqlite3_column_text(stmt, column));
+            std::string_view view(text ? text : "", static_cast<size_t>(sqlite3_column_bytes(stmt, column)));
+            if (csv) {
+                appendCsvText(out, view, options.delimiter);
+            } else {
+                appendJsonString(out, view);
+            }
+            break;
+        }
+        default: {
+            const void* blob = sqlite3_column_blob(stmt, column);
+            auto size = static_cast<size_t>(sqlite3_column_bytes(stmt, column));
+            if (!csv) {
+                out.push_back('"');
+            }
+            appendHex(out, blob, size);
+            if (!csv) {
+                out.push_back('"');
+            }
+        }
+    }
+}
+
+} // namespace
+
+// ========== Public API ==========
+
+int64_t importText(Connection& conn, const std::string& table, std::string_view data,
+                   const ImportOptions& options) {
+    Importer importer(conn, table, data, options);
+    return importer.run();
+}
+
+int64_t importFile(Connection& conn, const std::string& table, const std::string& path,
+                   const ImportOptions& options) {
+    InputFile file(path);
+    return importText(conn, table, file.data(), options);
+}
+
+int64_t importStream(Connection& conn, const std::string& table, std::istream& in,
+                     const ImportOptions& options) {
+    std::string data(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>{});
+    return importText(conn, table, data, options);
+}
+
+int64_t exportStatement(Statement& stmt, std::ostream& out, const ExportOptions& options) {
+    ScopedReset guard(stmt);
+    sqlite3_stmt* handle = stmt.handle();
+    int columns = stmt.columnCount();
+    bool csv = options.format == DataFormat::Csv;
+
+    OutputBuffer buffer(out);
+    std::string& text = buffer.text();
+
+    // NDJSON: the "name": prefixes, built once
+    std::vector<std::string> keys;
+    for (int i = 0; i < columns; ++i) {
+        if (csv) {
+            if (options.header) {
+                if (i > 0) text.push_back(options.delimiter);
+                appendCsvText(text, stmt.columnName(i), options.delimiter);
+            }
+        } else {
+            std::string key(i == 0 ? "{" : ",");
+            appendJsonString(key, stmt.columnName(i));
+            key.push_back(':');
+            keys.push_back(std::move(key));
+        }
+    }
+    if (csv && options.header) {
+        text.push_back('\n');
+    }
+
+    int64_t rows = 0;
+    while (stmt.step()) {
+        for (int i = 0; i < columns; ++i) {
+            if (csv) {
+                if (i > 0) text.push_back(options.delimiter);
+            } else {
+                text.append(keys[static_cast<size_t>(i)]);
+            }
+            appendCell(text, handle, i, options);
+        }
+        if (!csv) {
+            text.append(columns == 0 ? "{}" : "}");
+        }
+        text.push_back('\n');
+        ++rows;
+        buffer.flushIfFull();
+    }
+    buffer.flush();
+    return rows;
+}
+
+int64_t exportQuery(QueryBuilder& query, std::ostream& out, const ExportOptions& options) {
+    Cursor cursor = query.stream();
+    return exportStatement(cursor.statement(), out, options);
+}
+
+} // namespace sqlite3db
@@ -0,0 +1,205 @@
+/**
+ * @file checkpoint.cpp
+ * @brief Implementation of CheckpointManager
+ */
+
+#include "sqlite3db/checkpoint.hpp"
+#include <algorithm>
+#include <filesystem>
+#include "sqlite3db/statement.hpp"
+
+namespace sqlite3db {
+
+namespace {
+
+int sqliteMode(CheckpointMode mode) {
+    switch (mode) {
+        case CheckpointMode::Passive: return SQLITE_CHECKPOINT_PASSIVE;
+        case CheckpointMode::Full: return SQLITE_CHECKPOINT_FULL;
+        case CheckpointMode::Restart: return SQLITE_CHECKPOINT_RESTART;
+        case CheckpointMode::Truncate: return SQLITE_CHECKPOINT_TRUNCATE;
+    }
+    return SQLITE_CHECKPOINT_PASSIVE;
+}
+
+// Same default as SQLITE_DEFAULT_WAL_AUTOCHECKPOINT
+constexpr int kDefaultAutoCheckpoint = 1000;
+
+} // namespace
+
+CheckpointManager::CheckpointManager(const std::string& dbPath, const CheckpointOptions& options)
+    : options_(options)
+    , walPath_(dbPath + "-wal")
+{
+    if (dbPath.empty() || dbPath == ":memory:") {
+        throw ConnectionException("CheckpointManager needs a file database, got '" + dbPath + "'");
+    }
+
+    ConnectionOptions connOpts = options_.connectionOptions;
+    connOpts.enableWAL = true;
+    conn_ = Connection::open(dbPath, connOpts);
+    // This connection only checkpoints; it must never do so inline
+    sqlite3_wal_autocheckpoint(conn_->handle(), 0);
+
+    worker_ = std::thread([this] { workerLoop(); });
+}
+
+CheckpointManager::~CheckpointManager() {
+    stop();
+}
+
+void CheckpointManager::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    wake_.notify_all();
+    if (worker_.joinable()) {
+        worker_.join();
+    }
+}
+
+void CheckpointManager::attach(Connection& writer) {
+    // Read before installing the hook: with a custom wal_hook in place the
+    // PRAGMA reports 0. Attaching twice keeps the first value.
+    int autoCheckpoint = kDefaultAutoCheckpoint;
+    {
+        auto stmt = writer.prepare("PRAGMA wal_autocheckpoint");
+        if (stmt.step()) {
+            autoCheckpoint = stmt.columnInt(0);
+        }
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        savedAutoCheckpoint_.try_emplace(writer.handle(), autoCheckpoint);
+    }
+    sqlite3_wal_hook(writer.handle(), &CheckpointManager::walHook, this);
+}
+
+void CheckpointManager::detach(Connection& writer) {
+    int autoCheckpoint = kDefaultAutoCheckpoint;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = savedAutoCheckpoint_.find(writer.handle());
+        if (it != savedAutoCheckpoint_.end()) {
+            autoCheckpoint = it->second;
+            savedAutoCheckpoint_.erase(it);
+        }
+    }
+    // wal_autocheckpoint is itself a wal_hook; setting it replaces ours
+    sqlite3_wal_autocheckpoint(writer.handle(), autoCheckpoint);
+}
+
+int CheckpointManager::walHook(void* context, sqlite3*, const char*, int frames) {
+    // Runs inside the writer's COMMIT: only signal, never checkpoint here
+    auto* self = static_cast<CheckpointManager*>(context);
+    if (self->options_.frameThreshold > 0 && frames >= self->options_.frameThreshold) {
+        self->requestCheckpoint();
+    }
+    return SQLITE_OK;
+}
+
+void CheckpointManager::requestCheckpoint() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        requested_ = true;
+    }
+    wake_.notify_one();
+}
+
+int64_t CheckpointManager::walSizeBytes() const {
+    std::error_code ec;
+    auto size = std::filesystem::file_size(walPath_, ec);
+    return ec ? 0 : static_cast<int64_t>(size);
+}
+
+CheckpointMetrics CheckpointManager::metrics() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return metrics_;
+}
+
+CheckpointResult CheckpointManager::checkpoint(CheckpointMode mode) {
+    std::lock_guard<std::mutex> checkpointLock(checkpointMutex_);
+
+    CheckpointResult result;
+    result.mode = mode;
+
+    auto start = std::chrono::steady_clock::now();
+    result.resultCode = sqlite3_wal_checkpoint_v2(conn_->handle(), "main", sqliteMode(mode),
+                                                  &result.framesInLog, &result.framesCheckpointed);
+    result.durationNs = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - start).count();
+
+    // Not in WAL mode: SQLite reports -1 for both counts
+    result.framesInLog = std::max(result.framesInLog, 0);
+    result.framesCheckpointed = std::max(result.framesCheckpointed, 0);
+
+    int64_t walSize = walSizeBytes();
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    metrics_.walSizeBytes = walSize;
+    ++metrics_.checkpoints;
+    switch (mode) {
+        case CheckpointMode::Passive: ++metrics_.passiveCheckpoints; break;
+        case CheckpointMode::Restart: ++metrics_.restartCheckpoints; break;
+        case CheckpointMode::Truncate: ++metrics_.truncateCheckpoints; break;
+        case CheckpointMode::Full: break;
+    }
+    if ((result.resultCode & 0xFF) == SQLITE_BUSY) {
+        ++metrics_.busyCheckpoints;
+    } else if (result.resultCode != SQLITE_OK) {
+        metrics_.lastErrorCode = result.resultCode;
+    }
+    // A RESTART/TRUNCATE resets the log, so count what this run copied
+    metrics_.framesCheckpointed += static_cast<uint64_t>(result.framesCheckpointed);
+    metrics_.lastFramesInLog = result.framesInLog;
+    metrics_.lastDurationNs = result.durationNs;
+    metrics_.maxDurationNs = std::max(metrics_.maxDurationNs, result.durationNs);
+    metrics_.totalDurationNs += result.durationNs;
+    return result;
+}
+
+void CheckpointManager::runScheduled() {
+    CheckpointResult passive = checkpoint(CheckpointMode::Passive);
+    CheckpointMode escalation = options_.truncateOnEscalation ? CheckpointMode::Truncate
+                                                              : CheckpointMode::Restart;
+
+    if (passive.complete()) {
+        incompleteRuns_ = 0;
+        // Everything is in the database, but the file keeps its size
+        if (options_.truncateSizeBytes > 0 && walSizeBytes() >= options_.truncateSizeBytes) {
+            checkpoint(CheckpointMode::Truncate);
+        }
+        return;
+    }
+
+    // Readers pinned old snapshots: passive runs alone won't catch up
+    if (++incompleteRuns_ >= options_.passiveRunsBeforeEscalation) {
+        incompleteRuns_ = 0;
+        checkpoint(escalation);
+    }
+}
+
+void CheckpointManager::workerLoop() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!stopping_) {
+        wake_.wait_for(lock, options_.pollInterval, [&] { return stopping_ || requested_; });
+        if (stopping_) {
+            break;
+        }
+        bool requested = requested_;
+        requested_ = false;
+        lock.unlock();
+
+        if (requested || walSizeBytes() >= options_.walSizeThresholdBytes) {
+            runScheduled();
+        } else {
+            std::lock_guard<std::mutex> metricsLock(mutex_);
+            metrics_.walSizeBytes = walSizeBytes();
+        }
+
+        lock.lock();
+    }
+}
+
+} // namespace sqlite3db
@@ -0,0 +1,189 @@
+/**
+ * @file columnar.cpp
+ * @brief Implementation of ColumnarReader and RecordBatch
+ */
+
+#include "sqlite3db/columnar.hpp"
+#include <algorithm>
+#include <cctype>
+#include <limits>
+
+namespace sqlite3db {
+
+namespace {
+
+bool contains(const std::string& haystack, const char* needle) {
+    return haystack.find(needle) != std::string::npos;
+}
+
+// SQLite's column affinity rules; false when the declared type says
+// nothing useful (no declaration, NUMERIC affinity, expressions)
+bool typeFromDeclaration(const char* declared, ColumnType& type) {
+    if (!declared || !*declared) {
+        return false;
+    }
+    std::string decl(declared);
+    for (char& c : decl) {
+        c = static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
+    }
+    if (contains(decl, "INT")) {
+        type = ColumnType::Integer;
+    } else if (contains(decl, "CHAR") || contains(decl, "CLOB") || contains(decl, "TEXT")) {
+        type = ColumnType::Text;
+    } else if (contains(decl, "BLOB")) {
+        type = ColumnType::Blob;
+    } else if (contains(decl, "REAL") || contains(decl, "FLOA") || contains(decl, "DOUB")) {
+        type = ColumnType::Real;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+ColumnType typeFromValue(int sqliteType) {
+    switch (sqliteType) {
+        case SQLITE_FLOAT: return ColumnType::Real;
+        case SQLITE_TEXT: return ColumnType::Text;
+        case SQLITE_BLOB: return ColumnType::Blob;
+        default: return ColumnType::Integer;
+    }
+}
+
+} // namespace
+
+// ========== RecordBatch ==========
+
+const ColumnBuffer& RecordBatch::column(const std::string& name) const {
+    for (const auto& col : columns) {
+        if (col.name == name) {
+            return col;
+        }
+    }
+    throw DatabaseException("No column named '" + name + "' in record batch");
+}
+
+// ========== ColumnarReader ==========
+
+ColumnarReader::ColumnarReader(Statement stmt, const ColumnarOptions& options)
+    : stmt_(std::move(stmt))
+    , options_(options)
+{
+    options_.batchSize = std::max<size_t>(options_.batchSize, 1);
+}
+
+void ColumnarReader::resolveTypes() {
+    sqlite3_stmt* handle = stmt_.handle();
+    int count = stmt_.columnCount();
+    types_.resize(static_cast<size_t>(count));
+    for (int i = 0; i < count; ++i) {
+        auto index = static_cast<size_t>(i);
+        if (index < options_.types.size()) {
+            types_[index] = options_.types[index];
+        } else if (!typeFromDeclaration(sqlite3_column_decltype(handle, i), types_[index])) {
+            types_[index] = typeFromValue(sqlite3_column_type(handle, i));
+        }
+    }
+}
+
+void ColumnarReader::prepareBatch(RecordBatch& batch) const {
+    batch.rows = 0;
+    batch.columns.resize(types_.size());
+    for (size_t i = 0; i < types_.size(); ++i) {
+        ColumnBuffer& col = batch.columns[i];
+        col.name = stmt_.columnName(static_cast<int>(i));
+        col.type = types_[i];
+        // clear() keeps capacity: after the first batch nothing reallocates
+        col.ints.clear();
+        col.reals.clear();
+        col.offsets.clear();
+        col.data.clear();
+        switch (col.type) {
+            case ColumnType::Integer: col.ints.reserve(options_.batchSize); break;
+            case ColumnType::Real: col.reals.reserve(options_.batchSize); break;
+            case ColumnType::Text:
+            case ColumnType::Blob:
+                col.offsets.reserve(options_.batchSize + 1);
+                col.offsets.push_back(0);
+                break;
+        }
+        col.validity.assign((options_.batchSize + 7) / 8, 0);
+        col.nullCount = 0;
+    }
+}
+
+void ColumnarReader::appendRow(RecordBatch& batch, size_t row) {
+    sqlite3_stmt* handle = stmt_.handle();
+    for (size_t i = 0; i < batch.columns.size(); ++i) {
+        ColumnBuffer& col = batch.columns[i];
+        int index = static_cast<int>(i);
+        bool isNull = sqlite3_column_type(handle, index) == SQLITE_NULL;
+        if (isNull) {
+            ++col.nullCount;
+        } else {
+            col.validity[row >> 3] |= static_cast<uint8_t>(1u << (row & 7));
+        }
+
+        switch (col.type) {
+            case ColumnType::Integer:
+                col.ints.push_back(isNull ? 0 : sqlite3_column_int64(handle, index));
+                break;
+            case ColumnType::Real:
+                col.reals.push_back(isNull ? 0.0 : sqlite3_column_double(handle, index));
+                break;
+            case ColumnType::Text:
+            case ColumnType::Blob: {
+                if (!isNull) {
+                    // Fetch the pointer first: it may convert, which changes the size
+                    const char* bytes = col.type == ColumnType::Text
+                        ? reinterpret_cast<const char*>(sqlite3_column_text(handle, index))
+                        : static_cast<const char*>(sqlite3_column_blob(handle, index));
+                    auto size = static_cast<size_t>(sqlite3_column_bytes(handle, index));
+                    if (col.data.size() + size > std::numeric_limits<uint32_t>::max()) {
+                        throw QueryException("Column '" + col.name +
+                                             "' exceeds 4 GiB in one batch; use a smaller batchSize",
+                                             stmt_.sql());
+                    }
+                    if (bytes) {
+                        col.data.insert(col.data.end(), bytes, bytes + size);
+                    }
+                }
+                col.offsets.push_back(static_cast<uint32_t>(col.data.size()));
+                break;
+            }
+        }
+    }
+}
+
+bool ColumnarReader::next(RecordBatch& batch) {
+    if (done_ || !stmt_.step()) {
+        done_ = true;
+        if (!types_.empty()) {
+            prepareBatch(batch);
+        } else {
+            batch.rows = 0;
+            batch.columns.clear();
+        }
+        return false;
+    }
+
+    if (types_.empty()) {
+        resolveTypes();
+    }
+    prepareBatch(batch);
+
+    appendRow(batch, batch.rows++);
+    while (batch.rows < options_.batchSize) {
+        if (!stmt_.step()) {
+            done_ = true;
+            break;
+        }
+        appendRow(batch, batch.rows++);
+    }
+
+    for (auto& col : batch.columns) {
+        col.validity.resize((batch.rows + 7) / 8);
+    }
+    return true;
+}
+
+} // namespace sqlite3db
@@ -4,13 +4,68 @@
  */
 
 #include "sqlite3db/connection.hpp"
+#include "sqlite3db/schema_catalog.hpp"
 #include "sqlite3db/statement.hpp"
 #include "sqlite3db/transaction.hpp"
+#include <algorithm>
+#include <string>
 
 namespace sqlite3db {
 
+namespace {
+
+const char* synchronousName(SynchronousMode mode) {
+    switch (mode) {
+        case SynchronousMode::Off: return "OFF";
+        case SynchronousMode::Normal: return "NORMAL";
+        case SynchronousMode::Full: return "FULL";
+        case SynchronousMode::Extra: return "EXTRA";
+    }
+    return "FULL";
+}
+
+const char* tempStoreName(TempStore store) {
+    switch (store) {
+        case TempStore::Default: return "DEFAULT";
+        case TempStore::File: return "FILE";
+        case TempStore::Memory: return "MEMORY";
+    }
+    return "DEFAULT";
+}
+
+} // namespace
+
+// ========== Presets ==========
+
+ConnectionOptions ConnectionOptions::readHeavy() {
+    ConnectionOptions opts;
+    opts.mmapSize = int64_t(256) << 20;
+    opts.cacheSizeKiB = 64 * 1024;
+    opts.synchronous = SynchronousMode::Normal;
+    opts.tempStore = TempStore::Memory;
+    return opts;
+}
+
+ConnectionOptions ConnectionOptions::bulkLoad() {
+    ConnectionOptions opts;
+    opts.cacheSizeKiB = 256 * 1024;
+    opts.synchronous = SynchronousMode::Off;
+    opts.tempStore = TempStore::Memory;
+    opts.walAutoCheckpoint = 0;
+    return opts;
+}
+
+ConnectionOptions ConnectionOptions::durable() {
+    ConnectionOptions opts;
+    opts.synchronous = SynchronousMode::Full;
+    return opts;
+}
+
+// ========== Connection ==========
+
 Connection::Connection(const std::string& dbPath, const ConnectionOptions& options)
     : dbPath_(dbPath)
+    , statementCache_(std::make_unique<StatementCache>(options.statementCacheSize))
 {
     int flags = 0;
 
@@ -23,6 +78,12 @@ Connection::Connection(const std::string& dbPath, const ConnectionOptions& optio
         }
     }
 
+    if (options.threadingMode == ThreadingMode::MultiThread) {
+        flags |= SQLITE_OPEN_NOMUTEX;
+    } else if (options.threadingMode == ThreadingMode::Serialized) {
+        flags |= SQLITE_OPEN_FULLMUTEX;
+    }
+
     int result = sqlite3_open_v2(dbPath.c_str(), &db_, flags, nullptr);
 
     if (result != SQLITE_OK) {
@@ -34,7 +95,13 @@ Connection::Connection(const std::string& dbPath, const ConnectionOptions& optio
         throw ConnectionException("Failed to open database '" + dbPath + "': " + error, result);
     }
 
-    applyOptions(options);
+    try {
+        applyOptions(options);
+    } catch (...) {
+        // The destructor won't run for a half-constructed object
+        close();
+        throw;
+    }
 }
 
 Connection::~Connection() {
@@ -44,6 +111,11 @@ Connection::~Connection() {
 Connection::Connection(Connection&& other) noexcept
     : db_(other.db_)
     , dbPath_(std::move(other.dbPath_))
+    , statementCache_(std::move(other.statementCache_))
+    , profiler_(std::move(other.profiler_))
+    , resultCache_(std::move(other.resultCache_))
+    , schemaCatalog_(std::move(other.schemaCatalog_))
+    , queryWatchdog_(std::move(other.queryWatchdog_))
 {
     other.db_ = nullptr;
 }
@@ -53,6 +125,11 @@ Connection& Connection::operator=(Connection&& other) noexcept {
         close();
         db_ = other.db_;
         dbPath_ = std::move(other.dbPath_);
+        statementCache_ = std::move(other.statementCache_);
+        profiler_ = std::move(other.profiler_);
+        resultCache_ = std::move(other.resultCache_);
+        schemaCatalog_ = std::move(other.schemaCatalog_);
+        queryWatchdog_ = std::move(other.queryWatchdog_);
         other.db_ = nullptr;
     }
     return *this;
@@ -76,9 +153,44 @@ void Connection::applyOptions(const ConnectionOptions& options) {
     // Set busy timeout
     sqlite3_busy_timeout(db_, options.busyTimeoutMs);
 
+    if (options.pageSize) {
+        int size = *options.pageSize;
+        if (size < 512 || size > 65536 || (size & (size - 1)) != 0) {
+            throw ConnectionException("page_size must be a power of two in [512, 65536], got " +
+                                      std::to_string(size));
+        }
+    }
+    if (options.cacheSizeKiB && *options.cacheSizeKiB <= 0) {
+        throw ConnectionException("cache_size must be a positive number of KiB, got " +
+                                  std::to_string(*options.cacheSizeKiB));
+    }
+
+    // Limits first, so the PRAGMA script below is already subject to them
+    if (options.maxSqlLength) {
+        setLimit(SqlLimit::SqlLength, *options.maxSqlLength);
+    }
+    if (options.maxVariables) {
+        setLimit(SqlLimit::VariableNumber, *options.maxVariables);
+    }
+    if (options.maxValueLength) {
+        setLimit(SqlLimit::Length, *options.maxValueLength);
+    }
+    if (options.queryTimeout) {
+        setQueryTimeout(*options.queryTimeout);
+    }
+
+    // All PRAGMAs go into one script: one sqlite3_exec() round trip. One
+    // per line, so a stray "--" can't comment out the ones after it.
+    std::string pragmas;
+
+    // page_size has to come before journal_mode: a WAL database can't change it
+    if (options.pageSize) {
+        pragmas += "PRAGMA page_size = " + std::to_string(*options.pageSize) + ";\n";
+    }
+
     // Enable foreign keys (off by default in SQLite!)
     if (options.enableForeignKeys) {
-        execute("PRAGMA foreign_keys = ON");
+        pragmas += "PRAGMA foreign_keys = ON;\n";
     }
 
     // Enable WAL mode for better concurrent access
@@ -88,12 +200,46 @@ void Connection::applyOptions(const ConnectionOptions& options) {
     // - Writers don't block readers
     // - Better crash recovery
     if (options.enableWAL) {
-        execute("PRAGMA journal_mode = WAL");
+        pragmas += "PRAGMA journal_mode = WAL;\n";
+    }
+
+    if (options.synchronous) {
+        pragmas += std::string("PRAGMA synchronous = ") + synchronousName(*options.synchronous) + ";\n";
+    }
+    if (options.cacheSizeKiB) {
+        // Negative values are KiB rather than pages
+        pragmas += "PRAGMA cache_size = -" + std::to_string(*options.cacheSizeKiB) + ";\n";
+    }
+    if (options.mmapSize) {
+        pragmas += "PRAGMA mmap_size = " + std::to_string(*options.mmapSize) + ";\n";
+    }
+    if (options.tempStore) {
+        pragmas += std::string("PRAGMA temp_store = ") + tempStoreName(*options.tempStore) + ";\n";
+    }
+    if (options.walAutoCheckpoint) {
+        pragmas += "PRAGMA wal_autocheckpoint = " + std::to_string(*options.walAutoCheckpoint) + ";\n";
+    }
+
+    if (!pragmas.empty()) {
+        execute(pragmas);
     }
 }
 
 void Connection::close() {
     if (db_) {
+        // Removes its update hook, which needs the handle still open
+        resultCache_.reset();
+
+        // Finalizing below would report to the profiler; detach it first
+        if (profiler_) {
+            sqlite3_trace_v2(db_, 0, nullptr, nullptr);
+        }
+
+        // Cached handles are idle and owned by the cache
+        if (statementCache_) {
+            statementCache_->clear();
+        }
+
         // Finalize any remaining statements
         // Note: This is a safety measure; properly written code
         // shouldn't have dangling statements
@@ -107,20 +253,46 @@ void Connection::close() {
     }
 }
 
+void Connection::enableProfiling(const ProfilingOptions& options) {
+    auto profiler = std::make_unique<QueryProfiler>(options);
+    int result = sqlite3_trace_v2(db_, profiler->traceMask(),
+                                  &QueryProfiler::traceCallback, profiler.get());
+    if (result != SQLITE_OK) {
+        throw DatabaseException("Failed to enable profiling: " + std::string(sqlite3_errstr(result)), result);
+    }
+    profiler_ = std::move(profiler);
+}
+
+void Connection::disableProfiling() {
+    if (db_) {
+        sqlite3_trace_v2(db_, 0, nullptr, nullptr);
+    }
+    profiler_.reset();
+}
+
+void Connection::enableResultCache(const ResultCacheOptions& options) {
+    resultCache_.reset();
+    resultCache_ = std::make_unique<ResultCache>(db_, options);
+}
+
+void Connection::disableResultCache() {
+    resultCache_.reset();
+}
+
 void Connection::execute(const std::string& sql) {
     char* errMsg = nullptr;
+    QueryWatchdog::Scope deadline(queryWatchdog_.get());
     int result = sqlite3_exec(db_, sql.c_str(), nullptr, nullptr, &errMsg);
 
     if (result != SQLITE_OK) {
         std::string error = errMsg ? errMsg : "Unknown error";
         sqlite3_free(errMsg);
-
-        // Check for constraint violations (base code is SQLITE_CONSTRAINT = 19)
-        // Extended codes are (19 | (N << 8)), so (result & 0xFF) == 19
-        if ((result & 0xFF) == SQLITE_CONSTRAINT) {
-            throw ConstraintException(error, result);
+        if ((result & 0xFF) == SQLITE_INTERRUPT) {
+            error = deadline.errorMessage(db_);
         }
-        throw QueryException(error, sql, result);
+
+        // Constraint violations and lock contention get their own types
+        throwQueryError(error, sql, result);
     }
 }
 
@@ -149,6 +321,119 @@ int64_t Connection::totalChanges() const {
     return sqlite3_total_changes(db_);
 }
 
+void Connection::backupTo(Connection& destination, const BackupOptions& options) {
+    Backup backup(destination, *this, options.destinationSchema, options.sourceSchema);
+    backup.run(options);
+}
+
+void Connection::backupTo(const std::string& path, const BackupOptions& options) {
+    // Rollback journal: a WAL destination rejects a different page size
+    ConnectionOptions destinationOptions;
+    destinationOptions.enableWAL = false;
+    destinationOptions.statementCacheSize = 0;
+    auto destination = Connection::open(path, destinationOptions);
+    backupTo(*destination, options);
+}
+
+void Connection::loadFrom(const std::string& path, const BackupOptions& options) {
+    ConnectionOptions sourceOptions;
+    sourceOptions.enableWAL = false;
+    sourceOptions.readOnly = true;
+    sourceOptions.createIfNotExists = false;
+    sourceOptions.statementCacheSize = 0;
+    auto source = Connection::open(path, sourceOptions);
+    Backup backup(*this, *source, options.destinationSchema, options.sourceSchema);
+    backup.run(options);
+}
+
+void Connection::vacuumInto(const std::string& path) {
+    auto stmt = prepare("VACUUM INTO ?");
+    stmt.bind(1, path);
+    stmt.execute();
+}
+
+void Connection::removeFunction(const std::string& name, int argCount) {
+    int result = sqlite3_create_function_v2(db_, name.c_str(), argCount, SQLITE_UTF8, nullptr,
+                                            nullptr, nullptr, nullptr, nullptr);
+    if (result != SQLITE_OK) {
+        throw DatabaseException("Failed to remove SQL function " + name + ": " +
+                                std::string(sqlite3_errmsg(db_)), result);
+    }
+}
+
+ConnectionMemoryStats Connection::memoryStats(bool resetCounters) const {
+    ConnectionMemoryStats stats;
+    int reset = resetCounters ? 1 : 0;
+    auto read = [&](int op, int64_t& current, int64_t* highwater = nullptr) {
+        int value = 0;
+        int high = 0;
+        sqlite3_db_status(db_, op, &value, &high, reset);
+        current = value;
+        if (highwater) {
+            *highwater = high;
+        }
+    };
+
+    read(SQLITE_DBSTATUS_CACHE_USED, stats.cacheBytes);
+    read(SQLITE_DBSTATUS_SCHEMA_USED, stats.schemaBytes);
+    read(SQLITE_DBSTATUS_STMT_USED, stats.statementBytes);
+    read(SQLITE_DBSTATUS_LOOKASIDE_USED, stats.lookasideSlots, &stats.lookasideHighwater);
+    read(SQLITE_DBSTATUS_CACHE_HIT, stats.cacheHits);
+    read(SQLITE_DBSTATUS_CACHE_MISS, stats.cacheMisses);
+    read(SQLITE_DBSTATUS_CACHE_WRITE, stats.cacheWrites);
+    read(SQLITE_DBSTATUS_CACHE_SPILL, stats.cacheSpills);
+
+    if (resultCache_) {
+        stats.resultCacheBytes = resultCache_->stats().bytes;
+    }
+    if (statementCache_) {
+        stats.cachedStatements = statementCache_->size();
+    }
+    return stats;
+}
+
+void Connection::releaseMemory() {
+    sqlite3_db_release_memory(db_);
+}
+
+int Connection::limit(SqlLimit category) const {
+    return sqlite3_limit(db_, static_cast<int>(category), -1);
+}
+
+int Connection::setLimit(SqlLimit category, int value) {
+    if (value < 0) {
+        throw DatabaseException("Limit must not be negative, got " + std::to_string(value));
+    }
+    return sqlite3_limit(db_, static_cast<int>(category), value);
+}
+
+void Connection::setQueryTimeout(std::chrono::milliseconds timeout) {
+    if (timeout.count() <= 0 && !queryWatchdog_) {
+        return;
+    }
+    enableQueryWatchdog().setTimeout(std::max(timeout, std::chrono::milliseconds(0)));
+}
+
+QueryWatchdog& Connection::enableQueryWatchdog() {
+    if (!queryWatchdog_) {
+        queryWatchdog_ = std::make_unique<QueryWatchdog>();
+        sqlite3_progress_handler(db_, QueryWatchdog::kCheckInterval,
+                                 &QueryWatchdog::progressCallback, queryWatchdog_.get());
+    }
+    return *queryWatchdog_;
+}
+
+std::shared_ptr<const SchemaCatalog> Connection::schemaCatalog() {
+    if (schemaCatalog_) {
+        auto version = prepare("PRAGMA schema_version");
+        if (version.step() && version.columnInt64(0) == schemaCatalog_->schemaVersion()) {
+            return schemaCatalog_;
+        }
+    }
+    schemaCatalog_ = std::make_shared<const SchemaCatalog>(SchemaCatalog::load(*this));
+    return schemaCatalog_;
+}
+
 bool Connection::tableExists(const std::string& tableName) {
     auto stmt = prepare(
         "SELECT 1 FROM sqlite_master WHERE type='table' AND name=?");
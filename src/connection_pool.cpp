@@ -0,0 +1,227 @@
+/**
+ * @file connection_pool.cpp
+ * @brief Implementation of ConnectionPool and PooledConnection
+ */
+
+#include "sqlite3db/connection_pool.hpp"
+#include "sqlite3db/statement.hpp"
+
+namespace sqlite3db {
+
+// ========== PooledConnection ==========
+
+PooledConnection::~PooledConnection() {
+    release();
+}
+
+PooledConnection::PooledConnection(PooledConnection&& other) noexcept
+    : pool_(other.pool_)
+    , conn_(std::move(other.conn_))
+    , writer_(other.writer_)
+{
+    other.pool_ = nullptr;
+}
+
+PooledConnection& PooledConnection::operator=(PooledConnection&& other) noexcept {
+    if (this != &other) {
+        release();
+        pool_ = other.pool_;
+        conn_ = std::move(other.conn_);
+        writer_ = other.writer_;
+        other.pool_ = nullptr;
+    }
+    return *this;
+}
+
+void PooledConnection::release() {
+    if (pool_ && conn_) {
+        pool_->release(std::move(conn_), writer_);
+    }
+    pool_ = nullptr;
+    conn_.reset();
+}
+
+// ========== ConnectionPool ==========
+
+ConnectionPool::ConnectionPool(const std::string& dbPath, const PoolOptions& options)
+    : dbPath_(dbPath)
+    , options_(options)
+{
+    if (dbPath.empty() || dbPath == ":memory:") {
+        throw ConnectionException(
+            "Connection pool requires a database file; in-memory databases are private to one connection");
+    }
+
+    // Writer first: it creates the file and switches it to WAL mode,
+    // which is persistent, so readers inherit it
+    idleWriter_ = openConnection(true);
+
+    idleReaders_.reserve(options_.readerCount);
+    for (size_t i = 0; i < options_.readerCount; ++i) {
+        idleReaders_.push_back(openConnection(false));
+    }
+}
+
+std::unique_ptr<Connection> ConnectionPool::openConnection(bool writer) const {
+    ConnectionOptions opts = options_.connectionOptions;
+    if (!writer) {
+        opts.readOnly = true;
+        opts.enableWAL = false;  // Can't change journal mode read-only
+    }
+    return Connection::open(dbPath_, opts);
+}
+
+bool ConnectionPool::isHealthy(Connection& conn) const {
+    if (!conn.isOpen()) {
+        return false;
+    }
+    try {
+        auto stmt = conn.prepare("SELECT 1");
+        return stmt.step() && stmt.columnInt(0) == 1;
+    } catch (const DatabaseException&) {
+        return false;
+    }
+}
+
+void ConnectionPool::ensureHealthy(std::unique_ptr<Connection>& conn, bool writer) const {
+    if (!conn || !isHealthy(*conn)) {
+        // Keep the broken one until the reopen succeeds: if it throws, the
+        // caller returns it to its slot and the next acquire retries
+        auto fresh = openConnection(writer);
+        conn = std::move(fresh);
+    }
+}
+
+PooledConnection ConnectionPool::acquireReader() {
+    return acquireReader(options_.acquireTimeout);
+}
+
+PooledConnection ConnectionPool::acquireReader(std::chrono::milliseconds timeout) {
+    std::unique_ptr<Connection> conn;
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        if (!readerReturned_.wait_for(lock, timeout, [this] { return !idleReaders_.empty(); })) {
+            throw ConnectionException(
+                "Timed out after " + std::to_string(timeout.count()) +
+                " ms waiting for a reader connection to '" + dbPath_ + "'",
+                SQLITE_BUSY);
+        }
+        conn = std::move(idleReaders_.back());
+        idleReaders_.pop_back();
+    }
+
+    // Health check outside the lock: it runs a query
+    if (options_.healthCheckOnAcquire) {
+        try {
+            ensureHealthy(conn, false);
+        } catch (...) {
+            release(std::move(conn), false);
+            throw;
+        }
+    }
+    return PooledConnection(this, std::move(conn), false);
+}
+
+PooledConnection ConnectionPool::acquireWriter() {
+    return acquireWriter(options_.acquireTimeout);
+}
+
+PooledConnection ConnectionPool::acquireWriter(std::chrono::milliseconds timeout) {
+    std::unique_ptr<Connection> conn;
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        if (!writerReturned_.wait_for(lock, timeout, [this] { return idleWriter_ != nullptr; })) {
+            throw ConnectionException(
+                "Timed out after " + std::to_string(timeout.count()) +
+                " ms waiting for the writer connection to '" + dbPath_ + "'",
+                SQLITE_BUSY);
+        }
+        conn = std::move(idleWriter_);
+    }
+
+    if (options_.healthCheckOnAcquire) {
+        try {
+            ensureHealthy(conn, true);
+        } catch (...) {
+            release(std::move(conn), true);
+            throw;
+        }
+    }
+    return PooledConnection(this, std::move(conn), true);
+}
+
+void ConnectionPool::release(std::unique_ptr<Connection> conn, bool writer) noexcept {
+    // Never hand out a connection with a transaction left open by the
+    // previous borrower: it would hold locks and leak its changes
+    if (conn && conn->isOpen() && sqlite3_get_autocommit(conn->handle()) == 0) {
+        try {
+            conn->execute("ROLLBACK");
+        } catch (...) {
+            // Leave it to the next health check to reopen it
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (writer) {
+            idleWriter_ = std::move(conn);
+        } else {
+            idleReaders_.push_back(std::move(conn));
+        }
+    }
+
+    if (writer) {
+        writerReturned_.notify_one();
+    } else {
+        readerReturned_.notify_one();
+    }
+}
+
+size_t ConnectionPool::checkHealth() {
+    // Take the idle connections out so the checks run without the lock
+    std::vector<std::unique_ptr<Connection>> readers;
+    std::unique_ptr<Connection> writer;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        readers.swap(idleReaders_);
+        writer = std::move(idleWriter_);
+    }
+
+    size_t replaced = 0;
+    auto check = [&](std::unique_ptr<Connection>& conn, bool isWriter) {
+        if (conn && !isHealthy(*conn)) {
+            try {
+                conn = openConnection(isWriter);
+                ++replaced;
+            } catch (const DatabaseException&) {
+                // Keep the broken one; acquire will retry the reopen
+            }
+        }
+    };
+
+    for (auto& reader : readers) {
+        check(reader, false);
+    }
+    bool hadWriter = writer != nullptr;
+    check(writer, true);
+
+    for (auto& reader : readers) {
+        release(std::move(reader), false);
+    }
+    if (hadWriter) {
+        release(std::move(writer), true);
+    }
+    return replaced;
+}
+
+size_t ConnectionPool::idleReaders() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return idleReaders_.size();
+}
+
+bool ConnectionPool::writerIdle() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return idleWriter_ != nullptr;
+}
+
+} // namespace sqlite3db
@@ -0,0 +1,57 @@
+/**
+ * @file cursor.cpp
+ * @brief Implementation of Row and Cursor
+ */
+
+#include "sqlite3db/cursor.hpp"
+
+namespace sqlite3db {
+
+// ========== Row ==========
+
+std::vector<Value> Row::values() const {
+    int count = columnCount();
+    std::vector<Value> result;
+    result.reserve(static_cast<size_t>(count));
+    for (int i = 0; i < count; ++i) {
+        result.push_back(stmt_->columnValue(i));
+    }
+    return result;
+}
+
+// ========== Cursor ==========
+
+Cursor::Cursor(Statement stmt)
+    : stmt_(std::move(stmt))
+    , row_(stmt_)
+{}
+
+Cursor::Cursor(Cursor&& other) noexcept
+    : stmt_(std::move(other.stmt_))
+    , row_(stmt_)
+    , started_(other.started_)
+    , done_(other.done_)
+{
+    other.done_ = true;
+}
+
+Cursor::Iterator Cursor::begin() {
+    if (started_) {
+        throw QueryException("Cursor is single-pass; begin() was already called", stmt_.sql());
+    }
+    return advance() ? Iterator(this) : Iterator();
+}
+
+bool Cursor::advance() {
+    started_ = true;
+    if (done_) {
+        return false;
+    }
+    if (!stmt_.step()) {
+        done_ = true;
+        return false;
+    }
+    return true;
+}
+
+} // namespace sqlite3db
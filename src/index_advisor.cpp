@@ -0,0 +1,660 @@
+/**
+ * @file index_advisor.cpp
+ * @brief Implementation of IndexAdvisor
+ */
+
+#include "sqlite3db/index_advisor.hpp"
+#include <algorithm>
+#include <cctype>
+#include <set>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include "sqlite3db/schema_catalog.hpp"
+
+namespace sqlite3db {
+
+namespace {
+
+const char* const kCandidateIndex = "sqlite3db_advisor_candidate";
+
+std::string lowercase(std::string_view text) {
+    std::string result(text);
+    std::transform(result.begin(), result.end(), result.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return result;
+}
+
+bool startsWith(std::string_view text, std::string_view prefix) {
+    return text.substr(0, prefix.size()) == prefix;
+}
+
+// Quoted column list: names may be keywords such as "order"
+std::string columnList(const std::vector<std::string>& columns) {
+    std::string result;
+    for (size_t i = 0; i < columns.size(); ++i) {
+        if (i > 0) {
+            result += ", ";
+        }
+        result += quoteIdentifier(columns[i]);
+    }
+    return result;
+}
+
+// ---- SQL tokens ----
+
+/**
+ * Just enough of a tokenizer to find table aliases and compared
+ * columns: identifiers and keywords (lowercased, quotes removed),
+ * operators, and placeholders for literals and parameters.
+ */
+struct Token {
+    std::string text;
+    bool identifier = false;
+};
+
+bool isIdentifierChar(unsigned char c) {
+    return std::isalnum(c) || c == '_' || c == '$' || c >= 0x80;
+}
+
+std::vector<Token> tokenize(std::string_view sql) {
+    std::vector<Token> tokens;
+    size_t i = 0;
+    while (i < sql.size()) {
+        auto c = static_cast<unsigned char>(sql[i]);
+        if (std::isspace(c)) {
+            ++i;
+        } else if (startsWith(sql.substr(i), "--")) {
+            size_t end = sql.find('\n', i);
+            i = end == std::string_view::npos ? sql.size() : end + 1;
+        } else if (startsWith(sql.substr(i), "/*")) {
+            size_t end = sql.find("*/", i + 2);
+            i = end == std::string_view::npos ? sql.size() : end + 2;
+        } else if (c == '\'') {
+            // String literal; '' is an escaped quote
+            for (++i; i < sql.size(); ++i) {
+                if (sql[i] == '\'') {
+                    if (i + 1 < sql.size() && sql[i + 1] == '\'') {
+                        ++i;
+                    } else {
+                        ++i;
+                        break;
+                    }
+                }
+            }
+            tokens.push_back({"'", false});
+        } else if (c == '"' || c == '`' || c == '[') {
+            char close = c == '[' ? ']' : static_cast<char>(c);
+            std::string name;
+            for (++i; i < sql.size(); ++i) {
+                if (sql[i] == close) {
+                    if (close != ']' && i + 1 < sql.size() && sql[i + 1] == close) {
+                        name += close;
+                        ++i;
+                    } else {
+                        ++i;
+                        break;
+                    }
+                } else {
+                    name += sql[i];
+                }
+            }
+            tokens.push_back({lowercase(name), true});
+        } else if (std::isdigit(c)) {
+            while (i < sql.size() && (isIdentifierChar(static_cast<unsigned char>(sql[i])) || sql[i] == '.')) {
+                ++i;
+            }
+            tokens.push_back({"0", false});
+        } else if (isIdentifierChar(c)) {
+            size_t start = i;
+            while (i < sql.size() && isIdentifierChar(static_cast<unsigned char>(sql[i]))) {
+                ++i;
+            }
+            tokens.push_back({lowercase(sql.substr(start, i - start)), true});
+        } else if (c == '?' || c == ':' || c == '@') {
+            for (++i; i < sql.size() && isIdentifierChar(static_cast<unsigned char>(sql[i])); ++i) {}
+            tokens.push_back({"?", false});
+        } else {
+            static const char* const kTwoCharOps[] = {"<=", ">=", "==", "!=", "<>", "||"};
+            size_t width = 1;
+            for (const char* op : kTwoCharOps) {
+                if (startsWith(sql.substr(i), op)) {
+                    width = 2;
+                    break;
+                }
+            }
+            tokens.push_back({std::string(sql.substr(i, width)), false});
+            i += width;
+        }
+    }
+    return tokens;
+}
+
+bool isClauseKeyword(const std::string& word) {
+    static const std::unordered_set<std::string> kKeywords = {
+        "as", "where", "join", "inner", "left", "right", "full", "outer", "cross", "natural",
+        "on", "using", "order", "group", "having", "limit", "offset", "union", "except",
+        "intersect", "window", "set", "indexed", "not", "values", "default", "returning"};
+    return kKeywords.count(word) > 0;
+}
+
+// ---- Which columns of which tables the SQL compares or sorts by ----
+
+struct ColumnUse {
+    std::vector<std::string> equality;
+    std::vector<std::string> range;
+    std::vector<std::string> ordering;
+};
+
+void addUnique(std::vector<std::string>& list, const std::string& value) {
+    if (std::find(list.begin(), list.end(), value) == list.end()) {
+        list.push_back(value);
+    }
+}
+
+struct SqlShape {
+    // Lowercase table name or alias -> catalog table name
+    std::unordered_map<std::string, std::string> names;
+    // In order of first mention
+    std::vector<std::pair<std::string, ColumnUse>> uses;
+
+    ColumnUse& use(const std::string& table) {
+        for (auto& entry : uses) {
+            if (entry.first == table) {
+                return entry.second;
+            }
+        }
+        uses.emplace_back(table, ColumnUse{});
+        return uses.back().second;
+    }
+
+    std::string resolve(const std::string& name) const {
+        auto it = names.find(lowercase(name));
+        return it == names.end() ? name : it->second;
+    }
+};
+
+SqlShape shapeOf(const std::string& sql, const SchemaCatalog& catalog) {
+    static const std::unordered_set<std::string> kTableIntroducers = {
+        "from", "join", ",", "update", "into"};
+    static const std::unordered_set<std::string> kEquality = {"=", "==", "is", "in"};
+    static const std::unordered_set<std::string> kRange = {"<", ">", "<=", ">=", "between"};
+    static const std::unordered_set<std::string> kOrderingEnd = {
+        "limit", "offset", "having", "window", "union", "except", "intersect", ")", ";"};
+
+    std::vector<Token> tokens = tokenize(sql);
+    auto text = [&](size_t i) -> const std::string& {
+        static const std::string kEmpty;
+        return i < tokens.size() ? tokens[i].text : kEmpty;
+    };
+
+    SqlShape shape;
+    for (size_t i = 0; i < tokens.size(); ++i) {
+        if (!tokens[i].identifier || i == 0 || !kTableIntroducers.count(text(i - 1))) {
+            continue;
+        }
+        const TableInfo* table = catalog.table(tokens[i].text);
+        if (!table || table->isView) {
+            continue;
+        }
+        shape.names[tokens[i].text] = table->name;
+        size_t next = i + 1;
+        if (text(next) == "as") {
+            ++next;
+        }
+        if (next < tokens.size() && tokens[next].identifier && !isClauseKeyword(tokens[next].text)) {
+            shape.names[tokens[next].text] = table->name;
+        }
+    }
+
+    std::vector<const TableInfo*> tables;
+    for (const auto& entry : shape.names) {
+        const TableInfo* table = catalog.table(entry.second);
+        if (std::find(tables.begin(), tables.end(), table) == tables.end()) {
+            tables.push_back(table);
+        }
+    }
+
+    bool ordering = false;
+    for (size_t i = 0; i < tokens.size(); ++i) {
+        const std::string& word = tokens[i].text;
+        if ((word == "order" || word == "group") && text(i + 1) == "by") {
+            ordering = true;
+            ++i;
+            continue;
+        }
+        if (ordering && kOrderingEnd.count(word)) {
+            ordering = false;
+        }
+        if (!tokens[i].identifier) {
+            continue;
+        }
+
+        std::string qualifier;
+        std::string column = word;
+        size_t end = i + 1;
+        if (text(i + 1) == "." && i + 2 < tokens.size() && tokens[i + 2].identifier) {
+            qualifier = word;
+            column = tokens[i + 2].text;
+            end = i + 3;
+        }
+
+        std::vector<std::string> ColumnUse::* kind = nullptr;
+        if (ordering) {
+            kind = &ColumnUse::ordering;
+        } else if (kEquality.count(text(end))) {
+            kind = &ColumnUse::equality;
+        } else if (kRange.count(text(end))) {
+            kind = &ColumnUse::range;
+        } else if (i > 0 && (text(i - 1) == "=" || text(i - 1) == "==")) {
+            kind = &ColumnUse::equality;
+        } else if (i > 0 && kRange.count(text(i - 1))) {
+            kind = &ColumnUse::range;
+        }
+
+        if (kind) {
+            for (const TableInfo* table : tables) {
+                if (!qualifier.empty() && shape.resolve(qualifier) != table->name) {
+                    continue;
+                }
+                if (const ColumnInfo* info = table->column(column)) {
+                    addUnique(shape.use(table->name).*kind, info->name);
+                }
+            }
+        }
+        i = end - 1;
+    }
+    return shape;
+}
+
+// ---- Reading plan steps ----
+
+// "SEARCH o USING INDEX i (a=?)" -> "o"; empty for non-table steps
+std::string planTable(const std::string& detail) {
+    std::string_view rest(detail);
+    if (startsWith(rest, "SCAN ")) {
+        rest.remove_prefix(5);
+    } else if (startsWith(rest, "SEARCH ")) {
+        rest.remove_prefix(7);
+    } else {
+        return {};
+    }
+    // Before SQLite 3.36: "SCAN TABLE t"
+    if (startsWith(rest, "TABLE ")) {
+        rest.remove_prefix(6);
+    }
+    std::string_view name = rest.substr(0, rest.find(' '));
+    if (name.empty() || name.front() == '(' || name == "CONSTANT") {
+        return {};
+    }
+    return std::string(name);
+}
+
+// Distinct columns in the "(a=? AND b>?)" constraint of a SEARCH step
+size_t constrainedColumns(const std::string& detail) {
+    if (!startsWith(detail, "SEARCH ") || detail.find("AUTOMATIC") != std::string::npos ||
+        detail.empty() || detail.back() != ')') {
+        return 0;
+    }
+    size_t open = detail.rfind(" (");
+    if (open == std::string::npos) {
+        return 0;
+    }
+    std::string_view terms(detail);
+    terms = terms.substr(open + 2, terms.size() - open - 3);
+
+    std::set<std::string> columns;
+    while (!terms.empty()) {
+        size_t split = terms.find(" AND ");
+        std::string_view term = terms.substr(0, split);
+        columns.insert(lowercase(term.substr(0, term.find_first_of("=<>! "))));
+        terms = split == std::string_view::npos ? std::string_view() : terms.substr(split + 5);
+    }
+    return columns.size();
+}
+
+std::string planIndex(const std::string& detail) {
+    for (const char* marker : {"USING INDEX ", "USING COVERING INDEX "}) {
+        size_t at = detail.find(marker);
+        if (at != std::string::npos) {
+            size_t start = at + std::char_traits<char>::length(marker);
+            return detail.substr(start, detail.find(' ', start) - start);
+        }
+    }
+    return {};
+}
+
+std::vector<PlanStep> explain(Connection& conn, const std::string& sql) {
+    auto stmt = conn.prepare("EXPLAIN QUERY PLAN " + sql);
+    std::vector<PlanStep> plan;
+    while (stmt.step()) {
+        plan.push_back({stmt.columnInt(0), stmt.columnInt(1), stmt.columnString(3)});
+    }
+    return plan;
+}
+
+// How much an index helps: more constrained columns, then fewer sorts
+struct PlanScore {
+    size_t constrained = 0;
+    size_t sorts = 0;
+    bool usesCandidate = false;
+
+    bool betterThan(const PlanScore& other) const {
+        if (constrained != other.constrained) {
+            return constrained > other.constrained;
+        }
+        return sorts < other.sorts;
+    }
+};
+
+PlanScore score(const std::vector<PlanStep>& plan) {
+    PlanScore result;
+    for (const auto& step : plan) {
+        if (startsWith(step.detail, "USE TEMP B-TREE")) {
+            ++result.sorts;
+        }
+        result.constrained += constrainedColumns(step.detail);
+        if (planIndex(step.detail) == kCandidateIndex) {
+            result.usesCandidate = true;
+        }
+    }
+    return result;
+}
+
+std::vector<std::vector<std::string>> candidatesFor(const ColumnUse& use) {
+    constexpr size_t kMaxColumns = 6;
+    std::vector<std::vector<std::string>> candidates;
+    auto add = [&](const std::vector<std::string>& head, const std::vector<std::string>& tail) {
+        std::vector<std::string> columns;
+        for (const auto* part : {&head, &tail}) {
+            for (const auto& column : *part) {
+                if (columns.size() < kMaxColumns) {
+                    addUnique(columns, column);
+                }
+            }
+        }
+        if (!columns.empty() && std::find(candidates.begin(), candidates.end(), columns) == candidates.end()) {
+            candidates.push_back(std::move(columns));
+        }
+    };
+
+    add(use.equality, {});
+    if (!use.range.empty()) {
+        add(use.equality, {use.range.front()});
+    }
+    if (!use.ordering.empty()) {
+        add(use.equality, use.ordering);
+    }
+    for (const auto* list : {&use.equality, &use.range, &use.ordering}) {
+        for (const auto& column : *list) {
+            add({column}, {});
+        }
+    }
+    return candidates;
+}
+
+} // namespace
+
+// ---- IndexSuggestion / QueryAnalysis ----
+
+std::string IndexSuggestion::name() const {
+    std::string result = "idx_" + table;
+    for (const auto& column : columns) {
+        result += "_" + column;
+    }
+    for (char& c : result) {
+        if (!std::isalnum(static_cast<unsigned char>(c))) {
+            c = '_';
+        }
+    }
+    return result;
+}
+
+std::string IndexSuggestion::createSql() const {
+    return "CREATE INDEX IF NOT EXISTS " + name() + " ON " + quoteIdentifier(table) +
+           " (" + columnList(columns) + ")";
+}
+
+std::string IndexSuggestion::dropSql() const {
+    return "DROP INDEX IF EXISTS " + name();
+}
+
+std::string QueryAnalysis::planText() const {
+    std::unordered_map<int, size_t> depth;
+    std::string result;
+    for (const auto& step : plan) {
+        auto parent = depth.find(step.parent);
+        size_t level = parent == depth.end() ? 0 : parent->second + 1;
+        depth[step.id] = level;
+        result += std::string(level * 2, ' ') + step.detail + "\n";
+    }
+    return result;
+}
+
+// ---- IndexAdvisor ----
+
+// Empty in-memory copy of the schema for trying candidate indexes
+struct IndexAdvisor::Scratch {
+    std::unique_ptr<Connection> conn;
+    int64_t schemaVersion = -1;
+};
+
+IndexAdvisor::IndexAdvisor(Connection& conn)
+    : conn_(conn)
+{}
+
+IndexAdvisor::~IndexAdvisor() = default;
+
+IndexAdvisor::Scratch& IndexAdvisor::scratch(const SchemaCatalog& catalog) {
+    if (scratch_ && scratch_->schemaVersion == catalog.schemaVersion()) {
+        return *scratch_;
+    }
+
+    ConnectionOptions options;
+    options.enableWAL = false;
+    options.enableForeignKeys = false;
+    auto copy = std::make_unique<Scratch>();
+    copy->conn = Connection::inMemory(options);
+    copy->schemaVersion = catalog.schemaVersion();
+
+    auto schema = conn_.prepare(
+        "SELECT sql FROM sqlite_master "
+        "WHERE sql IS NOT NULL AND type IN ('table', 'index', 'view') AND name NOT LIKE 'sqlite_%' "
+        "ORDER BY CASE type WHEN 'table' THEN 0 WHEN 'index' THEN 1 ELSE 2 END, rowid");
+    while (schema.step()) {
+        std::string sql = schema.columnString(0);
+        if (startsWith(lowercase(sql), "create virtual")) {
+            continue;  // The module may not be loaded here
+        }
+        try {
+            copy->conn->execute(sql);
+        } catch (const DatabaseException&) {
+            // Best effort: queries on what's missing get no suggestions
+        }
+    }
+
+    scratch_ = std::move(copy);
+    return *scratch_;
+}
+
+QueryAnalysis IndexAdvisor::analyze(const QueryBuilder& query) {
+    return analyze(query.toSql());
+}
+
+QueryAnalysis IndexAdvisor::analyze(const std::string& sql) {
+    QueryAnalysis analysis;
+    analysis.sql = sql;
+    analysis.plan = explain(conn_, sql);
+
+    std::shared_ptr<const SchemaCatalog> catalog = conn_.schemaCatalog();
+    SqlShape shape = shapeOf(sql, *catalog);
+
+    std::vector<std::string> flaggedTables;
+    for (const auto& step : analysis.plan) {
+        if (startsWith(step.detail, "USE TEMP B-TREE")) {
+            analysis.issues.push_back({PlanIssueKind::TempBTree, "", step.detail});
+            continue;
+        }
+        std::string index = planIndex(step.detail);
+        if (!index.empty()) {
+            addUnique(analysis.indexesUsed, index);
+        }
+        std::string name = planTable(step.detail);
+        if (name.empty()) {
+            continue;
+        }
+        std::string table = shape.resolve(name);
+        if (step.detail.find("AUTOMATIC") != std::string::npos) {
+            analysis.issues.push_back({PlanIssueKind::AutomaticIndex, table, step.detail});
+            addUnique(flaggedTables, table);
+        } else if (startsWith(step.detail, "SCAN ")) {
+            analysis.issues.push_back({PlanIssueKind::FullScan, table, step.detail});
+            addUnique(flaggedTables, table);
+        }
+    }
+
+    if (!analysis.issues.empty()) {
+        // Flagged tables first, then any other (an index may save a sort)
+        std::vector<std::string> order = flaggedTables;
+        for (const auto& entry : shape.uses) {
+            addUnique(order, entry.first);
+        }
+
+        Scratch& copy = scratch(*catalog);
+        Connection& db = *copy.conn;
+        try {
+            // Adopted suggestions stay in the copy so later tables are
+            // judged with them in place
+            PlanScore base = score(explain(db, sql));
+            for (const auto& table : order) {
+                auto use = std::find_if(shape.uses.begin(), shape.uses.end(),
+                                        [&](const auto& entry) { return entry.first == table; });
+                if (use == shape.uses.end()) {
+                    continue;
+                }
+
+                const std::vector<std::string>* best = nullptr;
+                PlanScore bestScore;
+                auto candidates = candidatesFor(use->second);
+                for (const auto& columns : candidates) {
+                    db.execute("CREATE INDEX " + std::string(kCandidateIndex) + " ON " +
+                               quoteIdentifier(table) + " (" + columnList(columns) + ")");
+                    PlanScore tried = score(explain(db, sql));
+                    db.execute("DROP INDEX " + std::string(kCandidateIndex));
+
+                    if (!tried.usesCandidate || !tried.betterThan(base)) {
+                        continue;
+                    }
+                    if (!best || tried.betterThan(bestScore) ||
+                        (!bestScore.betterThan(tried) && columns.size() < best->size())) {
+                        best = &columns;
+                        bestScore = tried;
+                    }
+                }
+
+                if (best) {
+                    IndexSuggestion suggestion{table, *best};
+                    db.execute(suggestion.createSql());
+                    analysis.suggestions.push_back(std::move(suggestion));
+                    base = bestScore;
+                }
+            }
+        } catch (const DatabaseException&) {
+            // E.g. the query calls a function only the real connection
+            // has; a candidate index may be left behind
+            copy.schemaVersion = -1;
+        }
+        if (!analysis.suggestions.empty()) {
+            copy.schemaVersion = -1;  // Rebuild without the adopted indexes
+        }
+    }
+
+    history_.push_back(analysis);
+    return analysis;
+}
+
+std::vector<QueryAnalysis> IndexAdvisor::analyzeProfile(const QueryProfiler& profiler,
+                                                        size_t maxStatements) {
+    std::vector<QueryAnalysis> results;
+    for (const QueryStats& stats : profiler.snapshot()) {
+        if (results.size() >= maxStatements) {
+            break;
+        }
+        if (stats.fullScanSteps == 0 && stats.sorts == 0 && stats.autoIndexes == 0) {
+            continue;
+        }
+        if (stats.sql == "<other>" || startsWith(lowercase(stats.sql), "explain")) {
+            continue;
+        }
+        try {
+            results.push_back(analyze(stats.sql));
+        } catch (const QueryException&) {
+            // No longer compiles
+        }
+    }
+    return results;
+}
+
+std::vector<IndexSuggestion> IndexAdvisor::suggestions() const {
+    // An index also serves every query a prefix of its columns would
+    auto covers = [](const IndexSuggestion& wide, const IndexSuggestion& narrow) {
+        return lowercase(wide.table) == lowercase(narrow.table) &&
+               wide.columns.size() >= narrow.columns.size() &&
+               std::equal(narrow.columns.begin(), narrow.columns.end(), wide.columns.begin());
+    };
+
+    std::vector<IndexSuggestion> result;
+    for (const auto& analysis : history_) {
+        for (const auto& suggestion : analysis.suggestions) {
+            bool covered = std::any_of(result.begin(), result.end(), [&](const IndexSuggestion& kept) {
+                return covers(kept, suggestion);
+            });
+            if (covered) {
+                continue;
+            }
+            result.erase(std::remove_if(result.begin(), result.end(), [&](const IndexSuggestion& kept) {
+                return covers(suggestion, kept);
+            }), result.end());
+            result.push_back(suggestion);
+        }
+    }
+    return result;
+}
+
+std::vector<SchemaValidator::ValidationError> IndexAdvisor::checkRequiredIndexes(
+    const SchemaValidator& validator) const {
+    std::unordered_set<std::string> used;
+    for (const auto& analysis : history_) {
+        for (const auto& index : analysis.indexesUsed) {
+            used.insert(lowercase(index));
+        }
+    }
+
+    std::vector<SchemaValidator::ValidationError> errors;
+    for (const auto& [table, index] : validator.requiredIndexes()) {
+        if (!used.count(lowercase(index))) {
+            errors.push_back({
+                "unused_index",
+                "Index " + index + " on " + table + " is not used by any analyzed query"
+            });
+        }
+    }
+    return errors;
+}
+
+Migration IndexAdvisor::toMigration(int version, const std::string& description) const {
+    std::vector<IndexSuggestion> indexes = suggestions();
+    return Migration(version, description,
+        [indexes](Connection& db) {
+            for (const auto& index : indexes) {
+                db.execute(index.createSql());
+            }
+        },
+        [indexes](Connection& db) {
+            for (auto it = indexes.rbegin(); it != indexes.rend(); ++it) {
+                db.execute(it->dropSql());
+            }
+        });
+}
+
+} // namespace sqlite3db
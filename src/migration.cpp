@@ -45,9 +45,38 @@ void MigrationManager::ensureMigrationTable(Connection& conn) const {
     )");
 }
 
-int MigrationManager::currentVersion(Connection& conn) const {
-    ensureMigrationTable(conn);
+void MigrationManager::setBaseline(int version, std::string schemaSql) {
+    if (version <= 0) {
+        throw MigrationException("Baseline version must be positive", version);
+    }
+    baselineVersion_ = version;
+    baselineSql_ = std::move(schemaSql);
+}
+
+MigrationManager& MigrationManager::setSingleTransaction(bool enable) {
+    singleTransaction_ = enable;
+    return *this;
+}
+
+std::string MigrationManager::snapshotSchema(Connection& conn) {
+    auto stmt = conn.prepare(R"(
+        SELECT sql FROM sqlite_master
+        WHERE sql IS NOT NULL
+          AND name NOT LIKE 'sqlite\_%' ESCAPE '\'
+          AND tbl_name <> '__migrations'
+        ORDER BY CASE type WHEN 'table' THEN 0 WHEN 'index' THEN 1 WHEN 'view' THEN 2 ELSE 3 END,
+                 rowid
+    )");
 
+    std::string script;
+    while (stmt.step()) {
+        script += stmt.columnStringView(0);
+        script += ";\n";
+    }
+    return script;
+}
+
+int MigrationManager::readVersion(Connection& conn) const {
     auto stmt = conn.prepare("SELECT MAX(version) FROM __migrations");
     if (stmt.step()) {
         if (stmt.isNull(0)) {
@@ -58,6 +87,30 @@ int MigrationManager::currentVersion(Connection& conn) const {
     return 0;
 }
 
+int MigrationManager::currentVersion(Connection& conn) const {
+    ensureMigrationTable(conn);
+    return readVersion(conn);
+}
+
+bool MigrationManager::isEmptyDatabase(Connection& conn) const {
+    auto stmt = conn.prepare(R"(
+        SELECT 1 FROM sqlite_master
+        WHERE name NOT LIKE 'sqlite\_%' ESCAPE '\' AND tbl_name <> '__migrations'
+        LIMIT 1
+    )");
+    return !stmt.step();
+}
+
+std::vector<int> MigrationManager::versionsBetween(int current, int targetVersion) const {
+    // std::map iterates in version order
+    std::vector<int> versions;
+    for (auto it = migrations_.upper_bound(current);
+         it != migrations_.end() && it->first <= targetVersion; ++it) {
+        versions.push_back(it->first);
+    }
+    return versions;
+}
+
 int MigrationManager::latestVersion() const {
     if (migrations_.empty()) {
         return 0;
@@ -82,11 +135,20 @@ bool MigrationManager::isUpToDate(Connection& conn) const {
     return currentVersion(conn) >= latestVersion();
 }
 
-void MigrationManager::recordMigration(Connection& conn, int version) const {
-    auto& migration = migrations_.at(version);
+void MigrationManager::recordMigrations(Connection& conn, const std::vector<int>& versions) const {
+    if (versions.empty()) {
+        return;
+    }
+    // One statement for the whole batch: bind + step per version
     auto stmt = conn.prepare(
         "INSERT INTO __migrations (version, description) VALUES (?, ?)");
-    stmt.bind(1, version).bind(2, migration.description).execute();
+    for (int version : versions) {
+        ScopedReset guard(stmt);
+        auto it = migrations_.find(version);
+        stmt.bind(1, version)
+            .bind(2, it != migrations_.end() ? it->second.description : std::string("Baseline schema"))
+            .execute();
+    }
 }
 
 void MigrationManager::removeMigrationRecord(Connection& conn, int version) const {
@@ -98,41 +160,99 @@ void MigrationManager::apply(Connection& conn) {
     applyTo(conn, latestVersion());
 }
 
-void MigrationManager::applyTo(Connection& conn, int targetVersion) {
-    ensureMigrationTable(conn);
+void MigrationManager::runMigration(Connection& conn, int version) const {
+    const auto& migration = migrations_.at(version);
+
+    // Each migration runs in its own transaction
+    // This allows partial progress if one fails
+    Transaction txn(conn);
+
+    try {
+        migration.up(conn);
+        recordMigrations(conn, {version});
+        txn.commit();
+    } catch (const std::exception& e) {
+        // Transaction auto-rolls back
+        throw MigrationException(
+            "Migration failed: " + std::string(e.what()),
+            version
+        );
+    }
+}
 
-    int current = currentVersion(conn);
+void MigrationManager::applyBaseline(Connection& conn) const {
+    conn.execute(baselineSql_);
 
-    // Get migrations to apply
-    std::vector<int> toApply;
-    for (const auto& [version, _] : migrations_) {
-        if (version > current && version <= targetVersion) {
-            toApply.push_back(version);
-        }
+    // Registered migrations up to the baseline count as applied, and the
+    // baseline itself is recorded even when it has no migration of its own
+    std::vector<int> versions = versionsBetween(0, baselineVersion_);
+    if (versions.empty() || versions.back() != baselineVersion_) {
+        versions.push_back(baselineVersion_);
     }
+    recordMigrations(conn, versions);
+}
 
-    // Sort to ensure order
-    std::sort(toApply.begin(), toApply.end());
+void MigrationManager::applyTo(Connection& conn, int targetVersion) {
+    ensureMigrationTable(conn);
 
-    // Apply each migration in a transaction
-    for (int version : toApply) {
-        const auto& migration = migrations_.at(version);
+    int current = readVersion(conn);
+    bool wantBaseline = baselineVersion_ > 0 && current == 0 && targetVersion >= baselineVersion_;
 
-        // Each migration runs in its own transaction
-        // This allows partial progress if one fails
-        Transaction txn(conn);
+    // Up to date: one CREATE IF NOT EXISTS and one MAX() read, nothing else
+    if (!wantBaseline && versionsBetween(current, targetVersion).empty()) {
+        return;
+    }
 
+    if (singleTransaction_) {
+        Transaction txn(conn, TransactionType::Immediate);
+        int version = 0;
         try {
-            migration.up(conn);
-            recordMigration(conn, version);
+            // Another process may have migrated while we waited for the lock
+            current = readVersion(conn);
+            if (wantBaseline && current == 0 && isEmptyDatabase(conn)) {
+                version = baselineVersion_;
+                applyBaseline(conn);
+                current = baselineVersion_;
+            }
+
+            std::vector<int> toApply = versionsBetween(current, targetVersion);
+            for (int v : toApply) {
+                version = v;
+                migrations_.at(v).up(conn);
+            }
+            recordMigrations(conn, toApply);
             txn.commit();
         } catch (const std::exception& e) {
-            // Transaction auto-rolls back
+            // Transaction auto-rolls back: no migration of the group is kept
             throw MigrationException(
                 "Migration failed: " + std::string(e.what()),
                 version
             );
         }
+        return;
+    }
+
+    if (wantBaseline && isEmptyDatabase(conn)) {
+        Transaction txn(conn, TransactionType::Immediate);
+        try {
+            // Another process cold-starting on the same file may have
+            // applied the baseline while we waited for the lock
+            current = readVersion(conn);
+            if (current == 0 && isEmptyDatabase(conn)) {
+                applyBaseline(conn);
+                current = baselineVersion_;
+            }
+            txn.commit();
+        } catch (const std::exception& e) {
+            throw MigrationException(
+                "Baseline failed: " + std::string(e.what()),
+                baselineVersion_
+            );
+        }
+    }
+
+    for (int version : versionsBetween(current, targetVersion)) {
+        runMigration(conn, version);
     }
 }
 
@@ -212,15 +332,26 @@ SchemaValidator& SchemaValidator::requireIndex(const std::string& tableName,
     return *this;
 }
 
+std::vector<std::pair<std::string, std::string>> SchemaValidator::requiredIndexes() const {
+    std::vector<std::pair<std::string, std::string>> result;
+    result.reserve(indexRequirements_.size());
+    for (const auto& req : indexRequirements_) {
+        result.emplace_back(req.tableName, req.indexName);
+    }
+    return result;
+}
+
 std::vector<SchemaValidator::ValidationError> SchemaValidator::validate(Connection& conn) const {
+    return validate(*conn.schemaCatalog());
+}
+
+std::vector<SchemaValidator::ValidationError> SchemaValidator::validate(const SchemaCatalog& catalog) const {
     std::vector<ValidationError> errors;
 
     // Check tables
     for (const auto& req : tableRequirements_) {
-        auto stmt = conn.prepare(
-            "SELECT 1 FROM sqlite_master WHERE type='table' AND name=?");
-        stmt.bind(1, req.name);
-        if (!stmt.step()) {
+        const TableInfo* table = catalog.table(req.name);
+        if (!table || table->isView) {
             errors.push_back({
                 "missing_table",
                 "Required table '" + req.name + "' does not exist"
@@ -230,64 +361,49 @@ std::vector<SchemaValidator::ValidationError> SchemaValidator::validate(Connecti
 
     // Check columns
     for (const auto& req : columnRequirements_) {
-        // Use PRAGMA table_info to get column information
-        auto stmt = conn.prepare("PRAGMA table_info(" + req.tableName + ")");
-
-        bool found = false;
-        while (stmt.step()) {
-            std::string colName = stmt.columnString(1);
-            if (colName == req.columnName) {
-                found = true;
-
-                // Check type if specified
-                if (!req.expectedType.empty()) {
-                    std::string colType = stmt.columnString(2);
-                    // SQLite types are case-insensitive
-                    std::string upperExpected = req.expectedType;
-                    std::string upperActual = colType;
-                    for (char& c : upperExpected) c = std::toupper(c);
-                    for (char& c : upperActual) c = std::toupper(c);
-
-                    if (upperActual.find(upperExpected) == std::string::npos) {
-                        errors.push_back({
-                            "wrong_type",
-                            "Column '" + req.tableName + "." + req.columnName +
-                            "' has type '" + colType + "', expected '" + req.expectedType + "'"
-                        });
-                    }
-                }
-
-                // Check NOT NULL if required
-                if (req.requireNotNull) {
-                    int notNull = stmt.columnInt(3);
-                    if (!notNull) {
-                        errors.push_back({
-                            "nullable",
-                            "Column '" + req.tableName + "." + req.columnName +
-                            "' should be NOT NULL"
-                        });
-                    }
-                }
-
-                break;
-            }
-        }
+        const TableInfo* table = catalog.table(req.tableName);
+        const ColumnInfo* col = table ? table->column(req.columnName) : nullptr;
 
-        if (!found) {
+        if (!col) {
             errors.push_back({
                 "missing_column",
                 "Required column '" + req.tableName + "." + req.columnName +
                 "' does not exist"
             });
+            continue;
+        }
+
+        // Check type if specified
+        if (!req.expectedType.empty()) {
+            // SQLite types are case-insensitive
+            std::string upperExpected = req.expectedType;
+            std::string upperActual = col->type;
+            for (char& c : upperExpected) c = std::toupper(c);
+            for (char& c : upperActual) c = std::toupper(c);
+
+            if (upperActual.find(upperExpected) == std::string::npos) {
+                errors.push_back({
+                    "wrong_type",
+                    "Column '" + req.tableName + "." + req.columnName +
+                    "' has type '" + col->type + "', expected '" + req.expectedType + "'"
+                });
+            }
+        }
+
+        // Check NOT NULL if required
+        if (req.requireNotNull && !col->notNull) {
+            errors.push_back({
+                "nullable",
+                "Column '" + req.tableName + "." + req.columnName +
+                "' should be NOT NULL"
+            });
         }
     }
 
     // Check indexes
     for (const auto& req : indexRequirements_) {
-        auto stmt = conn.prepare(
-            "SELECT 1 FROM sqlite_master WHERE type='index' AND tbl_name=? AND name=?");
-        stmt.bind(1, req.tableName).bind(2, req.indexName);
-        if (!stmt.step()) {
+        const TableInfo* table = catalog.table(req.tableName);
+        if (!table || !table->index(req.indexName)) {
             errors.push_back({
                 "missing_index",
                 "Required index '" + req.indexName + "' on table '" +
@@ -0,0 +1,101 @@
+/**
+ * @file parallel_query.cpp
+ * @brief Implementation of ParallelQuery
+ */
+
+#include "sqlite3db/parallel_query.hpp"
+#include <algorithm>
+
+namespace sqlite3db {
+
+ParallelQuery::ParallelQuery(ConnectionPool& pool, const ParallelOptions& options)
+    : pool_(pool)
+    , options_(options)
+{
+    if (options_.shards == 0) {
+        options_.shards = std::max<size_t>(pool_.readerCount(), 1);
+    }
+}
+
+std::vector<Shard> ParallelQuery::plan(const Build& build) const {
+    int64_t first = 0;
+    int64_t last = 0;
+    if (options_.keyRange) {
+        std::tie(first, last) = *options_.keyRange;
+    } else {
+        auto reader = pool_.acquireReader();
+        std::string table = build(*reader).table();
+        // Bounds of the whole table, not the filtered rows: with rowid or an
+        // indexed key this is two index lookups instead of a scan
+        auto stmt = reader->prepare("SELECT MIN(" + options_.shardKey + "), MAX(" +
+                                    options_.shardKey + ") FROM " + table);
+        if (!stmt.step() || stmt.isNull(0)) {
+            return {};
+        }
+        first = stmt.columnInt64(0);
+        last = stmt.columnInt64(1);
+    }
+    if (first > last) {
+        return {};
+    }
+
+    // Unsigned arithmetic: the span of two int64 keys can exceed INT64_MAX
+    uint64_t span = static_cast<uint64_t>(last) - static_cast<uint64_t>(first);
+    uint64_t width = span / options_.shards + 1;
+
+    std::vector<Shard> shards;
+    shards.reserve(options_.shards);
+    for (uint64_t offset = 0; shards.size() < options_.shards; offset += width) {
+        Shard shard;
+        shard.index = shards.size();
+        shard.first = static_cast<int64_t>(static_cast<uint64_t>(first) + offset);
+        bool final = span - offset < width;
+        shard.last = final ? last : static_cast<int64_t>(static_cast<uint64_t>(shard.first) + width - 1);
+        shards.push_back(shard);
+        if (final) {
+            break;
+        }
+    }
+    return shards;
+}
+
+void ParallelQuery::restrict(QueryBuilder& query, const Shard& shard) const {
+    query.where(options_.shardKey + " >= ?", Value{shard.first})
+         .where(options_.shardKey + " <= ?", Value{shard.last});
+}
+
+int64_t ParallelQuery::count(const Build& build) const {
+    return mapReduce(build, [](QueryBuilder& query) { return query.count(); }, int64_t(0),
+                     [](int64_t total, int64_t part) { return total + part; });
+}
+
+double ParallelQuery::sum(const Build& build, const std::string& column) const {
+    return mapReduce(build,
+        [&column](QueryBuilder& query) {
+            // TOTAL() is SUM() that yields 0.0 for an empty shard
+            auto row = query.select("TOTAL(" + column + ")").fetchOne();
+            return row ? std::get<double>((*row)[0]) : 0.0;
+        },
+        0.0, [](double total, double part) { return total + part; });
+}
+
+std::vector<std::vector<Value>> ParallelQuery::fetchAll(const Build& build) const {
+    std::vector<std::vector<Value>> rows;
+    forEachRow(build, [&rows](std::vector<Value>& row) { rows.push_back(std::move(row)); });
+    return rows;
+}
+
+void ParallelQuery::forEachRow(const Build& build,
+                               const std::function<void(std::vector<Value>&)>& fn) const {
+    auto fetch = [](QueryBuilder& query) { return query.fetchAll(); };
+    Run<std::vector<std::vector<Value>>> run;
+    launch(build, fetch, run);
+    for (auto& part : run.parts) {
+        auto rows = part.get();
+        for (auto& row : rows) {
+            fn(row);
+        }
+    }
+}
+
+} // namespace sqlite3db
@@ -0,0 +1,205 @@
+/**
+ * @file profiler.cpp
+ * @brief Implementation of QueryProfiler
+ */
+
+#include "sqlite3db/profiler.hpp"
+#include <algorithm>
+#include <cstring>
+
+namespace sqlite3db {
+
+namespace {
+
+const char* const kOtherSql = "<other>";
+
+size_t latencyBucket(int64_t ns) {
+    int64_t us = ns / 1000;
+    size_t bucket = 0;
+    while (us > 0 && bucket + 1 < QueryStats::kLatencyBuckets) {
+        us >>= 1;
+        ++bucket;
+    }
+    return bucket;
+}
+
+} // namespace
+
+// ========== QueryStats ==========
+
+int64_t QueryStats::percentileNs(double p) const {
+    if (executions == 0) {
+        return 0;
+    }
+    auto target = static_cast<uint64_t>(std::max(1.0, p / 100.0 * static_cast<double>(executions)));
+    uint64_t seen = 0;
+    for (size_t i = 0; i < kLatencyBuckets; ++i) {
+        seen += latencyHistogram[i];
+        if (seen >= target) {
+            // Upper bound of bucket i, never above the observed maximum
+            int64_t upper = (int64_t(1) << i) * 1000;
+            return std::min(upper, maxNs);
+        }
+    }
+    return maxNs;
+}
+
+// ========== QueryProfiler ==========
+
+QueryProfiler::QueryProfiler(ProfilingOptions options)
+    : options_(std::move(options))
+{}
+
+unsigned QueryProfiler::traceMask() const {
+    unsigned mask = SQLITE_TRACE_PROFILE;
+    if (options_.countRows) {
+        mask |= SQLITE_TRACE_ROW;
+    }
+    return mask;
+}
+
+int QueryProfiler::traceCallback(unsigned type, void* context, void* p, void* x) {
+    auto* profiler = static_cast<QueryProfiler*>(context);
+    auto* stmt = static_cast<sqlite3_stmt*>(p);
+
+    if (type == SQLITE_TRACE_PROFILE) {
+        profiler->onProfile(stmt, *static_cast<sqlite3_int64*>(x));
+    } else if (type == SQLITE_TRACE_ROW) {
+        profiler->onRow(stmt);
+    }
+    return 0;
+}
+
+QueryStats& QueryProfiler::entryFor(sqlite3_stmt* stmt) {
+    const char* sql = sqlite3_sql(stmt);
+    if (sql == nullptr) {
+        sql = "";
+    }
+
+    auto handleIt = byHandle_.find(stmt);
+    if (handleIt != byHandle_.end() &&
+        (handleIt->second->sql == sql || handleIt->second->sql == kOtherSql)) {
+        return *handleIt->second;
+    }
+
+    auto it = stats_.find(sql);
+    if (it == stats_.end()) {
+        std::string key = stats_.size() < options_.maxTrackedStatements ? sql : kOtherSql;
+        it = stats_.find(key);
+        if (it == stats_.end()) {
+            it = stats_.emplace(key, QueryStats{}).first;
+            it->second.sql = key;
+        }
+    }
+    byHandle_[stmt] = &it->second;
+    return it->second;
+}
+
+void QueryProfiler::onRow(sqlite3_stmt* stmt) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ++pendingRows_[stmt];
+}
+
+void QueryProfiler::onProfile(sqlite3_stmt* stmt, int64_t ns) {
+    // Read and reset the counters so each execution is reported once
+    SlowQuery sample;
+    sample.durationNs = ns;
+    sample.fullScanSteps = sqlite3_stmt_status(stmt, SQLITE_STMTSTATUS_FULLSCAN_STEP, 1);
+    sample.sorts = sqlite3_stmt_status(stmt, SQLITE_STMTSTATUS_SORT, 1);
+    sample.autoIndexes = sqlite3_stmt_status(stmt, SQLITE_STMTSTATUS_AUTOINDEX, 1);
+    sample.vmSteps = sqlite3_stmt_status(stmt, SQLITE_STMTSTATUS_VM_STEP, 1);
+
+    bool slow = options_.onSlowQuery && options_.slowQueryThreshold.count() > 0 &&
+                ns >= std::chrono::duration_cast<std::chrono::nanoseconds>(
+                          options_.slowQueryThreshold).count();
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        QueryStats& entry = entryFor(stmt);
+
+        if (entry.executions == 0 || ns < entry.minNs) {
+            entry.minNs = ns;
+        }
+        entry.maxNs = std::max(entry.maxNs, ns);
+        ++entry.executions;
+        entry.totalNs += ns;
+        entry.fullScanSteps += sample.fullScanSteps;
+        entry.sorts += sample.sorts;
+        entry.autoIndexes += sample.autoIndexes;
+        entry.vmSteps += sample.vmSteps;
+        ++entry.latencyHistogram[latencyBucket(ns)];
+
+        if (options_.countRows) {
+            auto rowsIt = pendingRows_.find(stmt);
+            if (rowsIt != pendingRows_.end()) {
+                entry.rows += rowsIt->second;
+                pendingRows_.erase(rowsIt);
+            }
+        }
+
+        ++totalExecutions_;
+        if (slow) {
+            ++slowQueries_;
+        }
+    }
+
+    // Callback outside the lock so it may call snapshot()
+    if (slow) {
+        if (options_.expandSlowQuerySql) {
+            char* expanded = sqlite3_expanded_sql(stmt);
+            sample.sql = expanded ? expanded : "";
+            sqlite3_free(expanded);
+        } else {
+            const char* sql = sqlite3_sql(stmt);
+            sample.sql = sql ? sql : "";
+        }
+        options_.onSlowQuery(sample);
+    }
+}
+
+std::vector<QueryStats> QueryProfiler::snapshot() const {
+    std::vector<QueryStats> result;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        result.reserve(stats_.size());
+        for (const auto& [sql, entry] : stats_) {
+            result.push_back(entry);
+        }
+    }
+    std::sort(result.begin(), result.end(), [](const QueryStats& a, const QueryStats& b) {
+        return a.totalNs > b.totalNs;
+    });
+    return result;
+}
+
+QueryStats QueryProfiler::stats(const std::string& sql) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = stats_.find(sql);
+    if (it == stats_.end()) {
+        QueryStats empty;
+        empty.sql = sql;
+        return empty;
+    }
+    return it->second;
+}
+
+uint64_t QueryProfiler::totalExecutions() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return totalExecutions_;
+}
+
+uint64_t QueryProfiler::slowQueries() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return slowQueries_;
+}
+
+void QueryProfiler::reset() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stats_.clear();
+    byHandle_.clear();
+    pendingRows_.clear();
+    totalExecutions_ = 0;
+    slowQueries_ = 0;
+}
+
+} // namespace sqlite3db
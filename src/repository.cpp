@@ -4,10 +4,95 @@
  */
 
 #include "sqlite3db/repository.hpp"
+#include <algorithm>
 #include <sstream>
 
 namespace sqlite3db {
 
+namespace {
+
+std::vector<std::vector<Value>> readRows(Statement& stmt) {
+    std::vector<std::vector<Value>> results;
+    int colCount = stmt.columnCount();
+
+    while (stmt.step()) {
+        std::vector<Value> row;
+        row.reserve(colCount);
+        for (int i = 0; i < colCount; ++i) {
+            row.push_back(stmt.columnValue(i));
+        }
+        results.push_back(std::move(row));
+    }
+    return results;
+}
+
+} // namespace
+
+// ========== CompiledQuery ==========
+
+CompiledQuery::CompiledQuery(Statement stmt, std::vector<Value> defaults)
+    : stmt_(std::move(stmt))
+    , defaults_(std::move(defaults))
+{}
+
+void CompiledQuery::bindAll(const std::vector<Value>& params) {
+    if (static_cast<int>(params.size()) != parameterCount()) {
+        throw QueryException("Compiled query expects " + std::to_string(parameterCount()) +
+                             " parameters, got " + std::to_string(params.size()), stmt_.sql());
+    }
+    for (size_t i = 0; i < params.size(); ++i) {
+        stmt_.bind(static_cast<int>(i + 1), params[i]);
+    }
+}
+
+std::vector<std::vector<Value>> CompiledQuery::fetchAll(const std::vector<Value>& params) {
+    ScopedReset guard(stmt_);
+    bindAll(params);
+    return readRows(stmt_);
+}
+
+std::optional<std::vector<Value>> CompiledQuery::fetchOne(const std::vector<Value>& params) {
+    ScopedReset guard(stmt_);
+    bindAll(params);
+    // Unlike QueryBuilder::fetchOne() no LIMIT is added: stop after one row
+    if (!stmt_.step()) {
+        return std::nullopt;
+    }
+    std::vector<Value> row;
+    int colCount = stmt_.columnCount();
+    row.reserve(colCount);
+    for (int i = 0; i < colCount; ++i) {
+        row.push_back(stmt_.columnValue(i));
+    }
+    return row;
+}
+
+ResultSet CompiledQuery::fetchResultSet(const std::vector<Value>& params) {
+    ScopedReset guard(stmt_);
+    bindAll(params);
+    return ResultSet::read(stmt_);
+}
+
+// ========== CompiledInsert ==========
+
+CompiledInsert::CompiledInsert(Statement stmt, Connection& conn)
+    : stmt_(std::move(stmt))
+    , conn_(conn)
+{}
+
+int64_t CompiledInsert::execute(const std::vector<Value>& values) {
+    if (static_cast<int>(values.size()) != parameterCount()) {
+        throw QueryException("Compiled insert expects " + std::to_string(parameterCount()) +
+                             " values, got " + std::to_string(values.size()), stmt_.sql());
+    }
+    ScopedReset guard(stmt_);
+    for (size_t i = 0; i < values.size(); ++i) {
+        stmt_.bind(static_cast<int>(i + 1), values[i]);
+    }
+    stmt_.execute();
+    return conn_.lastInsertRowId();
+}
+
 // ========== QueryBuilder ==========
 
 QueryBuilder::QueryBuilder(Connection& conn, const std::string& table)
@@ -40,16 +125,15 @@ QueryBuilder& QueryBuilder::from(const std::string& table) {
     return *this;
 }
 
-QueryBuilder& QueryBuilder::where(const std::string& column, const std::string& op, const Value& value) {
-    std::string clause = column + " " + op + " ?";
-    whereClauses_.push_back(clause);
-    whereValues_.push_back(value);
+QueryBuilder& QueryBuilder::where(const std::string& column, const std::string& op, Value value) {
+    whereClauses_.push_back(column + " " + op + " ?");
+    whereValues_.push_back(std::move(value));
     return *this;
 }
 
-QueryBuilder& QueryBuilder::where(const std::string& rawCondition, const Value& value) {
+QueryBuilder& QueryBuilder::where(const std::string& rawCondition, Value value) {
     whereClauses_.push_back(rawCondition);
-    whereValues_.push_back(value);
+    whereValues_.push_back(std::move(value));
     return *this;
 }
 
@@ -84,11 +168,13 @@ QueryBuilder& QueryBuilder::whereIn(const std::string& column, const std::vector
 
 QueryBuilder& QueryBuilder::join(const std::string& table, const std::string& condition) {
     joins_.push_back("JOIN " + table + " ON " + condition);
+    joinTables_.push_back(table);
     return *this;
 }
 
 QueryBuilder& QueryBuilder::leftJoin(const std::string& table, const std::string& condition) {
     joins_.push_back("LEFT JOIN " + table + " ON " + condition);
+    joinTables_.push_back(table);
     return *this;
 }
 
@@ -112,60 +198,73 @@ QueryBuilder& QueryBuilder::groupBy(const std::string& column) {
     return *this;
 }
 
-QueryBuilder& QueryBuilder::having(const std::string& condition, const Value& value) {
+QueryBuilder& QueryBuilder::having(const std::string& condition, Value value) {
     havingClause_ = condition;
-    havingValue_ = value;
+    havingValue_ = std::move(value);
     hasHaving_ = true;
     return *this;
 }
 
 std::string QueryBuilder::toSql() const {
-    std::ostringstream oss;
-
-    oss << "SELECT " << selectClause_ << " FROM " << table_;
+    // Plain appends into one reserved buffer: this runs for every
+    // non-compiled execution
+    size_t size = 32 + selectClause_.size() + table_.size() + orderByClause_.size() +
+                  groupByClause_.size() + havingClause_.size();
+    for (const auto& join : joins_) size += join.size() + 1;
+    for (const auto& clause : whereClauses_) size += clause.size() + 5;
+
+    std::string sql;
+    sql.reserve(size);
+    sql += "SELECT ";
+    sql += selectClause_;
+    sql += " FROM ";
+    sql += table_;
 
     // JOINs
     for (const auto& join : joins_) {
-        oss << " " << join;
+        sql += ' ';
+        sql += join;
     }
 
     // WHERE
-    if (!whereClauses_.empty()) {
-        oss << " WHERE ";
-        for (size_t i = 0; i < whereClauses_.size(); ++i) {
-            if (i > 0) oss << " AND ";
-            oss << whereClauses_[i];
-        }
+    for (size_t i = 0; i < whereClauses_.size(); ++i) {
+        sql += i == 0 ? " WHERE " : " AND ";
+        sql += whereClauses_[i];
     }
 
     // GROUP BY
     if (!groupByClause_.empty()) {
-        oss << " GROUP BY " << groupByClause_;
+        sql += " GROUP BY ";
+        sql += groupByClause_;
     }
 
     // HAVING
     if (hasHaving_) {
-        oss << " HAVING " << havingClause_;
+        sql += " HAVING ";
+        sql += havingClause_;
     }
 
     // ORDER BY
     if (!orderByClause_.empty()) {
-        oss << " ORDER BY " << orderByClause_;
+        sql += " ORDER BY ";
+        sql += orderByClause_;
     }
 
     // LIMIT/OFFSET
     if (limit_ >= 0) {
-        oss << " LIMIT " << limit_;
+        sql += " LIMIT ";
+        sql += std::to_string(limit_);
     }
     if (offset_ >= 0) {
-        oss << " OFFSET " << offset_;
+        sql += " OFFSET ";
+        sql += std::to_string(offset_);
     }
 
-    return oss.str();
+    return sql;
 }
 
-std::vector<std::vector<Value>> QueryBuilder::fetchAll() {
-    auto stmt = conn_.prepare(toSql());
+Statement QueryBuilder::prepareBound(const std::string& sql) const {
+    auto stmt = conn_.prepare(sql);
 
     // Bind WHERE values
     int paramIndex = 1;
@@ -178,21 +277,79 @@ std::vector<std::vector<Value>> QueryBuilder::fetchAll() {
         stmt.bind(paramIndex++, havingValue_);
     }
 
-    std::vector<std::vector<Value>> results;
-    int colCount = stmt.columnCount();
+    return stmt;
+}
 
-    while (stmt.step()) {
-        std::vector<Value> row;
-        row.reserve(colCount);
-        for (int i = 0; i < colCount; ++i) {
-            row.push_back(stmt.columnValue(i));
+std::vector<Value> QueryBuilder::parameters() const {
+    std::vector<Value> params = whereValues_;
+    if (hasHaving_) {
+        params.push_back(havingValue_);
+    }
+    return params;
+}
+
+CompiledQuery QueryBuilder::compile() const {
+    return CompiledQuery(conn_.prepare(toSql()), parameters());
+}
+
+QueryBuilder& QueryBuilder::cached(bool enable) {
+    cached_ = enable;
+    return *this;
+}
+
+ResultCache* QueryBuilder::activeCache() const {
+    return cached_ ? conn_.resultCache() : nullptr;
+}
+
+std::string QueryBuilder::cacheKey(const std::string& sql) const {
+    return ResultCache::makeKey(sql, whereValues_, hasHaving_ ? &havingValue_ : nullptr);
+}
+
+std::vector<std::string> QueryBuilder::sourceTables() const {
+    std::vector<std::string> tables;
+    tables.reserve(joinTables_.size() + 1);
+    // Drop an alias ("orders o" -> "orders")
+    auto name = [](const std::string& source) { return source.substr(0, source.find(' ')); };
+    tables.push_back(name(table_));
+    for (const auto& join : joinTables_) {
+        tables.push_back(name(join));
+    }
+    return tables;
+}
+
+std::vector<std::vector<Value>> QueryBuilder::fetchAll() {
+    std::string sql = toSql();
+    ResultCache* cache = activeCache();
+    std::string key;
+    if (cache) {
+        key = cacheKey(sql);
+        if (auto rows = cache->lookup(key)) {
+            return *rows;
         }
-        results.push_back(std::move(row));
     }
 
+    auto stmt = prepareBound(sql);
+    auto results = readRows(stmt);
+
+    if (cache) {
+        cache->store(key, sourceTables(), results);
+    }
     return results;
 }
 
+ResultSet QueryBuilder::fetchResultSet() {
+    auto stmt = prepareBound(toSql());
+    return ResultSet::read(stmt);
+}
+
+Cursor QueryBuilder::stream() {
+    return Cursor(prepareBound(toSql()));
+}
+
+ColumnarReader QueryBuilder::columnar(const ColumnarOptions& options) {
+    return ColumnarReader(prepareBound(toSql()), options);
+}
+
 std::optional<std::vector<Value>> QueryBuilder::fetchOne() {
     // Ensure we only get one row
     limit(1);
@@ -209,20 +366,33 @@ int64_t QueryBuilder::count() {
     std::string savedSelect = selectClause_;
     selectClause_ = "COUNT(*)";
 
-    auto stmt = conn_.prepare(toSql());
-
-    int paramIndex = 1;
-    for (const auto& value : whereValues_) {
-        stmt.bind(paramIndex++, value);
-    }
+    std::string sql = toSql();
 
     // Restore select clause
     selectClause_ = savedSelect;
 
-    if (stmt.step()) {
-        return stmt.columnInt64(0);
+    ResultCache* cache = activeCache();
+    std::string key;
+    if (cache) {
+        // Own namespace: fetchAll() of select("COUNT(*)") has the same SQL
+        // but may have stored zero rows (GROUP BY) or several
+        key = "count:" + cacheKey(sql);
+        if (auto rows = cache->lookup(key)) {
+            if (!rows->empty() && !(*rows)[0].empty()) {
+                if (auto* total = std::get_if<int64_t>(&(*rows)[0][0])) {
+                    return *total;
+                }
+            }
+        }
+    }
+
+    auto stmt = prepareBound(sql);
+    int64_t total = stmt.step() ? stmt.columnInt64(0) : 0;
+
+    if (cache) {
+        cache->store(key, sourceTables(), ResultCache::Rows{{Value{total}}});
     }
-    return 0;
+    return total;
 }
 
 // ========== InsertBuilder ==========
@@ -232,34 +402,37 @@ InsertBuilder::InsertBuilder(Connection& conn, const std::string& table)
     , table_(table)
 {}
 
-InsertBuilder& InsertBuilder::value(const std::string& column, const Value& val) {
+InsertBuilder& InsertBuilder::value(const std::string& column, Value val) {
     columns_.push_back(column);
-    values_.push_back(val);
+    values_.push_back(std::move(val));
     return *this;
 }
 
-std::string InsertBuilder::toSql() const {
-    std::ostringstream oss;
-    oss << "INSERT INTO " << table_ << " (";
-
+std::string InsertBuilder::buildSql(const char* verb) const {
+    std::string sql;
+    sql.reserve(32 + table_.size() + columns_.size() * 16);
+    sql += verb;
+    sql += ' ';
+    sql += table_;
+    sql += " (";
     for (size_t i = 0; i < columns_.size(); ++i) {
-        if (i > 0) oss << ", ";
-        oss << columns_[i];
+        if (i > 0) sql += ", ";
+        sql += columns_[i];
     }
-
-    oss << ") VALUES (";
-
+    sql += ") VALUES (";
     for (size_t i = 0; i < columns_.size(); ++i) {
-        if (i > 0) oss << ", ";
-        oss << "?";
+        sql += i > 0 ? ", ?" : "?";
     }
+    sql += ')';
+    return sql;
+}
 
-    oss << ")";
-    return oss.str();
+std::string InsertBuilder::toSql() const {
+    return buildSql("INSERT INTO");
 }
 
-int64_t InsertBuilder::execute() {
-    auto stmt = conn_.prepare(toSql());
+int64_t InsertBuilder::run(const std::string& sql) {
+    auto stmt = conn_.prepare(sql);
 
     for (size_t i = 0; i < values_.size(); ++i) {
         stmt.bind(static_cast<int>(i + 1), values_[i]);
@@ -269,32 +442,20 @@ int64_t InsertBuilder::execute() {
     return conn_.lastInsertRowId();
 }
 
-int64_t InsertBuilder::upsert() {
-    std::ostringstream oss;
-    oss << "INSERT OR REPLACE INTO " << table_ << " (";
-
-    for (size_t i = 0; i < columns_.size(); ++i) {
-        if (i > 0) oss << ", ";
-        oss << columns_[i];
-    }
-
-    oss << ") VALUES (";
-
-    for (size_t i = 0; i < columns_.size(); ++i) {
-        if (i > 0) oss << ", ";
-        oss << "?";
-    }
-
-    oss << ")";
+int64_t InsertBuilder::execute() {
+    return run(toSql());
+}
 
-    auto stmt = conn_.prepare(oss.str());
+int64_t InsertBuilder::upsert() {
+    return run(buildSql("INSERT OR REPLACE INTO"));
+}
 
-    for (size_t i = 0; i < values_.size(); ++i) {
-        stmt.bind(static_cast<int>(i + 1), values_[i]);
-    }
+CompiledInsert InsertBuilder::compile() const {
+    return CompiledInsert(conn_.prepare(toSql()), conn_);
+}
 
-    stmt.execute();
-    return conn_.lastInsertRowId();
+CompiledInsert InsertBuilder::compileUpsert() const {
+    return CompiledInsert(conn_.prepare(buildSql("INSERT OR REPLACE INTO")), conn_);
 }
 
 // ========== BatchInsertBuilder ==========
@@ -306,7 +467,7 @@ BatchInsertBuilder::BatchInsertBuilder(Connection& conn, const std::string& tabl
     , columns_(columns)
 {}
 
-BatchInsertBuilder& BatchInsertBuilder::addRow(const std::vector<Value>& values) {
+void BatchInsertBuilder::checkRowSize(const std::vector<Value>& values) const {
     if (values.size() != columns_.size()) {
         throw QueryException(
             "Row value count (" + std::to_string(values.size()) +
@@ -314,26 +475,140 @@ BatchInsertBuilder& BatchInsertBuilder::addRow(const std::vector<Value>& values)
             ""
         );
     }
+}
+
+BatchInsertBuilder& BatchInsertBuilder::addRow(const std::vector<Value>& values) {
+    checkRowSize(values);
     rows_.push_back(values);
+    flushIfFull();
     return *this;
 }
 
+BatchInsertBuilder& BatchInsertBuilder::addRow(std::vector<Value>&& values) {
+    checkRowSize(values);
+    rows_.push_back(std::move(values));
+    flushIfFull();
+    return *this;
+}
+
+void BatchInsertBuilder::flushIfFull() {
+    if (!streaming_ || rows_.size() < std::max<size_t>(batchSize_, 1)) {
+        return;
+    }
+
+    Transaction txn(conn_);
+    flushedRows_ += insertRange(0, rows_.size());
+    txn.commit();
+    rows_.clear();
+}
+
 BatchInsertBuilder& BatchInsertBuilder::setBatchSize(size_t size) {
     batchSize_ = size;
     return *this;
 }
 
+BatchInsertBuilder& BatchInsertBuilder::setMultiRowValues(bool enable) {
+    multiRow_ = enable;
+    return *this;
+}
+
+BatchInsertBuilder& BatchInsertBuilder::onConflictUpdate(const std::vector<std::string>& conflictColumns,
+                                                         const std::vector<std::string>& updateColumns) {
+    if (conflictColumns.empty()) {
+        throw QueryException("Upsert into " + table_ + " needs at least one conflict column", "");
+    }
+    conflictColumns_ = conflictColumns;
+    updateColumns_ = updateColumns;
+    if (updateColumns_.empty()) {
+        for (const auto& column : columns_) {
+            if (std::find(conflictColumns_.begin(), conflictColumns_.end(), column) == conflictColumns_.end()) {
+                updateColumns_.push_back(column);
+            }
+        }
+    }
+    buildUpsertClause();
+    return *this;
+}
+
+BatchInsertBuilder& BatchInsertBuilder::setUpdateOnlyChanged(bool enable) {
+    updateOnlyChanged_ = enable;
+    if (!conflictColumns_.empty()) {
+        buildUpsertClause();
+    }
+    return *this;
+}
+
+void BatchInsertBuilder::buildUpsertClause() {
+    std::string clause = " ON CONFLICT (";
+    for (size_t i = 0; i < conflictColumns_.size(); ++i) {
+        if (i > 0) clause += ", ";
+        clause += conflictColumns_[i];
+    }
+    clause += ")";
+
+    if (updateColumns_.empty()) {
+        clause += " DO NOTHING";
+    } else {
+        clause += " DO UPDATE SET ";
+        for (size_t i = 0; i < updateColumns_.size(); ++i) {
+            if (i > 0) clause += ", ";
+            clause += updateColumns_[i] + " = excluded." + updateColumns_[i];
+        }
+        if (updateOnlyChanged_) {
+            // IS NOT: NULL-safe comparison
+            clause += " WHERE ";
+            for (size_t i = 0; i < updateColumns_.size(); ++i) {
+                if (i > 0) clause += " OR ";
+                clause += table_ + "." + updateColumns_[i] + " IS NOT excluded." + updateColumns_[i];
+            }
+        }
+    }
+
+    upsertClause_ = std::move(clause);
+    resetStatements();
+}
+
+void BatchInsertBuilder::resetStatements() {
+    rowStmt_.reset();
+    multiStmt_.reset();
+    multiStmtRows_ = 0;
+}
+
+BatchInsertBuilder& BatchInsertBuilder::setStreaming(bool enable) {
+    streaming_ = enable;
+    return *this;
+}
+
 BatchInsertBuilder& BatchInsertBuilder::clear() {
     rows_.clear();
+    flushedRows_ = 0;
     return *this;
 }
 
-int64_t BatchInsertBuilder::execute() {
-    if (rows_.empty()) {
-        return 0;
+Statement& BatchInsertBuilder::rowStatement() {
+    if (!rowStmt_) {
+        rowStmt_.emplace(conn_.prepare(buildSql(1)));
+    }
+    return *rowStmt_;
+}
+
+size_t BatchInsertBuilder::rowsPerStatement() const {
+    if (!multiRow_) {
+        return 1;
     }
 
-    // Build the INSERT statement for a single row
+    // Ask the connection rather than trusting SQLITE_MAX_VARIABLE_NUMBER:
+    // the runtime limit can be lowered with sqlite3_limit()
+    int maxVariables = std::min(
+        sqlite3_limit(conn_.handle(), SQLITE_LIMIT_VARIABLE_NUMBER, -1),
+        kMaxMultiRowVariables);
+    size_t columnCount = std::max<size_t>(columns_.size(), 1);
+    size_t rows = static_cast<size_t>(std::max(maxVariables, 1)) / columnCount;
+
+    return std::max<size_t>(1, std::min(rows, std::max<size_t>(batchSize_, 1)));
+}
+
+std::string BatchInsertBuilder::buildSql(size_t rowCount) const {
     std::ostringstream oss;
     oss << "INSERT INTO " << table_ << " (";
 
@@ -342,42 +617,125 @@ int64_t BatchInsertBuilder::execute() {
         oss << columns_[i];
     }
 
-    oss << ") VALUES (";
+    oss << ") VALUES ";
 
-    for (size_t i = 0; i < columns_.size(); ++i) {
-        if (i > 0) oss << ", ";
-        oss << "?";
+    for (size_t row = 0; row < rowCount; ++row) {
+        if (row > 0) oss << ", ";
+        oss << "(";
+        for (size_t i = 0; i < columns_.size(); ++i) {
+            if (i > 0) oss << ", ";
+            oss << "?";
+        }
+        oss << ")";
     }
 
-    oss << ")";
+    oss << upsertClause_;
+    return oss.str();
+}
 
-    std::string sql = oss.str();
+void BatchInsertBuilder::bindRows(Statement& stmt, size_t begin, size_t end) {
+    // rows_ is not touched until the statement has executed, so SQLite
+    // can read TEXT/BLOB values in place instead of copying them
+    int paramIndex = 1;
+    for (size_t rowIdx = begin; rowIdx < end; ++rowIdx) {
+        for (const auto& value : rows_[rowIdx]) {
+            stmt.bindStatic(paramIndex++, value);
+        }
+    }
+}
 
-    int64_t totalInserted = 0;
+int64_t BatchInsertBuilder::insertRange(size_t begin, size_t end) {
+    size_t perStatement = rowsPerStatement();
+
+    if (perStatement == 1) {
+        Statement& stmt = rowStatement();
+        for (size_t rowIdx = begin; rowIdx < end; ++rowIdx) {
+            bindRows(stmt, rowIdx, rowIdx + 1);
+            stmt.execute();
+            stmt.clearBindings();
+        }
+        return static_cast<int64_t>(end - begin);
+    }
+
+    // Full chunks share one statement, prepared once per shape
+    if (!multiStmt_ || multiStmtRows_ != perStatement) {
+        multiStmt_.reset();
+        multiStmt_.emplace(conn_.prepare(buildSql(perStatement)));
+        multiStmtRows_ = perStatement;
+    }
+
+    size_t rowIdx = begin;
+    for (; rowIdx + perStatement <= end; rowIdx += perStatement) {
+        bindRows(*multiStmt_, rowIdx, rowIdx + perStatement);
+        multiStmt_->execute();
+    }
+    multiStmt_->clearBindings();
+
+    // Shorter statement for the final partial chunk
+    if (rowIdx < end) {
+        auto tail = conn_.prepare(buildSql(end - rowIdx));
+        bindRows(tail, rowIdx, end);
+        tail.execute();
+    }
+
+    return static_cast<int64_t>(end - begin);
+}
+
+int64_t BatchInsertBuilder::execute() {
+    // In streaming mode earlier batches were already committed by addRow
+    int64_t totalInserted = flushedRows_;
+    flushedRows_ = 0;
+
+    if (rows_.empty()) {
+        return totalInserted;
+    }
+
+    size_t batchSize = std::max<size_t>(batchSize_, 1);
 
     // Process in batches
-    for (size_t batchStart = 0; batchStart < rows_.size(); batchStart += batchSize_) {
-        size_t batchEnd = std::min(batchStart + batchSize_, rows_.size());
+    for (size_t batchStart = 0; batchStart < rows_.size(); batchStart += batchSize) {
+        size_t batchEnd = std::min(batchStart + batchSize, rows_.size());
 
         // Each batch runs in a single transaction for performance
         Transaction txn(conn_);
+        totalInserted += insertRange(batchStart, batchEnd);
+        txn.commit();
+    }
 
-        auto stmt = conn_.prepare(sql);
+    if (streaming_) {
+        rows_.clear();
+    }
+
+    return totalInserted;
+}
 
-        for (size_t rowIdx = batchStart; rowIdx < batchEnd; ++rowIdx) {
-            const auto& row = rows_[rowIdx];
+int64_t BatchInsertBuilder::insertFrom(const std::function<bool(std::vector<Value>&)>& producer) {
+    Statement& stmt = rowStatement();
+    size_t batchSize = std::max<size_t>(batchSize_, 1);
+    std::vector<Value> row;
+    row.reserve(columns_.size());
 
+    int64_t totalInserted = 0;
+    bool more = true;
+
+    while (more) {
+        Transaction txn(conn_);
+        size_t inBatch = 0;
+
+        while (inBatch < batchSize && (more = producer(row))) {
+            checkRowSize(row);
+            // The row buffer is only refilled after execute(), so its
+            // values can be bound in place
             for (size_t colIdx = 0; colIdx < row.size(); ++colIdx) {
-                stmt.bind(static_cast<int>(colIdx + 1), row[colIdx]);
+                stmt.bindStatic(static_cast<int>(colIdx + 1), row[colIdx]);
             }
-
             stmt.execute();
-            stmt.reset();
-            stmt.clearBindings();
-            ++totalInserted;
+            ++inBatch;
         }
 
+        stmt.clearBindings();
         txn.commit();
+        totalInserted += static_cast<int64_t>(inBatch);
     }
 
     return totalInserted;
@@ -0,0 +1,79 @@
+/**
+ * @file resource_limits.cpp
+ * @brief Implementation of memory statistics, heap limits and QueryWatchdog
+ */
+
+#include "sqlite3db/resource_limits.hpp"
+
+namespace sqlite3db {
+
+MemoryStats libraryMemoryStats(bool resetHighwater) {
+    MemoryStats stats;
+    int reset = resetHighwater ? 1 : 0;
+    sqlite3_int64 current = 0;
+    sqlite3_int64 highwater = 0;
+
+    sqlite3_status64(SQLITE_STATUS_MEMORY_USED, &current, &highwater, reset);
+    stats.usedBytes = current;
+    stats.highwaterBytes = highwater;
+
+    sqlite3_status64(SQLITE_STATUS_MALLOC_COUNT, &current, &highwater, 0);
+    stats.allocations = current;
+
+    sqlite3_status64(SQLITE_STATUS_MALLOC_SIZE, &current, &highwater, reset);
+    stats.largestAllocation = highwater;
+
+    // A negative argument reads the limit without changing it
+    stats.softHeapLimit = sqlite3_soft_heap_limit64(-1);
+    stats.hardHeapLimit = sqlite3_hard_heap_limit64(-1);
+    return stats;
+}
+
+int64_t setSoftHeapLimit(int64_t bytes) {
+    return sqlite3_soft_heap_limit64(bytes);
+}
+
+int64_t setHardHeapLimit(int64_t bytes) {
+    return sqlite3_hard_heap_limit64(bytes);
+}
+
+// ========== QueryWatchdog ==========
+
+QueryWatchdog::Scope::Scope(QueryWatchdog* watchdog)
+    : watchdog_(watchdog && watchdog->timeout_.count() > 0 ? watchdog : nullptr)
+{
+    if (watchdog_ && watchdog_->depth_++ == 0) {
+        watchdog_->deadline_ = std::chrono::steady_clock::now() + watchdog_->timeout_;
+        watchdog_->timedOut_ = false;
+    }
+}
+
+QueryWatchdog::Scope::~Scope() {
+    if (watchdog_) {
+        --watchdog_->depth_;
+    }
+}
+
+std::string QueryWatchdog::Scope::errorMessage(sqlite3* db) const {
+    if (watchdog_ && watchdog_->timedOut_) {
+        return "Query exceeded the " + std::to_string(watchdog_->timeout_.count()) + " ms timeout";
+    }
+    return sqlite3_errmsg(db);
+}
+
+int QueryWatchdog::progressCallback(void* context) {
+    auto* self = static_cast<QueryWatchdog*>(context);
+    if (self->cancelCheck_ && self->cancelCheck_()) {
+        return 1;
+    }
+    if (self->depth_ > 0 && !self->timedOut_ &&
+        std::chrono::steady_clock::now() >= self->deadline_) {
+        self->timedOut_ = true;
+        ++self->timeouts_;
+        return 1;
+    }
+    // Keep interrupting until the timed-out call returns
+    return self->depth_ > 0 && self->timedOut_ ? 1 : 0;
+}
+
+} // namespace sqlite3db
@@ -0,0 +1,264 @@
+/**
+ * @file result_cache.cpp
+ * @brief Implementation of ResultCache
+ */
+
+#include "sqlite3db/result_cache.hpp"
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <type_traits>
+
+namespace sqlite3db {
+
+namespace {
+
+std::string lowercase(const char* text) {
+    std::string result(text ? text : "");
+    for (char& c : result) {
+        c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+    }
+    return result;
+}
+
+template<typename T>
+void appendRaw(std::string& out, const T& value) {
+    out.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+// Type tag plus an unambiguous encoding, so e.g. 1 and "1" differ
+void appendValue(std::string& out, const Value& value) {
+    out.push_back(static_cast<char>('0' + value.index()));
+    std::visit([&](const auto& v) {
+        using T = std::decay_t<decltype(v)>;
+        if constexpr (std::is_same_v<T, int64_t> || std::is_same_v<T, double>) {
+            appendRaw(out, v);
+        } else if constexpr (std::is_same_v<T, std::string>) {
+            appendRaw(out, v.size());
+            out.append(v);
+        } else if constexpr (std::is_same_v<T, std::vector<uint8_t>>) {
+            appendRaw(out, v.size());
+            out.append(reinterpret_cast<const char*>(v.data()), v.size());
+        }
+    }, value);
+}
+
+size_t estimateBytes(const ResultCache::Rows& rows) {
+    size_t bytes = sizeof(rows);
+    for (const auto& row : rows) {
+        bytes += sizeof(row) + row.size() * sizeof(Value);
+        for (const auto& value : row) {
+            if (const auto* s = std::get_if<std::string>(&value)) {
+                bytes += s->capacity();
+            } else if (const auto* b = std::get_if<std::vector<uint8_t>>(&value)) {
+                bytes += b->capacity();
+            }
+        }
+    }
+    return bytes;
+}
+
+} // namespace
+
+ResultCache::ResultCache(sqlite3* db, const ResultCacheOptions& options)
+    : db_(db)
+    , options_(options)
+{
+    sqlite3_prepare_v3(db_, "PRAGMA data_version", -1, SQLITE_PREPARE_PERSISTENT,
+                       &dataVersionStmt_, nullptr);
+    dataVersion_ = readDataVersion();
+    changesBaseline_ = sqlite3_total_changes64(db_);
+    sqlite3_update_hook(db_, &ResultCache::updateHook, this);
+}
+
+ResultCache::~ResultCache() {
+    sqlite3_update_hook(db_, nullptr, nullptr);
+    sqlite3_finalize(dataVersionStmt_);
+}
+
+std::string ResultCache::makeKey(const std::string& sql, const std::vector<Value>& params,
+                                 const Value* extra) {
+    std::string key;
+    key.reserve(sql.size() + 1 + params.size() * 9);
+    key.append(sql);
+    key.push_back('\0');
+    for (const auto& value : params) {
+        appendValue(key, value);
+    }
+    if (extra) {
+        appendValue(key, *extra);
+    }
+    return key;
+}
+
+void ResultCache::updateHook(void* context, int, const char*, const char* table, sqlite3_int64) {
+    static_cast<ResultCache*>(context)->onWrite(table);
+}
+
+void ResultCache::onWrite(const char* table) {
+    ++hookedRows_;
+
+    bool inTransaction = !sqlite3_get_autocommit(db_);
+
+    // Bulk writes call this per row; one generation bump per table is enough
+    // until a result for that table is stored again
+    if (lastWriteCounted_ && (lastWriteInTransaction_ || !inTransaction) &&
+        lastWrittenTable_.size() == std::strlen(table) &&
+        std::equal(lastWrittenTable_.begin(), lastWrittenTable_.end(), table,
+                   [](char a, char b) { return a == std::tolower(static_cast<unsigned char>(b)); })) {
+        return;
+    }
+
+    std::string name = lowercase(table);
+    ++generations_[name];
+    if (inTransaction &&
+        std::find(writtenInTransaction_.begin(), writtenInTransaction_.end(), name) ==
+            writtenInTransaction_.end()) {
+        writtenInTransaction_.push_back(name);
+    }
+    lastWrittenTable_ = std::move(name);
+    lastWriteCounted_ = true;
+    lastWriteInTransaction_ = inTransaction;
+}
+
+void ResultCache::endTransactionIfIdle() {
+    if (!writtenInTransaction_.empty() && sqlite3_get_autocommit(db_)) {
+        writtenInTransaction_.clear();
+        lastWriteCounted_ = false;
+    }
+}
+
+int64_t ResultCache::readDataVersion() {
+    // Unlike SQLITE_FCNTL_DATA_VERSION, the pragma ignores this connection's
+    // own commits, which the update hook already covers
+    if (!dataVersionStmt_) {
+        return dataVersion_;
+    }
+    int64_t version = dataVersion_;
+    if (sqlite3_step(dataVersionStmt_) == SQLITE_ROW) {
+        version = sqlite3_column_int64(dataVersionStmt_, 0);
+    }
+    sqlite3_reset(dataVersionStmt_);
+    return version;
+}
+
+void ResultCache::checkExternalChanges() {
+    int64_t version = readDataVersion();
+    int64_t untracked = sqlite3_total_changes64(db_) - hookedRows_;
+
+    if (version != dataVersion_ || untracked != changesBaseline_) {
+        dataVersion_ = version;
+        changesBaseline_ = untracked;
+        if (!lru_.empty()) {
+            invalidateAll();
+        }
+    }
+}
+
+uint64_t ResultCache::generation(const std::string& table) const {
+    auto it = generations_.find(table);
+    return it == generations_.end() ? 0 : it->second;
+}
+
+bool ResultCache::isCurrent(const Entry& entry) const {
+    for (const auto& [table, gen] : entry.tableGenerations) {
+        if (generation(table) != gen) {
+            return false;
+        }
+    }
+    return true;
+}
+
+std::shared_ptr<const ResultCache::Rows> ResultCache::lookup(const std::string& key) {
+    checkExternalChanges();
+    endTransactionIfIdle();
+
+    auto it = index_.find(key);
+    if (it == index_.end()) {
+        ++stats_.misses;
+        return nullptr;
+    }
+    if (!isCurrent(*it->second)) {
+        erase(it->second);
+        ++stats_.invalidations;
+        ++stats_.misses;
+        return nullptr;
+    }
+
+    lru_.splice(lru_.begin(), lru_, it->second);
+    ++stats_.hits;
+    return it->second->rows;
+}
+
+void ResultCache::store(const std::string& key, const std::vector<std::string>& tables, Rows rows) {
+    endTransactionIfIdle();
+
+    Entry entry;
+    entry.key = key;
+    for (const auto& table : tables) {
+        std::string name = lowercase(table.c_str());
+        // Uncommitted writes may roll back: don't remember what they show
+        if (std::find(writtenInTransaction_.begin(), writtenInTransaction_.end(), name) !=
+            writtenInTransaction_.end()) {
+            return;
+        }
+        entry.tableGenerations.emplace_back(name, generation(name));
+    }
+
+    entry.bytes = sizeof(Entry) + key.size() + estimateBytes(rows);
+    if (entry.bytes > options_.maxResultBytes || entry.bytes > options_.maxBytes ||
+        options_.maxEntries == 0) {
+        return;
+    }
+    entry.rows = std::make_shared<const Rows>(std::move(rows));
+
+    auto existing = index_.find(key);
+    if (existing != index_.end()) {
+        erase(existing->second);
+    }
+    while (!lru_.empty() &&
+           (stats_.bytes + entry.bytes > options_.maxBytes || lru_.size() >= options_.maxEntries)) {
+        erase(std::prev(lru_.end()));
+        ++stats_.evictions;
+    }
+
+    stats_.bytes += entry.bytes;
+    lru_.push_front(std::move(entry));
+    index_[lru_.front().key] = lru_.begin();
+    stats_.entries = lru_.size();
+    ++stats_.stores;
+
+    // The next write to any table must bump its generation again
+    lastWriteCounted_ = false;
+}
+
+void ResultCache::erase(EntryList::iterator it) {
+    stats_.bytes -= it->bytes;
+    index_.erase(it->key);
+    lru_.erase(it);
+    stats_.entries = lru_.size();
+}
+
+void ResultCache::invalidateTable(const std::string& table) {
+    ++generations_[lowercase(table.c_str())];
+    lastWriteCounted_ = false;
+}
+
+void ResultCache::invalidateAll() {
+    stats_.invalidations += lru_.size();
+    ++stats_.fullClears;
+    lru_.clear();
+    index_.clear();
+    stats_.entries = 0;
+    stats_.bytes = 0;
+}
+
+void ResultCache::resetStats() {
+    size_t entries = stats_.entries;
+    size_t bytes = stats_.bytes;
+    stats_ = ResultCacheStats{};
+    stats_.entries = entries;
+    stats_.bytes = bytes;
+}
+
+} // namespace sqlite3db
@@ -0,0 +1,160 @@
+/**
+ * @file result_set.cpp
+ * @brief Implementation of ResultSet
+ */
+
+#include "sqlite3db/result_set.hpp"
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+namespace sqlite3db {
+
+namespace {
+
+// Blocks start small so tiny results stay cheap, then double
+constexpr size_t kFirstBlockSize = 4096;
+constexpr size_t kMaxBlockSize = size_t(1) << 20;
+
+} // namespace
+
+// ========== ResultSet::RowRef ==========
+
+int64_t ResultSet::RowRef::int64(int column) const {
+    const Cell& c = result_->cell(row_, column);
+    if (c.type == SQLITE_INTEGER) {
+        return c.integer;
+    }
+    return c.type == SQLITE_FLOAT ? static_cast<int64_t>(c.real) : 0;
+}
+
+double ResultSet::RowRef::real(int column) const {
+    const Cell& c = result_->cell(row_, column);
+    if (c.type == SQLITE_FLOAT) {
+        return c.real;
+    }
+    return c.type == SQLITE_INTEGER ? static_cast<double>(c.integer) : 0.0;
+}
+
+std::string_view ResultSet::RowRef::text(int column) const {
+    const Cell& c = result_->cell(row_, column);
+    return c.type == SQLITE_TEXT ? std::string_view(c.bytes, c.size) : std::string_view();
+}
+
+BlobView ResultSet::RowRef::blob(int column) const {
+    const Cell& c = result_->cell(row_, column);
+    if (c.type != SQLITE_BLOB) {
+        return BlobView{};
+    }
+    return BlobView{reinterpret_cast<const uint8_t*>(c.bytes), c.size};
+}
+
+std::vector<Value> ResultSet::RowRef::values() const {
+    std::vector<Value> result;
+    result.reserve(static_cast<size_t>(columnCount()));
+    for (int i = 0; i < columnCount(); ++i) {
+        result.push_back(value(i));
+    }
+    return result;
+}
+
+// ========== ResultSet ==========
+
+ResultSet ResultSet::read(Statement& stmt) {
+    ResultSet result;
+    // Names are known even when no row comes back
+    result.captureColumns(stmt);
+    while (stmt.step()) {
+        result.append(stmt);
+    }
+    return result;
+}
+
+const char* ResultSet::copyToArena(const void* data, size_t size) {
+    if (size > blockRemaining_) {
+        size_t blockSize = blocks_.empty() ? kFirstBlockSize
+                                           : std::min(kMaxBlockSize, arenaBytes_);
+        // Oversized cells get a block of their own size
+        blockSize = std::max(blockSize, size);
+        // Plain new[]: make_unique would zero the whole block first
+        blocks_.emplace_back(new char[blockSize]);
+        blockCursor_ = blocks_.back().get();
+        blockRemaining_ = blockSize;
+        arenaBytes_ += blockSize;
+    }
+    char* dest = blockCursor_;
+    std::memcpy(dest, data, size);
+    blockCursor_ += size;
+    blockRemaining_ -= size;
+    return dest;
+}
+
+void ResultSet::captureColumns(Statement& stmt) {
+    columns_ = stmt.columnCount();
+    names_.clear();
+    names_.reserve(static_cast<size_t>(columns_));
+    for (int i = 0; i < columns_; ++i) {
+        names_.push_back(stmt.columnName(i));
+    }
+}
+
+void ResultSet::append(Statement& stmt) {
+    sqlite3_stmt* handle = stmt.handle();
+    if (columns_ == 0) {
+        captureColumns(stmt);
+    }
+
+    for (int i = 0; i < columns_; ++i) {
+        Cell c{};
+        c.type = sqlite3_column_type(handle, i);
+        switch (c.type) {
+            case SQLITE_INTEGER:
+                c.integer = sqlite3_column_int64(handle, i);
+                break;
+            case SQLITE_FLOAT:
+                c.real = sqlite3_column_double(handle, i);
+                break;
+            case SQLITE_TEXT:
+            case SQLITE_BLOB: {
+                // Fetch the pointer before the size (sqlite3_column_bytes rule)
+                const void* data = c.type == SQLITE_TEXT
+                    ? static_cast<const void*>(sqlite3_column_text(handle, i))
+                    : sqlite3_column_blob(handle, i);
+                size_t size = static_cast<size_t>(sqlite3_column_bytes(handle, i));
+                c.size = static_cast<uint32_t>(size);
+                c.bytes = size == 0 ? "" : copyToArena(data, size);
+                break;
+            }
+            default:
+                break;
+        }
+        cells_.push_back(c);
+    }
+}
+
+int ResultSet::columnIndex(const std::string& name) const {
+    auto it = std::find(names_.begin(), names_.end(), name);
+    return it == names_.end() ? -1 : static_cast<int>(it - names_.begin());
+}
+
+ValueView ResultSet::view(size_t row, int column) const {
+    const Cell& c = cell(row, column);
+    switch (c.type) {
+        case SQLITE_INTEGER: return c.integer;
+        case SQLITE_FLOAT: return c.real;
+        case SQLITE_TEXT: return std::string_view(c.bytes, c.size);
+        case SQLITE_BLOB: return BlobView{reinterpret_cast<const uint8_t*>(c.bytes), c.size};
+        default: return NullValue{};
+    }
+}
+
+std::vector<std::vector<Value>> ResultSet::toValues() const {
+    std::vector<std::vector<Value>> result;
+    result.reserve(rowCount());
+    for (const auto& row : *this) {
+        result.push_back(row.values());
+    }
+    return result;
+}
+
+} // namespace sqlite3db
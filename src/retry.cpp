@@ -0,0 +1,31 @@
+/**
+ * @file retry.cpp
+ * @brief Backoff computation for RetryPolicy
+ */
+
+#include "sqlite3db/retry.hpp"
+#include <algorithm>
+#include <random>
+
+namespace sqlite3db {
+
+std::chrono::microseconds RetryPolicy::backoff(int retry) const {
+    // Microsecond resolution so small jittered delays don't round to zero
+    const double cap = static_cast<double>(
+        std::chrono::duration_cast<std::chrono::microseconds>(maxBackoff).count());
+    double delay = static_cast<double>(
+        std::chrono::duration_cast<std::chrono::microseconds>(initialBackoff).count());
+    for (int i = 1; i < retry && delay < cap; ++i) {
+        delay *= multiplier;
+    }
+    delay = std::min(delay, cap);
+
+    if (jitter && delay > 0) {
+        // One generator per thread: no locking, no shared sequence
+        thread_local std::minstd_rand rng{std::random_device{}()};
+        delay = std::uniform_real_distribution<double>(0.0, delay)(rng);
+    }
+    return std::chrono::microseconds(static_cast<int64_t>(delay));
+}
+
+} // namespace sqlite3db
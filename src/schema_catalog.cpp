@@ -0,0 +1,173 @@
+/**
+ * @file schema_catalog.cpp
+ * @brief Implementation of SchemaCatalog
+ */
+
+#include "sqlite3db/schema_catalog.hpp"
+#include <algorithm>
+#include <cctype>
+#include <optional>
+#include "sqlite3db/statement.hpp"
+
+namespace sqlite3db {
+
+namespace {
+
+std::string lowercase(const std::string& text) {
+    std::string result(text);
+    for (char& c : result) {
+        c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+    }
+    return result;
+}
+
+bool equalsIgnoreCase(const std::string& a, const std::string& b) {
+    return a.size() == b.size() &&
+           std::equal(a.begin(), a.end(), b.begin(), [](char x, char y) {
+               return std::tolower(static_cast<unsigned char>(x)) ==
+                      std::tolower(static_cast<unsigned char>(y));
+           });
+}
+
+// Columns of every table, then indexes of every table. The "kind"
+// column tells the two halves apart; the remaining columns are (name,
+// type, notnull, pk, cid) for a column and (name, origin, unique,
+// partial, seq) for an index. Views are read separately: a view over a
+// dropped table makes pragma_table_info() fail, which would fail the
+// whole join.
+constexpr const char* kCatalogSql = R"(
+    SELECT m.name, m.type, 0 AS kind, p.name, p.type, p."notnull", p.pk, p.cid AS seq
+    FROM sqlite_master AS m JOIN pragma_table_info(m.name) AS p
+    WHERE m.type = 'table'
+    UNION ALL
+    SELECT m.name, m.type, 1 AS kind, il.name, il.origin, il."unique", il.partial, il.seq
+    FROM sqlite_master AS m JOIN pragma_index_list(m.name) AS il
+    WHERE m.type = 'table'
+    ORDER BY 1, 3, 8
+)";
+
+constexpr const char* kViewColumnsSql = R"(
+    SELECT name, type, "notnull", pk FROM pragma_table_info(?) ORDER BY cid
+)";
+
+ColumnInfo readColumn(Statement& stmt, int first) {
+    ColumnInfo col;
+    col.name = stmt.columnString(first);
+    col.type = stmt.columnString(first + 1);
+    col.notNull = stmt.columnInt(first + 2) != 0;
+    col.primaryKey = stmt.columnInt(first + 3);
+    return col;
+}
+
+} // namespace
+
+std::string quoteIdentifier(const std::string& name) {
+    std::string quoted;
+    quoted.reserve(name.size() + 2);
+    quoted += '"';
+    for (char c : name) {
+        quoted += c;
+        if (c == '"') {
+            quoted += '"';
+        }
+    }
+    quoted += '"';
+    return quoted;
+}
+
+// ========== TableInfo ==========
+
+const ColumnInfo* TableInfo::column(const std::string& name) const {
+    for (const auto& col : columns) {
+        if (equalsIgnoreCase(col.name, name)) {
+            return &col;
+        }
+    }
+    return nullptr;
+}
+
+const IndexInfo* TableInfo::index(const std::string& name) const {
+    for (const auto& idx : indexes) {
+        if (equalsIgnoreCase(idx.name, name)) {
+            return &idx;
+        }
+    }
+    return nullptr;
+}
+
+// ========== SchemaCatalog ==========
+
+SchemaCatalog SchemaCatalog::load(Connection& conn) {
+    SchemaCatalog catalog;
+
+    // Read first: a change between the two queries leaves the catalog
+    // newer than its version, so the next staleness check reloads it
+    {
+        auto version = conn.prepare("PRAGMA schema_version");
+        if (version.step()) {
+            catalog.schemaVersion_ = version.columnInt64(0);
+        }
+    }
+
+    auto stmt = conn.prepare(kCatalogSql);
+    while (stmt.step()) {
+        std::string tableName = stmt.columnString(0);
+        auto [it, inserted] = catalog.tables_.try_emplace(lowercase(tableName));
+        TableInfo& table = it->second;
+        if (inserted) {
+            table.name = std::move(tableName);
+            table.isView = stmt.columnStringView(1) == "view";
+        }
+
+        if (stmt.columnInt(2) == 0) {
+            table.columns.push_back(readColumn(stmt, 3));
+        } else {
+            IndexInfo idx;
+            idx.name = stmt.columnString(3);
+            idx.origin = stmt.columnString(4);
+            idx.unique = stmt.columnInt(5) != 0;
+            idx.partial = stmt.columnInt(6) != 0;
+            table.indexes.push_back(std::move(idx));
+        }
+    }
+
+    auto views = conn.prepare("SELECT name FROM sqlite_master WHERE type = 'view'");
+    std::optional<Statement> columns;
+    while (views.step()) {
+        std::string viewName = views.columnString(0);
+        TableInfo& view = catalog.tables_[lowercase(viewName)];
+        view.name = std::move(viewName);
+        view.isView = true;
+
+        // A stale view (its table dropped) is listed without columns
+        try {
+            if (!columns) {
+                columns.emplace(conn.prepare(kViewColumnsSql));
+            }
+            ScopedReset guard(*columns);
+            columns->bind(1, view.name);
+            while (columns->step()) {
+                view.columns.push_back(readColumn(*columns, 0));
+            }
+        } catch (const QueryException&) {
+            view.columns.clear();
+        }
+    }
+    return catalog;
+}
+
+const TableInfo* SchemaCatalog::table(const std::string& name) const {
+    auto it = tables_.find(lowercase(name));
+    return it == tables_.end() ? nullptr : &it->second;
+}
+
+std::vector<const TableInfo*> SchemaCatalog::tables() const {
+    std::vector<const TableInfo*> result;
+    result.reserve(tables_.size());
+    for (const auto& entry : tables_) {
+        result.push_back(&entry.second);
+    }
+    return result;
+}
+
+} // namespace sqlite3db
@@ -0,0 +1,45 @@
+/**
+ * @file sql_function.cpp
+ * @brief Registration of user-defined SQL functions
+ */
+
+#include "sqlite3db/sql_function.hpp"
+
+namespace sqlite3db {
+namespace detail {
+
+void createFunction(sqlite3* db, const std::string& name, int argCount,
+                    const FunctionOptions& options, void* app,
+                    void (*scalar)(sqlite3_context*, int, sqlite3_value**),
+                    void (*step)(sqlite3_context*, int, sqlite3_value**),
+                    void (*finalize)(sqlite3_context*),
+                    void (*value)(sqlite3_context*),
+                    void (*inverse)(sqlite3_context*, int, sqlite3_value**),
+                    void (*destroy)(void*)) {
+    int flags = SQLITE_UTF8;
+    if (options.deterministic) {
+        flags |= SQLITE_DETERMINISTIC;
+    }
+    if (options.directOnly) {
+        flags |= SQLITE_DIRECTONLY;
+    }
+    if (options.innocuous) {
+        flags |= SQLITE_INNOCUOUS;
+    }
+
+    int result;
+    if (value) {
+        result = sqlite3_create_window_function(db, name.c_str(), argCount, flags, app,
+                                                step, finalize, value, inverse, destroy);
+    } else {
+        result = sqlite3_create_function_v2(db, name.c_str(), argCount, flags, app,
+                                            scalar, step, finalize, destroy);
+    }
+    if (result != SQLITE_OK) {
+        throw DatabaseException("Failed to register SQL function " + name + ": " +
+                                sqlite3_errmsg(db), result);
+    }
+}
+
+} // namespace detail
+} // namespace sqlite3db
@@ -5,6 +5,7 @@
 
 #include "sqlite3db/statement.hpp"
 #include "sqlite3db/connection.hpp"
+#include "sqlite3db/statement_cache.hpp"
 #include <cstring>
 
 namespace sqlite3db {
@@ -13,6 +14,16 @@ Statement::Statement(Connection& conn, const std::string& sql)
     : conn_(&conn)
     , sql_(sql)
 {
+    StatementCache& cache = conn.statementCache();
+    if (cache.enabled()) {
+        cache_ = &cache;
+    }
+
+    stmt_ = cache.acquire(sql);
+    if (stmt_) {
+        return;
+    }
+
     int result = sqlite3_prepare_v2(
         conn.handle(),
         sql.c_str(),
@@ -22,7 +33,12 @@ Statement::Statement(Connection& conn, const std::string& sql)
     );
 
     if (result != SQLITE_OK) {
-        throw QueryException(sqlite3_errmsg(conn.handle()), sql, result);
+        // Preparing can hit SQLITE_BUSY/LOCKED while reading the schema
+        std::string error = sqlite3_errmsg(conn.handle());
+        if (isBusyError(result)) {
+            throw BusyException(error, sql, result);
+        }
+        throw QueryException(error, sql, result);
     }
 }
 
@@ -33,6 +49,7 @@ Statement::~Statement() {
 Statement::Statement(Statement&& other) noexcept
     : stmt_(other.stmt_)
     , conn_(other.conn_)
+    , cache_(other.cache_)
     , sql_(std::move(other.sql_))
 {
     other.stmt_ = nullptr;
@@ -43,6 +60,7 @@ Statement& Statement::operator=(Statement&& other) noexcept {
         finalize();
         stmt_ = other.stmt_;
         conn_ = other.conn_;
+        cache_ = other.cache_;
         sql_ = std::move(other.sql_);
         other.stmt_ = nullptr;
     }
@@ -51,7 +69,11 @@ Statement& Statement::operator=(Statement&& other) noexcept {
 
 void Statement::finalize() {
     if (stmt_) {
-        sqlite3_finalize(stmt_);
+        if (cache_) {
+            cache_->release(sql_, stmt_);
+        } else {
+            sqlite3_finalize(stmt_);
+        }
         stmt_ = nullptr;
     }
 }
@@ -138,6 +160,55 @@ Statement& Statement::bind(int index, const Value& value) {
     return *this;
 }
 
+Statement& Statement::bindStatic(int index, std::string_view value) {
+    // A null data pointer would bind NULL, not an empty string
+    const char* data = value.data() ? value.data() : "";
+    checkResult(
+        sqlite3_bind_text64(stmt_, index, data, value.size(), SQLITE_STATIC, SQLITE_UTF8),
+        "bind static text"
+    );
+    return *this;
+}
+
+Statement& Statement::bindStatic(int index, const char* value) {
+    if (value == nullptr) {
+        return bind(index, null);
+    }
+    return bindStatic(index, std::string_view(value));
+}
+
+Statement& Statement::bindZeroBlob(int index, uint64_t bytes) {
+    checkResult(sqlite3_bind_zeroblob64(stmt_, index, bytes), "bind zeroblob");
+    return *this;
+}
+
+Statement& Statement::bindStatic(int index, BlobView value) {
+    if (value.data == nullptr) {
+        // Keep empty blobs as zero-length BLOBs rather than NULL
+        checkResult(sqlite3_bind_zeroblob(stmt_, index, 0), "bind static blob");
+        return *this;
+    }
+    checkResult(
+        sqlite3_bind_blob64(stmt_, index, value.data, value.size, SQLITE_STATIC),
+        "bind static blob"
+    );
+    return *this;
+}
+
+Statement& Statement::bindStatic(int index, const Value& value) {
+    std::visit([this, index](const auto& v) {
+        using T = std::decay_t<decltype(v)>;
+        if constexpr (std::is_same_v<T, std::string>) {
+            bindStatic(index, std::string_view(v));
+        } else if constexpr (std::is_same_v<T, std::vector<uint8_t>>) {
+            bindStatic(index, BlobView{v.data(), v.size()});
+        } else {
+            bind(index, v);
+        }
+    }, value);
+    return *this;
+}
+
 Statement& Statement::clearBindings() {
     checkResult(sqlite3_clear_bindings(stmt_), "clear bindings");
     return *this;
@@ -146,14 +217,12 @@ Statement& Statement::clearBindings() {
 // ========== Execution ==========
 
 void Statement::execute() {
+    QueryWatchdog::Scope deadline(conn_->queryWatchdog());
     int result = sqlite3_step(stmt_);
 
     if (result != SQLITE_DONE && result != SQLITE_ROW) {
-        // Check for constraint violations
-        if (result == SQLITE_CONSTRAINT) {
-            throw ConstraintException(sqlite3_errmsg(conn_->handle()), result);
-        }
-        throw QueryException(sqlite3_errmsg(conn_->handle()), sql_, result);
+        // Constraint violations and lock contention get their own types
+        throwQueryError(deadline.errorMessage(conn_->handle()), sql_, result);
     }
 
     // Reset for potential reuse
@@ -161,6 +230,7 @@ void Statement::execute() {
 }
 
 bool Statement::step() {
+    QueryWatchdog::Scope deadline(conn_->queryWatchdog());
     int result = sqlite3_step(stmt_);
 
     if (result == SQLITE_ROW) {
@@ -168,7 +238,7 @@ bool Statement::step() {
     } else if (result == SQLITE_DONE) {
         return false;
     } else {
-        throw QueryException(sqlite3_errmsg(conn_->handle()), sql_, result);
+        throwQueryError(deadline.errorMessage(conn_->handle()), sql_, result);
     }
 }
 
@@ -246,6 +316,41 @@ Value Statement::columnValue(int index) const {
     }
 }
 
+std::string_view Statement::columnStringView(int index) const {
+    // Fetch the pointer before the size, as the SQLite docs require
+    const unsigned char* text = sqlite3_column_text(stmt_, index);
+    int size = sqlite3_column_bytes(stmt_, index);
+    if (text == nullptr) {
+        return {};
+    }
+    return std::string_view(reinterpret_cast<const char*>(text), static_cast<size_t>(size));
+}
+
+BlobView Statement::columnBlobView(int index) const {
+    const void* data = sqlite3_column_blob(stmt_, index);
+    int size = sqlite3_column_bytes(stmt_, index);
+    if (data == nullptr) {
+        return {};
+    }
+    return BlobView{static_cast<const uint8_t*>(data), static_cast<size_t>(size)};
+}
+
+ValueView Statement::columnValueView(int index) const {
+    switch (sqlite3_column_type(stmt_, index)) {
+        case SQLITE_INTEGER:
+            return columnInt64(index);
+        case SQLITE_FLOAT:
+            return columnDouble(index);
+        case SQLITE_TEXT:
+            return columnStringView(index);
+        case SQLITE_BLOB:
+            return columnBlobView(index);
+        case SQLITE_NULL:
+        default:
+            return NullValue{};
+    }
+}
+
 std::optional<int64_t> Statement::columnOptionalInt64(int index) const {
     if (isNull(index)) {
         return std::nullopt;
@@ -0,0 +1,77 @@
+/**
+ * @file statement_cache.cpp
+ * @brief Implementation of StatementCache
+ */
+
+#include "sqlite3db/statement_cache.hpp"
+
+namespace sqlite3db {
+
+StatementCache::StatementCache(size_t capacity)
+    : capacity_(capacity)
+{}
+
+StatementCache::~StatementCache() {
+    clear();
+}
+
+sqlite3_stmt* StatementCache::acquire(const std::string& sql) {
+    if (capacity_ > 0) {
+        auto it = index_.find(sql);
+        if (it != index_.end()) {
+            sqlite3_stmt* stmt = it->second->stmt;
+            entries_.erase(it->second);
+            index_.erase(it);
+            ++stats_.hits;
+            return stmt;
+        }
+    }
+    ++stats_.misses;
+    return nullptr;
+}
+
+void StatementCache::release(const std::string& sql, sqlite3_stmt* stmt) {
+    if (stmt == nullptr) {
+        return;
+    }
+
+    // Only one idle handle per SQL text; extra copies are simply finalized
+    if (capacity_ == 0 || index_.count(sql) > 0) {
+        sqlite3_finalize(stmt);
+        return;
+    }
+
+    // Hand out clean handles only: no pending row, no stale bindings.
+    // The result of reset is the last step's error, which was already reported.
+    sqlite3_reset(stmt);
+    sqlite3_clear_bindings(stmt);
+
+    entries_.push_front(Entry{sql, stmt});
+    index_.emplace(sql, entries_.begin());
+    evictOverflow();
+}
+
+void StatementCache::clear() {
+    for (auto& entry : entries_) {
+        sqlite3_finalize(entry.stmt);
+    }
+    entries_.clear();
+    index_.clear();
+}
+
+void StatementCache::setCapacity(size_t capacity) {
+    capacity_ = capacity;
+    evictOverflow();
+}
+
+void StatementCache::evictOverflow() {
+    while (entries_.size() > capacity_) {
+        Entry& victim = entries_.back();
+        sqlite3_finalize(victim.stmt);
+        index_.erase(victim.sql);
+        entries_.pop_back();
+        ++stats_.evictions;
+    }
+}
+
+} // namespace sqlite3db
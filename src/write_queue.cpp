@@ -0,0 +1,164 @@
+/**
+ * @file write_queue.cpp
+ * @brief Implementation of WriteQueue
+ */
+
+#include "sqlite3db/write_queue.hpp"
+#include "sqlite3db/transaction.hpp"
+#include <algorithm>
+
+namespace sqlite3db {
+
+WriteQueue::WriteQueue(const std::string& dbPath, const WriteQueueOptions& options)
+    : options_(options)
+    , conn_(Connection::open(dbPath, options.connectionOptions))
+{
+    options_.maxBatchSize = std::max<size_t>(options_.maxBatchSize, 1);
+    worker_ = std::thread([this] { workerLoop(); });
+}
+
+WriteQueue::~WriteQueue() {
+    stop();
+}
+
+void WriteQueue::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    workAvailable_.notify_all();
+    spaceAvailable_.notify_all();
+    if (worker_.joinable()) {
+        worker_.join();
+    }
+}
+
+void WriteQueue::enqueue(std::unique_ptr<Job> job) {
+    size_t depth = 0;
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        if (options_.maxQueueDepth > 0) {
+            // Backpressure: producers wait instead of growing the queue
+            spaceAvailable_.wait(lock, [&] {
+                return stopping_ || queue_.size() < options_.maxQueueDepth;
+            });
+        }
+        if (stopping_) {
+            throw DatabaseException("WriteQueue is stopped");
+        }
+        queue_.push_back(std::move(job));
+        depth = queue_.size();
+    }
+    // The worker only needs waking for the first job or a full batch
+    if (depth == 1 || depth >= options_.maxBatchSize) {
+        workAvailable_.notify_one();
+    }
+}
+
+std::future<int64_t> WriteQueue::submitInsert(std::string table, std::vector<std::string> columns,
+                                              std::vector<Value> values) {
+    if (columns.size() != values.size()) {
+        throw QueryException("Insert value count (" + std::to_string(values.size()) +
+                             ") doesn't match column count (" + std::to_string(columns.size()) + ")",
+                             "");
+    }
+    return submit([table = std::move(table), columns = std::move(columns),
+                   values = std::move(values)](Connection& conn) {
+        InsertBuilder insert(conn, table);
+        for (size_t i = 0; i < columns.size(); ++i) {
+            insert.value(columns[i], values[i]);
+        }
+        return insert.execute();
+    });
+}
+
+std::future<void> WriteQueue::flush() {
+    // Jobs run in order, so an empty job commits after everything before it
+    return submit([](Connection&) {});
+}
+
+WriteQueueStats WriteQueue::stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+size_t WriteQueue::pending() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return queue_.size();
+}
+
+void WriteQueue::workerLoop() {
+    std::vector<std::unique_ptr<Job>> batch;
+    batch.reserve(options_.maxBatchSize);
+
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            workAvailable_.wait(lock, [&] { return stopping_ || !queue_.empty(); });
+            if (queue_.empty()) {
+                return;  // Stopping and fully drained
+            }
+
+            if (options_.maxBatchDelay.count() > 0 && !stopping_ &&
+                queue_.size() < options_.maxBatchSize) {
+                workAvailable_.wait_for(lock, options_.maxBatchDelay, [&] {
+                    return stopping_ || queue_.size() >= options_.maxBatchSize;
+                });
+            }
+
+            size_t count = std::min(queue_.size(), options_.maxBatchSize);
+            for (size_t i = 0; i < count; ++i) {
+                batch.push_back(std::move(queue_.front()));
+                queue_.pop_front();
+            }
+        }
+        spaceAvailable_.notify_all();
+
+        commitBatch(batch);
+        batch.clear();
+    }
+}
+
+void WriteQueue::commitBatch(std::vector<std::unique_ptr<Job>>& batch) {
+    std::vector<char> succeeded(batch.size(), 0);
+    uint64_t failed = 0;
+    std::exception_ptr batchError;
+
+    try {
+        std::optional<Transaction> txn;
+        withRetry(options_.beginRetry, [&] { txn.emplace(*conn_, TransactionType::Immediate); });
+
+        for (size_t i = 0; i < batch.size(); ++i) {
+            // Isolate each job so one failure doesn't discard its neighbours
+            Transaction::Savepoint sp = txn->savepoint("write_queue_job");
+            succeeded[i] = batch[i]->run(*conn_);
+            if (succeeded[i]) {
+                sp.release();
+            } else {
+                sp.rollback();
+            }
+        }
+
+        txn->commit();
+    } catch (...) {
+        // BEGIN, a savepoint, or COMMIT failed: nothing in the batch is durable
+        batchError = std::current_exception();
+    }
+
+    for (size_t i = 0; i < batch.size(); ++i) {
+        if (succeeded[i] && !batchError) {
+            batch[i]->complete();
+        } else {
+            batch[i]->fail(batchError);
+            ++failed;
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    stats_.jobs += batch.size();
+    stats_.failedJobs += failed;
+    ++stats_.batches;
+    stats_.largestBatch = std::max<uint64_t>(stats_.largestBatch, batch.size());
+}
+
+} // namespace sqlite3db
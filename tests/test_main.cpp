@@ -14,8 +14,16 @@
  */
 
 #include <iostream>
+#include <algorithm>
 #include <cassert>
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
 #include <sstream>
+#include <thread>
+#include <atomic>
+#include <sys/stat.h>
 #include "sqlite3db/sqlite3db.hpp"
 
 using namespace sqlite3db;
@@ -52,6 +60,24 @@ using namespace sqlite3db;
     if (!caught) throw std::runtime_error("Expected " #ExceptionType " not thrown"); \
 } while(0)
 
+// File-backed database removed (with its WAL files) at end of scope,
+// for features that need more than one connection to the same database
+struct TempDatabase {
+    std::string path;
+
+    explicit TempDatabase(const std::string& name)
+        : path("sqlite3db_test_" + name + ".db") {
+        removeFiles();
+    }
+    ~TempDatabase() { removeFiles(); }
+
+    void removeFiles() const {
+        std::remove(path.c_str());
+        std::remove((path + "-wal").c_str());
+        std::remove((path + "-shm").c_str());
+    }
+};
+
 // ========== Connection Tests ==========
 
 TEST(connection_open_memory) {
@@ -75,6 +101,36 @@ TEST(connection_options) {
     ASSERT_TRUE(conn->isOpen());
 }
 
+TEST(connection_performance_pragmas) {
+    TempDatabase db("pragmas");
+    ConnectionOptions opts = ConnectionOptions::readHeavy();
+    opts.pageSize = 8192;
+    opts.walAutoCheckpoint = 500;
+    opts.threadingMode = ThreadingMode::MultiThread;
+    Connection conn(db.path, opts);
+
+    auto pragma = [&](const std::string& name) {
+        auto stmt = conn.prepare("PRAGMA " + name);
+        stmt.step();
+        return stmt.columnInt64(0);
+    };
+    ASSERT_EQ(pragma("page_size"), 8192);
+    ASSERT_EQ(pragma("cache_size"), -65536);
+    ASSERT_EQ(pragma("synchronous"), 1);   // NORMAL
+    ASSERT_EQ(pragma("temp_store"), 2);    // MEMORY
+    ASSERT_EQ(pragma("wal_autocheckpoint"), 500);
+    ASSERT_EQ(pragma("mmap_size"), int64_t(256) << 20);
+
+    ConnectionOptions bad;
+    bad.pageSize = 1000;
+    ASSERT_THROWS(Connection(db.path, bad), ConnectionException);
+
+    // "cache_size = --N" would start a comment and skip the PRAGMAs after it
+    ConnectionOptions negativeCache;
+    negativeCache.cacheSizeKiB = -1024;
+    ASSERT_THROWS(Connection(db.path, negativeCache), ConnectionException);
+}
+
 // ========== Statement Tests ==========
 
 TEST(statement_bind_and_execute) {
@@ -126,6 +182,313 @@ TEST(statement_named_parameters) {
     ASSERT_EQ(stmt.columnInt(1), 30);
 }
 
+TEST(statement_column_views) {
+    auto conn = Connection::inMemory();
+    conn->execute("CREATE TABLE test (name TEXT, data BLOB, n INTEGER, r REAL, z)");
+
+    auto insert = conn->prepare("INSERT INTO test VALUES (?, ?, 7, 1.5, NULL)");
+    insert.bind(1, "hello").bind(2, std::vector<uint8_t>{1, 2, 3}).execute();
+
+    auto stmt = conn->prepare("SELECT name, data, n, r, z FROM test");
+    ASSERT_TRUE(stmt.step());
+
+    ASSERT_TRUE(stmt.columnStringView(0) == "hello");
+    BlobView blob = stmt.columnBlobView(1);
+    ASSERT_EQ(blob.size, 3u);
+    ASSERT_EQ(int(blob[2]), 3);
+
+    ASSERT_TRUE(std::get<std::string_view>(stmt.columnValueView(0)) == "hello");
+    ASSERT_EQ(std::get<BlobView>(stmt.columnValueView(1)).size, 3u);
+    ASSERT_EQ(std::get<int64_t>(stmt.columnValueView(2)), 7);
+    ASSERT_TRUE(std::get<double>(stmt.columnValueView(3)) == 1.5);
+    ASSERT_TRUE(std::holds_alternative<NullValue>(stmt.columnValueView(4)));
+
+    // Owning copies survive the next step
+    Value owned = toValue(stmt.columnValueView(0));
+    Value ownedBlob = toValue(stmt.columnValueView(1));
+    ASSERT_TRUE(!stmt.step());
+    ASSERT_EQ(std::get<std::string>(owned), "hello");
+    ASSERT_EQ(std::get<std::vector<uint8_t>>(ownedBlob).size(), 3u);
+}
+
+// bindStatic() must not accept buffers that die at the end of the call
+template<typename Arg, typename = void>
+struct BindsStatic : std::false_type {};
+template<typename Arg>
+struct BindsStatic<Arg, std::void_t<decltype(std::declval<Statement&>().bindStatic(1, std::declval<Arg>()))>>
+    : std::true_type {};
+static_assert(BindsStatic<std::string&>::value && BindsStatic<const Value&>::value);
+static_assert(!BindsStatic<std::string>::value && !BindsStatic<Value>::value);
+static_assert(!BindsStatic<std::vector<uint8_t>>::value);
+
+TEST(statement_bind_static) {
+    auto conn = Connection::inMemory();
+    conn->execute("CREATE TABLE test (t TEXT, b BLOB, e TEXT, eb BLOB, v, s TEXT, n TEXT)");
+
+    std::string text(4096, 'x');
+    std::vector<uint8_t> bytes(1024, 0xAB);
+    Value variant = std::string("from variant");
+    std::string owned = "lvalue string";
+    const char* missing = nullptr;
+
+    auto insert = conn->prepare("INSERT INTO test VALUES (?, ?, ?, ?, ?, ?, ?)");
+    insert.bindStatic(1, std::string_view(text))
+          .bindStatic(2, BlobView{bytes.data(), bytes.size()})
+          .bindStatic(3, std::string_view())
+          .bindStatic(4, BlobView{})
+          .bindStatic(5, variant)
+          .bindStatic(6, owned)
+          .bindStatic(7, missing)
+          .execute();
+
+    auto stmt = conn->prepare(
+        "SELECT length(t), length(b), typeof(e), typeof(eb), length(eb), v, s, typeof(n) FROM test");
+    ASSERT_TRUE(stmt.step());
+    ASSERT_EQ(stmt.columnInt(0), 4096);
+    ASSERT_EQ(stmt.columnInt(1), 1024);
+    ASSERT_EQ(stmt.columnString(2), "text");  // Empty, not NULL
+    ASSERT_EQ(stmt.columnString(3), "blob");
+    ASSERT_EQ(stmt.columnInt(4), 0);
+    ASSERT_EQ(stmt.columnString(5), "from variant");
+    ASSERT_EQ(stmt.columnString(6), "lvalue string");
+    ASSERT_EQ(stmt.columnString(7), "null");
+}
+
+// ========== Statement Cache Tests ==========
+
+TEST(statement_cache_hit_and_miss) {
+    auto conn = Connection::inMemory();
+    conn->execute("CREATE TABLE test (id INTEGER PRIMARY KEY, name TEXT)");
+    conn->statementCache().resetStats();
+
+    for (int i = 0; i < 3; ++i) {
+        auto stmt = conn->prepare("INSERT INTO test (name) VALUES (?)");
+        stmt.bind(1, "row").execute();
+    }
+
+    ASSERT_EQ(conn->statementCacheStats().misses, 1u);
+    ASSERT_EQ(conn->statementCacheStats().hits, 2u);
+    ASSERT_EQ(conn->statementCache().size(), 1u);
+}
+
+TEST(statement_cache_returns_clean_handles) {
+    auto conn = Connection::inMemory();
+    conn->execute("CREATE TABLE test (id INTEGER PRIMARY KEY, name TEXT)");
+    conn->execute("INSERT INTO test (name) VALUES ('a'), ('b')");
+
+    {
+        auto stmt = conn->prepare("SELECT name FROM test WHERE name = ?");
+        stmt.bind(1, "a");
+        ASSERT_TRUE(stmt.step());  // Left mid-result on purpose
+    }
+
+    // Reused handle must be reset and have no stale bindings
+    auto stmt = conn->prepare("SELECT name FROM test WHERE name = ?");
+    ASSERT_EQ(conn->statementCacheStats().hits, 1u);
+    ASSERT_TRUE(!stmt.step());  // ? is NULL again, so no match
+}
+
+TEST(statement_cache_eviction) {
+    ConnectionOptions opts;
+    opts.statementCacheSize = 2;
+    auto conn = Connection::inMemory(opts);
+
+    conn->prepare("SELECT 1");
+    conn->prepare("SELECT 2");
+    conn->prepare("SELECT 3");  // Evicts "SELECT 1"
+
+    ASSERT_EQ(conn->statementCache().size(), 2u);
+    ASSERT_EQ(conn->statementCacheStats().evictions, 1u);
+
+    conn->prepare("SELECT 1");
+    ASSERT_EQ(conn->statementCacheStats().hits, 0u);
+}
+
+TEST(statement_cache_disabled) {
+    ConnectionOptions opts;
+    opts.statementCacheSize = 0;
+    auto conn = Connection::inMemory(opts);
+
+    conn->prepare("SELECT 1");
+    conn->prepare("SELECT 1");
+
+    ASSERT_EQ(conn->statementCache().size(), 0u);
+    ASSERT_EQ(conn->statementCacheStats().hits, 0u);
+}
+
+// ========== SQL Function Tests ==========
+
+TEST(sql_scalar_functions) {
+    auto conn = Connection::inMemory();
+    conn->execute("CREATE TABLE points (id INTEGER PRIMARY KEY, x REAL, y REAL, tag TEXT)");
+    conn->execute("INSERT INTO points (x, y, tag) VALUES (0, 0, 'a'), (3, 4, 'b'), (6, 8, NULL)");
+
+    int calls = 0;
+    conn->registerFunction("dist", [&calls](double x, double y) {
+        ++calls;
+        return std::sqrt(x * x + y * y);
+    });
+    auto near = conn->prepare("SELECT id FROM points WHERE dist(x, y) < 6 ORDER BY id");
+    std::vector<int64_t> ids;
+    while (near.step()) {
+        ids.push_back(near.columnInt64(0));
+    }
+    ASSERT_EQ(ids.size(), 2u);
+    ASSERT_EQ(ids[1], 2);
+    ASSERT_EQ(calls, 3);
+
+    // Deterministic by default, so it may back an index expression
+    conn->execute("CREATE INDEX idx_points_dist ON points (dist(x, y))");
+
+    // NULL for a non-optional parameter short-circuits to NULL
+    conn->registerFunction("shout", [](std::string_view s) { return std::string(s) + "!"; });
+    auto shout = conn->prepare("SELECT shout(tag) FROM points ORDER BY id");
+    ASSERT_TRUE(shout.step());
+    ASSERT_EQ(shout.columnString(0), "a!");
+    ASSERT_TRUE(shout.step() && shout.step());
+    ASSERT_TRUE(shout.isNull(0));
+    shout.reset();
+
+    conn->registerFunction("tag_or", [](std::optional<std::string> tag, const std::string& fallback) {
+        return tag.value_or(fallback);
+    });
+    auto tagOr = conn->prepare("SELECT tag_or(tag, 'none') FROM points WHERE id = 3");
+    ASSERT_TRUE(tagOr.step());
+    ASSERT_EQ(tagOr.columnString(0), "none");
+    tagOr.reset();
+
+    // Explicit signature for a generic callable
+    conn->registerFunction<int64_t(int64_t, int64_t)>("plus", [](auto a, auto b) { return a + b; });
+    auto add = conn->prepare("SELECT plus(40, 2)");
+    ASSERT_TRUE(add.step());
+    ASSERT_EQ(add.columnInt64(0), 42);
+    add.reset();
+
+    // Exceptions become SQL errors
+    conn->registerFunction("fail", [](int64_t) -> int64_t { throw std::runtime_error("no good"); });
+    bool failed = false;
+    try {
+        conn->execute("SELECT fail(1)");
+    } catch (const QueryException& e) {
+        failed = std::string(e.what()).find("no good") != std::string::npos;
+    }
+    ASSERT_TRUE(failed);
+
+    conn->removeFunction("fail", 1);
+    ASSERT_THROWS(conn->execute("SELECT fail(1)"), QueryException);
+}
+
+struct MedianAggregate {
+    std::vector<double> values;
+    void step(double v) { values.push_back(v); }
+    std::optional<double> finalize() {
+        if (values.empty()) {
+            return std::nullopt;
+        }
+        std::sort(values.begin(), values.end());
+        size_t mid = values.size() / 2;
+        return values.size() % 2 ? values[mid] : (values[mid - 1] + values[mid]) / 2;
+    }
+};
+
+struct SumSquares {
+    int64_t total = 0;
+    void step(int64_t v) { total += v * v; }
+    void inverse(int64_t v) { total -= v * v; }
+    int64_t value() const { return total; }
+    int64_t finalize() const { return total; }
+};
+
+TEST(sql_aggregate_and_window_functions) {
+    auto conn = Connection::inMemory();
+    conn->execute("CREATE TABLE m (grp TEXT, v INTEGER)");
+    conn->execute("INSERT INTO m VALUES ('a', 1), ('a', 5), ('a', 2), ('b', 4), ('b', NULL), ('b', 8)");
+
+    conn->registerAggregate<MedianAggregate>("median");
+    auto median = conn->prepare("SELECT grp, median(v) FROM m GROUP BY grp ORDER BY grp");
+    ASSERT_TRUE(median.step());
+    ASSERT_EQ(median.columnDouble(1), 2.0);
+    ASSERT_TRUE(median.step());
+    ASSERT_EQ(median.columnDouble(1), 6.0);  // NULL row skipped
+    median.reset();
+
+    auto empty = conn->prepare("SELECT median(v) FROM m WHERE grp = 'z'");
+    ASSERT_TRUE(empty.step());
+    ASSERT_TRUE(empty.isNull(0));
+    empty.reset();
+
+    conn->registerAggregate<SumSquares>("sumsq");
+    auto total = conn->prepare("SELECT sumsq(v) FROM m");
+    ASSERT_TRUE(total.step());
+    ASSERT_EQ(total.columnInt64(0), 110);
+    total.reset();
+
+    // Sliding window of two rows uses inverse()
+    auto window = conn->prepare(
+        "SELECT sumsq(v) OVER (ORDER BY rowid ROWS BETWEEN 1 PRECEDING AND CURRENT ROW) "
+        "FROM m WHERE grp = 'a' ORDER BY rowid");
+    std::vector<int64_t> sums;
+    while (window.step()) {
+        sums.push_back(window.columnInt64(0));
+    }
+    ASSERT_EQ(sums.size(), 3u);
+    ASSERT_EQ(sums[0], 1);
+    ASSERT_EQ(sums[1], 26);
+    ASSERT_EQ(sums[2], 29);
+}
+
+// ========== Profiler Tests ==========
+
+TEST(profiler_collects_statement_stats) {
+    auto conn = Connection::inMemory();
+    conn->execute("CREATE TABLE t (id INTEGER PRIMARY KEY, v INTEGER)");
+    for (int i = 0; i < 10; ++i) {
+        conn->execute("INSERT INTO t (v) VALUES (" + std::to_string(i) + ")");
+    }
+
+    ProfilingOptions opts;
+    opts.countRows = true;
+    conn->enableProfiling(opts);
+
+    const std::string sql = "SELECT id FROM t WHERE v >= ?";
+    for (int i = 0; i < 3; ++i) {
+        auto stmt = conn->prepare(sql);
+        stmt.bind(1, 5);
+        while (stmt.step()) {}
+    }
+
+    QueryStats stats = conn->profiler()->stats(sql);
+    ASSERT_EQ(stats.executions, 3u);
+    ASSERT_EQ(stats.rows, 15u);
+    ASSERT_TRUE(stats.fullScanSteps > 0);  // No index on v
+    ASSERT_TRUE(stats.vmSteps > 0);
+    ASSERT_TRUE(stats.maxNs >= stats.minNs);
+    ASSERT_TRUE(stats.percentileNs(50) <= stats.maxNs);
+    ASSERT_EQ(conn->profiler()->totalExecutions(), 3u);
+
+    conn->disableProfiling();
+    ASSERT_TRUE(conn->profiler() == nullptr);
+    conn->execute("SELECT 1");  // No longer traced
+}
+
+TEST(profiler_slow_query_callback) {
+    auto conn = Connection::inMemory();
+
+    std::vector<SlowQuery> slow;
+    ProfilingOptions opts;
+    opts.slowQueryThreshold = std::chrono::microseconds(1);
+    opts.onSlowQuery = [&](const SlowQuery& q) { slow.push_back(q); };
+    conn->enableProfiling(opts);
+
+    conn->execute("WITH RECURSIVE n(x) AS (SELECT 1 UNION ALL SELECT x + 1 FROM n WHERE x < 20000) "
+                  "SELECT x FROM n ORDER BY x DESC");
+
+    ASSERT_EQ(slow.size(), 1u);
+    ASSERT_TRUE(slow[0].sql.find("RECURSIVE") != std::string::npos);
+    ASSERT_TRUE(slow[0].sorts > 0);
+    ASSERT_EQ(conn->profiler()->slowQueries(), 1u);
+}
+
 // ========== Transaction Tests ==========
 
 TEST(transaction_commit) {
@@ -253,6 +616,91 @@ TEST(migration_partial) {
     ASSERT_TRUE(!conn->tableExists("v3"));
 }
 
+TEST(migration_baseline_and_single_transaction) {
+    MigrationManager history;
+    for (int v = 1; v <= 40; ++v) {
+        history.add(v, "t" + std::to_string(v), [v](Connection& db) {
+            db.execute("CREATE TABLE t" + std::to_string(v) + " (id INTEGER PRIMARY KEY)");
+        });
+    }
+
+    // Squash 1..40 from a fully migrated database
+    auto source = Connection::inMemory();
+    history.apply(*source);
+    std::string snapshot = MigrationManager::snapshotSchema(*source);
+    ASSERT_TRUE(snapshot.find("__migrations") == std::string::npos);
+
+    bool replayed = false;
+    history.add(41, "t41", [&](Connection& db) {
+        replayed = true;
+        db.execute("CREATE TABLE t41 (id INTEGER PRIMARY KEY)");
+    });
+    history.setBaseline(40, snapshot);
+    history.setSingleTransaction();
+
+    auto fresh = Connection::inMemory();
+    history.apply(*fresh);
+    ASSERT_EQ(history.currentVersion(*fresh), 41);
+    ASSERT_TRUE(fresh->tableExists("t17") && fresh->tableExists("t41"));
+    ASSERT_TRUE(replayed);
+    auto recorded = fresh->prepare("SELECT COUNT(*) FROM __migrations");
+    recorded.step();
+    ASSERT_EQ(recorded.columnInt(0), 41);
+
+    // A database older than the baseline upgrades through the migrations
+    auto old = Connection::inMemory();
+    history.applyTo(*old, 3);
+    history.apply(*old);
+    ASSERT_EQ(history.currentVersion(*old), 41);
+
+    // A failure keeps none of the group
+    history.add(42, "ok", [](Connection& db) { db.execute("CREATE TABLE t42 (id INTEGER)"); });
+    history.add(43, "broken", [](Connection& db) { db.execute("CREATE TABLE t1 (id INTEGER)"); });
+    try {
+        history.apply(*fresh);
+        ASSERT_TRUE(false);
+    } catch (const MigrationException& e) {
+        ASSERT_EQ(e.version(), 43);
+    }
+    ASSERT_EQ(history.currentVersion(*fresh), 41);
+    ASSERT_TRUE(!fresh->tableExists("t42"));
+}
+
+TEST(migration_baseline_concurrent_cold_start) {
+    TempDatabase db("migration_cold_start");
+    const std::string schema =
+        "CREATE TABLE a (id INTEGER PRIMARY KEY); CREATE TABLE b (id INTEGER PRIMARY KEY);";
+    MigrationManager migrations;
+    migrations.add(1, "a", [](Connection& c) { c.execute("CREATE TABLE a (id INTEGER PRIMARY KEY)"); });
+    migrations.add(2, "b", [](Connection& c) { c.execute("CREATE TABLE b (id INTEGER PRIMARY KEY)"); });
+    migrations.setBaseline(2, schema);
+
+    // The other instance holds the write lock while it applies the baseline
+    Connection other(db.path);
+    ASSERT_EQ(migrations.currentVersion(other), 0);
+    other.execute("BEGIN IMMEDIATE");
+
+    // This one sees an empty database, then has to wait for the lock
+    Connection conn(db.path);
+    std::string error;
+    std::thread starter([&] {
+        try {
+            migrations.apply(conn);
+        } catch (const std::exception& e) {
+            error = e.what();
+        }
+    });
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    other.execute(schema);
+    other.execute("INSERT INTO __migrations (version, description) VALUES (1, 'a'), (2, 'b')");
+    other.execute("COMMIT");
+    starter.join();
+
+    ASSERT_EQ(error, std::string());
+    ASSERT_EQ(migrations.currentVersion(conn), 2);
+}
+
 // ========== Schema Validator Tests ==========
 
 TEST(schema_validator_pass) {
@@ -284,6 +732,174 @@ TEST(schema_validator_fail) {
     ASSERT_EQ(errors.size(), 2);
 }
 
+TEST(schema_catalog_snapshot) {
+    auto conn = Connection::inMemory();
+    conn->execute("CREATE TABLE Users (id INTEGER PRIMARY KEY, email TEXT NOT NULL UNIQUE)");
+    conn->execute("CREATE INDEX idx_users_email ON users(email)");
+    conn->execute("CREATE VIEW active AS SELECT id FROM users");
+
+    auto schema = conn->schemaCatalog();
+    const TableInfo* users = schema->table("users");
+    ASSERT_TRUE(users != nullptr && !users->isView);
+    ASSERT_EQ(users->name, "Users");
+    ASSERT_EQ(users->columns.size(), 2);
+    ASSERT_EQ(users->columns[0].primaryKey, 1);
+    ASSERT_TRUE(users->column("EMAIL") && users->column("EMAIL")->notNull);
+    ASSERT_TRUE(users->index("idx_users_email") != nullptr);
+    ASSERT_EQ(users->indexes.size(), 2);  // Plus the UNIQUE autoindex
+    ASSERT_TRUE(schema->table("active")->isView);
+
+    // Unchanged schema: the same snapshot
+    ASSERT_TRUE(conn->schemaCatalog() == schema);
+
+    SchemaValidator validator;
+    validator.requireTable("users")
+             .requireTable("active")  // A view, not a table
+             .requireColumn("users", "email", "TEXT")
+             .requireNotNull("users", "id")
+             .requireIndex("users", "idx_missing");
+    ASSERT_EQ(validator.validate(*schema).size(), 3);
+
+    // A schema change from another statement is picked up
+    conn->execute("ALTER TABLE users ADD COLUMN age INTEGER");
+    auto reloaded = conn->schemaCatalog();
+    ASSERT_TRUE(reloaded != schema);
+    ASSERT_TRUE(reloaded->table("users")->column("age") != nullptr);
+    ASSERT_TRUE(schema->table("users")->column("age") == nullptr);
+}
+
+TEST(schema_catalog_tolerates_stale_views) {
+    auto conn = Connection::inMemory();
+    conn->execute("CREATE TABLE users (id INTEGER PRIMARY KEY, zeta TEXT, alpha TEXT, mid TEXT)");
+    conn->execute("CREATE TABLE t (a INTEGER)");
+    conn->execute("CREATE VIEW v AS SELECT a FROM t");
+    conn->execute("CREATE VIEW names AS SELECT alpha, zeta FROM users");
+    conn->execute("DROP TABLE t");
+
+    auto schema = conn->schemaCatalog();
+    ASSERT_TRUE(schema->table("v") != nullptr && schema->table("v")->isView);
+    ASSERT_TRUE(schema->table("v")->columns.empty());
+    ASSERT_EQ(schema->table("names")->columns.size(), 2u);
+    ASSERT_EQ(schema->table("names")->columns[0].name, "alpha");
+
+    // Declaration order, not name order
+    const auto& cols = schema->table("users")->columns;
+    ASSERT_EQ(cols.size(), 4u);
+    ASSERT_EQ(cols[1].name, "zeta");
+    ASSERT_EQ(cols[3].name, "mid");
+
+    SchemaValidator validator;
+    validator.requireTable("users");
+    ASSERT_EQ(validator.validate(*conn).size(), 0u);
+}
+
+// ========== Index Advisor Tests ==========
+
+TEST(index_advisor_suggests_and_migrates) {
+    auto conn = Connection::inMemory();
+    conn->executeScript(R"(
+        CREATE TABLE users (id INTEGER PRIMARY KEY, email TEXT);
+        CREATE INDEX idx_users_email ON users (email);
+        CREATE TABLE orders (id INTEGER PRIMARY KEY, user_id INTEGER, created_at INTEGER, total REAL);
+        INSERT INTO users (email) VALUES ('a@x'), ('b@x');
+        INSERT INTO orders (user_id, created_at, total) VALUES (1, 10, 5.0), (1, 20, 7.5), (2, 15, 1.0);
+    )");
+
+    IndexAdvisor advisor(*conn);
+    QueryBuilder recent(*conn, "orders");
+    recent.where("user_id", "=", Value{int64_t{1}}).orderBy("created_at");
+    QueryAnalysis analysis = advisor.analyze(recent);
+
+    ASSERT_TRUE(!analysis.clean());
+    bool scan = false;
+    bool sort = false;
+    for (const auto& issue : analysis.issues) {
+        scan = scan || (issue.kind == PlanIssueKind::FullScan && issue.table == "orders");
+        sort = sort || issue.kind == PlanIssueKind::TempBTree;
+    }
+    ASSERT_TRUE(scan && sort);
+    ASSERT_EQ(analysis.suggestions.size(), 1u);
+    ASSERT_EQ(analysis.suggestions[0].createSql(),
+              "CREATE INDEX IF NOT EXISTS idx_orders_user_id_created_at ON \"orders\" (\"user_id\", \"created_at\")");
+
+    // Aliases resolve to their tables
+    QueryAnalysis join = advisor.analyze(
+        "SELECT u.email, o.total FROM users AS u JOIN orders o ON o.user_id = u.id WHERE u.email = ?");
+    ASSERT_EQ(join.issues.size(), 1u);
+    ASSERT_EQ(join.issues[0].table, "orders");
+    ASSERT_EQ(join.suggestions.size(), 1u);
+    ASSERT_EQ(join.suggestions[0].name(), "idx_orders_user_id");
+
+    // (user_id) is a prefix of (user_id, created_at), which serves both
+    auto merged = advisor.suggestions();
+    ASSERT_EQ(merged.size(), 1u);
+    ASSERT_EQ(merged[0].name(), "idx_orders_user_id_created_at");
+
+    SchemaValidator validator;
+    validator.requireIndex("users", "idx_users_email")
+             .requireIndex("orders", "idx_orders_user_id_created_at");
+    ASSERT_EQ(advisor.checkRequiredIndexes(validator).size(), 2u);  // Neither plan used them
+
+    MigrationManager migrations;
+    migrations.add(advisor.toMigration(1));
+    migrations.apply(*conn);
+    ASSERT_TRUE(conn->schemaCatalog()->table("orders")->index("idx_orders_user_id_created_at"));
+
+    advisor.clear();
+    QueryAnalysis after = advisor.analyze(recent);
+    ASSERT_TRUE(after.clean());
+    ASSERT_TRUE(after.suggestions.empty());
+    advisor.analyze("SELECT id FROM users WHERE email = 'a@x'");
+    ASSERT_TRUE(advisor.checkRequiredIndexes(validator).empty());
+
+    // Nothing to index for an unfiltered scan
+    QueryAnalysis all = advisor.analyze("SELECT * FROM orders");
+    ASSERT_EQ(all.issues.size(), 1u);
+    ASSERT_TRUE(all.suggestions.empty());
+}
+
+TEST(index_advisor_quotes_keyword_columns) {
+    auto conn = Connection::inMemory();
+    conn->execute("CREATE TABLE lines (id INTEGER PRIMARY KEY, \"order\" INTEGER, \"group\" TEXT)");
+
+    IndexAdvisor advisor(*conn);
+    QueryAnalysis analysis = advisor.analyze(
+        "SELECT id FROM lines WHERE \"order\" = ? ORDER BY \"group\"");
+    ASSERT_EQ(analysis.suggestions.size(), 1u);
+    ASSERT_EQ(analysis.suggestions[0].createSql(),
+              "CREATE INDEX IF NOT EXISTS idx_lines_order_group ON \"lines\" (\"order\", \"group\")");
+
+    MigrationManager migrations;
+    migrations.add(advisor.toMigration(1));
+    migrations.apply(*conn);
+    ASSERT_TRUE(advisor.analyze("SELECT id FROM lines WHERE \"order\" = ? ORDER BY \"group\"").clean());
+}
+
+TEST(index_advisor_reads_profile) {
+    auto conn = Connection::inMemory();
+    conn->execute("CREATE TABLE events (id INTEGER PRIMARY KEY, kind TEXT, at INTEGER)");
+    conn->execute("WITH RECURSIVE n(x) AS (SELECT 1 UNION ALL SELECT x + 1 FROM n WHERE x < 200) "
+                  "INSERT INTO events (kind, at) SELECT 'k' || (x % 5), x FROM n");
+    conn->enableProfiling();
+
+    for (int i = 0; i < 3; ++i) {
+        auto stmt = conn->prepare("SELECT count(*) FROM events WHERE kind = ? AND at > ?");
+        stmt.bind(1, "k1").bind(2, 50);
+        ASSERT_TRUE(stmt.step());
+    }
+    auto point = conn->prepare("SELECT kind FROM events WHERE id = ?");
+    point.bind(1, 7);
+    ASSERT_TRUE(point.step());
+    point.reset();
+
+    IndexAdvisor advisor(*conn);
+    auto results = advisor.analyzeProfile(*conn->profiler());
+    ASSERT_EQ(results.size(), 1u);  // The rowid lookup doesn't scan
+    ASSERT_EQ(results[0].suggestions.size(), 1u);
+    ASSERT_EQ(results[0].suggestions[0].name(), "idx_events_kind_at");
+    ASSERT_TRUE(results[0].planText().find("SCAN events") != std::string::npos);
+}
+
 // ========== Query Builder Tests ==========
 
 TEST(query_builder_select) {
@@ -317,6 +933,326 @@ TEST(query_builder_count) {
     ASSERT_EQ(count, 2);
 }
 
+TEST(query_builder_stream) {
+    auto conn = Connection::inMemory();
+    conn->execute("CREATE TABLE users (id INTEGER PRIMARY KEY, name TEXT, age INTEGER)");
+    conn->execute("INSERT INTO users (name, age) VALUES ('Alice', 30), ('Bob', 25), ('Carol', 41)");
+
+    QueryBuilder qb(*conn, "users");
+    qb.select("name, age").where("age", ">", Value{int64_t(26)}).orderBy("age");
+
+    std::vector<std::string> names;
+    for (const Row& row : qb.stream()) {
+        names.emplace_back(row.text(0));
+        ASSERT_TRUE(row.int64(1) > 26);
+    }
+    ASSERT_EQ(names.size(), 2u);
+    ASSERT_EQ(names[0], "Alice");
+    ASSERT_EQ(names[1], "Carol");
+
+    // Early exit releases the statement
+    int seen = 0;
+    for (const Row& row : QueryBuilder(*conn, "users").stream()) {
+        (void)row;
+        if (++seen == 1) break;
+    }
+    ASSERT_EQ(seen, 1);
+    conn->execute("DROP TABLE users");  // Would fail if a statement were still running
+}
+
+TEST(query_builder_compiled) {
+    auto conn = Connection::inMemory();
+    conn->execute("CREATE TABLE users (id INTEGER PRIMARY KEY, name TEXT UNIQUE, age INTEGER)");
+
+    auto insert = InsertBuilder(*conn, "users").value("name", Value{""}).value("age", Value{int64_t(0)}).compile();
+    ASSERT_EQ(insert.sql(), "INSERT INTO users (name, age) VALUES (?, ?)");
+    ASSERT_EQ(insert.execute({Value{"Alice"}, Value{int64_t(30)}}), 1);
+    ASSERT_EQ(insert.execute({Value{"Bob"}, Value{int64_t(25)}}), 2);
+    ASSERT_THROWS(insert.execute({Value{"Carol"}}), QueryException);
+
+    auto upsert = InsertBuilder(*conn, "users").value("name", Value{""}).value("age", Value{int64_t(0)})
+                      .compileUpsert();
+    upsert.execute({Value{"Bob"}, Value{int64_t(26)}});
+
+    auto olderThan = QueryBuilder(*conn, "users")
+                         .select("name")
+                         .where("age", ">", Value{int64_t(20)})
+                         .orderBy("name")
+                         .compile();
+    ASSERT_EQ(olderThan.parameterCount(), 1);
+    ASSERT_EQ(olderThan.fetchAll().size(), 2u);  // Builder's value
+    ASSERT_EQ(olderThan.fetchAll({Value{int64_t(28)}}).size(), 1u);
+
+    auto one = olderThan.fetchOne({Value{int64_t(0)}});
+    ASSERT_EQ(std::get<std::string>((*one)[0]), "Alice");
+    ASSERT_TRUE(!olderThan.fetchOne({Value{int64_t(99)}}).has_value());
+    ASSERT_EQ(olderThan.fetchResultSet({Value{int64_t(0)}}).rowCount(), 2u);
+
+    int visited = 0;
+    olderThan.forEach({Value{int64_t(0)}}, [&](const Row& row) {
+        visited += row.text(0) == "Bob" ? 1 : 0;
+    });
+    ASSERT_EQ(visited, 1);
+
+    // Re-runs reuse the checked-out statement instead of preparing again
+    conn->statementCache().resetStats();
+    for (int i = 0; i < 5; ++i) {
+        olderThan.fetchAll({Value{int64_t(i)}});
+    }
+    ASSERT_EQ(conn->statementCacheStats().hits + conn->statementCacheStats().misses, 0u);
+}
+
+// ========== Result Cache Tests ==========
+
+TEST(result_cache_hits_and_invalidates) {
+    auto conn = Connection::inMemory();
+    conn->execute("CREATE TABLE settings (id INTEGER PRIMARY KEY, scope TEXT, value TEXT)");
+    conn->execute("INSERT INTO settings (scope, value) VALUES ('ui', 'dark'), ('net', 'fast')");
+    conn->enableResultCache();
+
+    auto query = [&](const std::string& scope) {
+        return QueryBuilder(*conn, "settings").where("scope", "=", scope).cached().fetchAll();
+    };
+
+    ASSERT_EQ(query("ui").size(), 1u);
+    ASSERT_EQ(query("ui").size(), 1u);
+    ASSERT_EQ(query("net").size(), 1u);
+    ASSERT_EQ(conn->resultCache()->stats().hits, 1u);
+    ASSERT_EQ(conn->resultCache()->stats().misses, 2u);
+
+    // A write through this connection drops results for that table
+    conn->execute("INSERT INTO settings (scope, value) VALUES ('ui', 'compact')");
+    ASSERT_EQ(query("ui").size(), 2u);
+    ASSERT_EQ(conn->resultCache()->stats().invalidations, 1u);
+
+    ASSERT_EQ(QueryBuilder(*conn, "settings").cached().count(), 3);
+    ASSERT_EQ(QueryBuilder(*conn, "settings").cached().count(), 3);
+    ASSERT_EQ(conn->resultCache()->stats().hits, 2u);
+
+    // Builders that don't opt in bypass the cache
+    QueryBuilder(*conn, "settings").fetchAll();
+    ASSERT_EQ(conn->resultCache()->stats().hits + conn->resultCache()->stats().misses, 6u);
+}
+
+TEST(result_cache_count_has_own_keys) {
+    auto conn = Connection::inMemory();
+    conn->execute("CREATE TABLE events (id INTEGER PRIMARY KEY, kind TEXT)");
+    conn->enableResultCache();
+
+    // Same SQL as count(); with GROUP BY on an empty table it caches no rows
+    auto grouped = [&] { return QueryBuilder(*conn, "events").groupBy("kind").cached(); };
+    ASSERT_EQ(grouped().select("COUNT(*)").fetchAll().size(), 0u);
+    ASSERT_EQ(grouped().count(), 0);
+    ASSERT_EQ(grouped().count(), 0);
+    ASSERT_EQ(conn->resultCache()->stats().hits, 1u);
+}
+
+TEST(result_cache_skips_uncommitted_and_external_writes) {
+    TempDatabase db("result_cache");
+    Connection conn(db.path);
+    conn.execute("CREATE TABLE items (id INTEGER PRIMARY KEY, name TEXT)");
+    conn.execute("INSERT INTO items (name) VALUES ('a')");
+    conn.enableResultCache();
+
+    auto count = [&] { return QueryBuilder(conn, "items").cached().count(); };
+
+    // Rows seen inside a writing transaction must not outlive a rollback
+    {
+        Transaction txn(conn);
+        conn.execute("INSERT INTO items (name) VALUES ('b')");
+        ASSERT_EQ(count(), 2);
+    }
+    ASSERT_EQ(count(), 1);
+    ASSERT_EQ(count(), 1);
+    ASSERT_EQ(conn.resultCache()->stats().hits, 1u);
+
+    // A commit by another connection clears the cache
+    Connection other(db.path);
+    other.execute("INSERT INTO items (name) VALUES ('c')");
+    ASSERT_EQ(count(), 2);
+    ASSERT_EQ(conn.resultCache()->stats().fullClears, 1u);
+}
+
+// ========== Resource Limit Tests ==========
+
+TEST(memory_stats_and_sql_limits) {
+    ConnectionOptions opts;
+    opts.maxVariables = 10;
+    opts.maxSqlLength = 2000;
+    auto conn = Connection::inMemory(opts);
+    conn->execute("CREATE TABLE items (id INTEGER PRIMARY KEY, name TEXT)");
+    conn->execute("WITH RECURSIVE n(x) AS (SELECT 1 UNION ALL SELECT x + 1 FROM n WHERE x < 500) "
+                  "INSERT INTO items (name) SELECT printf('item %d', x) FROM n");
+    ASSERT_EQ(QueryBuilder(*conn, "items").count(), 500);
+
+    ConnectionMemoryStats mem = conn->memoryStats(true);
+    ASSERT_TRUE(mem.cacheBytes > 0);
+    ASSERT_TRUE(mem.schemaBytes > 0);
+    ASSERT_TRUE(mem.totalBytes() >= mem.cacheBytes + mem.schemaBytes);
+    ASSERT_EQ(conn->memoryStats().cacheHits, 0);
+    QueryBuilder(*conn, "items").count();
+    ASSERT_TRUE(conn->memoryStats().cacheHits > 0);
+    ASSERT_TRUE(conn->memoryStats().cacheHitRate() > 0.0);
+    ASSERT_TRUE(libraryMemoryStats().usedBytes > 0);
+
+    // Too many placeholders or too much SQL fails at prepare time
+    ASSERT_EQ(conn->limit(SqlLimit::VariableNumber), 10);
+    ASSERT_THROWS(conn->prepare("SELECT * FROM items WHERE id IN (?1, ?2, ?11)"), QueryException);
+    ASSERT_THROWS(conn->execute("SELECT '" + std::string(3000, 'x') + "'"), QueryException);
+
+    ASSERT_EQ(conn->setLimit(SqlLimit::VariableNumber, 20), 10);
+    conn->prepare("SELECT * FROM items WHERE id IN (?1, ?2, ?11)");
+    ASSERT_THROWS(conn->setLimit(SqlLimit::Length, -1), DatabaseException);
+}
+
+TEST(query_timeout_interrupts_long_statements) {
+    ConnectionOptions opts;
+    opts.queryTimeout = std::chrono::milliseconds(50);
+    auto conn = Connection::inMemory(opts);
+    const std::string endless =
+        "WITH RECURSIVE n(x) AS (SELECT 1 UNION ALL SELECT x + 1 FROM n) SELECT count(*) FROM n";
+
+    auto stmt = conn->prepare(endless);
+    bool timedOut = false;
+    try {
+        stmt.step();
+    } catch (const InterruptedException& e) {
+        timedOut = std::string(e.what()).find("50 ms timeout") != std::string::npos;
+    }
+    ASSERT_TRUE(timedOut);
+    ASSERT_THROWS(conn->execute(endless), InterruptedException);
+    ASSERT_EQ(conn->queryWatchdog()->timeouts(), 2u);
+
+    // Each call gets a fresh deadline; short statements are unaffected
+    auto quick = conn->prepare("SELECT 7");
+    ASSERT_TRUE(quick.step());
+    ASSERT_EQ(quick.columnInt(0), 7);
+
+    conn->setQueryTimeout(std::chrono::milliseconds(0));
+    conn->execute("WITH RECURSIVE n(x) AS (SELECT 1 UNION ALL SELECT x + 1 FROM n WHERE x < 100000) "
+                  "SELECT count(*) FROM n");
+    ASSERT_EQ(conn->queryWatchdog()->timeouts(), 2u);
+}
+
+// ========== Columnar Tests ==========
+
+TEST(columnar_reader_fills_typed_batches) {
+    auto conn = Connection::inMemory();
+    conn->execute("CREATE TABLE trades (id INTEGER PRIMARY KEY, price REAL, symbol TEXT, note BLOB)");
+    for (int i = 1; i <= 7; ++i) {
+        auto stmt = conn->prepare("INSERT INTO trades (price, symbol, note) VALUES (?, ?, ?)");
+        stmt.bind(1, i * 1.5);
+        if (i % 3 == 0) {
+            stmt.bind(2, NullValue{});
+        } else {
+            stmt.bind(2, "S" + std::to_string(i));
+        }
+        stmt.bind(3, std::vector<uint8_t>(static_cast<size_t>(i), 0xAB));
+        stmt.execute();
+    }
+
+    ColumnarOptions opts;
+    opts.batchSize = 3;
+    auto reader = QueryBuilder(*conn, "trades").orderBy("id").columnar(opts);
+
+    RecordBatch batch;
+    std::vector<size_t> sizes;
+    int64_t idSum = 0;
+    double priceSum = 0;
+    size_t nulls = 0;
+    while (reader.next(batch)) {
+        sizes.push_back(batch.rows);
+        const ColumnBuffer& ids = batch.column("id");
+        const ColumnBuffer& symbols = batch.column("symbol");
+        ASSERT_TRUE(ids.type == ColumnType::Integer);
+        ASSERT_TRUE(symbols.type == ColumnType::Text);
+        ASSERT_EQ(ids.ints.size(), batch.rows);
+        ASSERT_EQ(symbols.offsets.size(), batch.rows + 1);
+        for (size_t r = 0; r < batch.rows; ++r) {
+            idSum += ids.ints[r];
+            priceSum += batch.column("price").reals[r];
+            if (!symbols.isNull(r)) {
+                ASSERT_EQ(std::string(symbols.text(r)), "S" + std::to_string(ids.ints[r]));
+            }
+            ASSERT_EQ(batch.column("note").blob(r).size, static_cast<size_t>(ids.ints[r]));
+        }
+        nulls += symbols.nullCount;
+    }
+
+    ASSERT_EQ(sizes.size(), 3u);
+    ASSERT_EQ(sizes[2], 1u);
+    ASSERT_EQ(idSum, 28);
+    ASSERT_TRUE(std::abs(priceSum - 42.0) < 1e-9);
+    ASSERT_EQ(nulls, 2u);
+    ASSERT_EQ(batch.rows, 0u);
+    ASSERT_TRUE(!reader.next(batch));
+}
+
+TEST(columnar_reader_types_expressions) {
+    auto conn = Connection::inMemory();
+
+    // No declared types: inferred from the first row, or forced by options
+    ColumnarReader inferred(conn->prepare("SELECT 1, 2.5, 'x', NULL"));
+    RecordBatch batch;
+    ASSERT_TRUE(inferred.next(batch));
+    ASSERT_TRUE(inferred.types()[0] == ColumnType::Integer);
+    ASSERT_TRUE(inferred.types()[1] == ColumnType::Real);
+    ASSERT_TRUE(inferred.types()[2] == ColumnType::Text);
+    ASSERT_TRUE(batch.column(3).isNull(0));
+
+    ColumnarOptions opts;
+    opts.types = {ColumnType::Real, ColumnType::Text};
+    ColumnarReader forced(conn->prepare("SELECT 7, 42"), opts);
+    ASSERT_TRUE(forced.next(batch));
+    ASSERT_TRUE(batch.column(0).reals[0] == 7.0);
+    ASSERT_EQ(std::string(batch.column(1).text(0)), "42");
+}
+
+// ========== Result Set Tests ==========
+
+TEST(result_set_matches_fetch_all) {
+    auto conn = Connection::inMemory();
+    conn->execute("CREATE TABLE docs (id INTEGER PRIMARY KEY, title TEXT, score REAL, body BLOB)");
+    conn->execute("INSERT INTO docs (title, score, body) VALUES ('first', 1.5, x'0102'), "
+                  "('', NULL, NULL), ('a longer title that needs the heap', 3.0, x'FF')");
+
+    ResultSet moved = QueryBuilder(*conn, "docs").orderBy("id").fetchResultSet();
+    std::string_view title = moved[0].text(1);
+    ResultSet docs = std::move(moved);  // Views survive the move
+
+    ASSERT_EQ(docs.rowCount(), 3u);
+    ASSERT_EQ(docs.columnCount(), 4);
+    ASSERT_EQ(docs.columnIndex("score"), 2);
+    ASSERT_EQ(docs.columnIndex("missing"), -1);
+    ASSERT_EQ(std::string(title), "first");
+    ASSERT_EQ(docs[1].text(1).size(), 0u);
+    ASSERT_TRUE(docs[1].isNull(2));
+    ASSERT_EQ(docs[0].blob(3).size, 2u);
+    ASSERT_TRUE(docs[2].real(2) == 3.0);
+
+    // Same values as the row-major API; all strings share one block
+    auto copied = docs.toValues();
+    auto fetched = QueryBuilder(*conn, "docs").orderBy("id").fetchAll();
+    ASSERT_EQ(copied.size(), fetched.size());
+    for (size_t r = 0; r < fetched.size(); ++r) {
+        for (size_t c = 0; c < fetched[r].size(); ++c) {
+            ASSERT_EQ(copied[r][c].index(), fetched[r][c].index());
+        }
+    }
+    ASSERT_EQ(std::get<std::string>(copied[2][1]), std::get<std::string>(fetched[2][1]));
+    ASSERT_EQ(docs.arenaBlocks(), 1u);
+
+    size_t rows = 0;
+    for (const auto& row : docs) {
+        rows += row.values().size() == 4 ? 1 : 0;
+    }
+    ASSERT_EQ(rows, 3u);
+
+    ResultSet none = QueryBuilder(*conn, "docs").where("id", "<", Value{int64_t(0)}).fetchResultSet();
+    ASSERT_TRUE(none.empty());
+    ASSERT_EQ(none.columnName(1), "title");
+}
+
 // ========== Batch Insert Tests ==========
 
 TEST(batch_insert) {
@@ -337,6 +1273,923 @@ TEST(batch_insert) {
     ASSERT_EQ(stmt.columnInt64(0), 100);
 }
 
+TEST(batch_insert_multi_row_values) {
+    auto conn = Connection::inMemory();
+    conn->execute("CREATE TABLE items (id INTEGER PRIMARY KEY, name TEXT, value INTEGER)");
+
+    // Lower the variable limit so chunking and the partial tail are exercised
+    sqlite3_limit(conn->handle(), SQLITE_LIMIT_VARIABLE_NUMBER, 10);
+
+    BatchInsertBuilder batch(*conn, "items", {"name", "value"});
+    batch.setMultiRowValues().setBatchSize(12);
+    ASSERT_EQ(batch.rowsPerStatement(), 5u);
+
+    for (int i = 0; i < 103; ++i) {
+        batch.addRow({Value{"item" + std::to_string(i)}, Value{int64_t(i)}});
+    }
+
+    ASSERT_EQ(batch.execute(), 103);
+
+    auto stmt = conn->prepare("SELECT COUNT(*), SUM(value), MAX(name) FROM items");
+    stmt.step();
+    ASSERT_EQ(stmt.columnInt64(0), 103);
+    ASSERT_EQ(stmt.columnInt64(1), 103 * 102 / 2);
+    ASSERT_EQ(stmt.columnString(2), "item99");
+}
+
+TEST(batch_upsert_updates_in_place) {
+    auto conn = Connection::inMemory();
+    conn->execute("CREATE TABLE products (id INTEGER PRIMARY KEY, sku TEXT UNIQUE, name TEXT, price REAL)");
+    conn->execute("CREATE TABLE deletions (n INTEGER)");
+    conn->execute("CREATE TRIGGER products_deleted AFTER DELETE ON products "
+                  "BEGIN INSERT INTO deletions VALUES (1); END");
+    conn->execute("INSERT INTO products (sku, name, price) VALUES "
+                  "('a', 'Apple', 1.0), ('b', 'Banana', 2.0), ('c', 'Cherry', 3.0)");
+
+    for (bool multiRow : {false, true}) {
+        BatchUpsertBuilder sync(*conn, "products", {"sku", "name", "price"}, {"sku"});
+        sync.setMultiRowValues(multiRow).setBatchSize(2);
+        sync.addRow({Value{"a"}, Value{"Apple"}, Value{1.5}})
+            .addRow({Value{"b"}, Value{multiRow ? "Blueberry" : "Banana"}, Value{2.0}})
+            .addRow({Value{"d"}, Value{"Date"}, Value{4.0}});
+        ASSERT_EQ(sync.execute(), 3);
+    }
+
+    // Updated in place: same rowids, no delete trigger
+    auto apple = conn->prepare("SELECT id, price FROM products WHERE sku = 'a'");
+    ASSERT_TRUE(apple.step());
+    ASSERT_EQ(apple.columnInt64(0), 1);
+    ASSERT_TRUE(apple.columnDouble(1) == 1.5);
+    ASSERT_EQ(QueryBuilder(*conn, "products").count(), 4);
+    ASSERT_EQ(QueryBuilder(*conn, "deletions").count(), 0);
+    auto banana = conn->prepare("SELECT name FROM products WHERE sku = 'b'");
+    ASSERT_TRUE(banana.step());
+    ASSERT_EQ(banana.columnString(0), "Blueberry");
+
+    // Unchanged rows are not written at all
+    BatchUpsertBuilder resync(*conn, "products", {"sku", "name"}, {"sku"});
+    resync.setUpdateOnlyChanged();
+    resync.addRow({Value{"a"}, Value{"Apple"}}).addRow({Value{"c"}, Value{"Cranberry"}});
+    int64_t before = conn->totalChanges();
+    ASSERT_EQ(resync.execute(), 2);
+    ASSERT_EQ(conn->totalChanges() - before, 1);
+
+    // Only conflict columns: DO NOTHING
+    BatchUpsertBuilder ignore(*conn, "products", {"sku"}, {"sku"});
+    ignore.addRow({Value{"a"}}).addRow({Value{"e"}});
+    ignore.execute();
+    ASSERT_EQ(QueryBuilder(*conn, "products").count(), 5);
+
+    ASSERT_THROWS(BatchUpsertBuilder(*conn, "products", {"sku"}, {}), QueryException);
+}
+
+TEST(batch_insert_streaming) {
+    auto conn = Connection::inMemory();
+    conn->execute("CREATE TABLE items (id INTEGER PRIMARY KEY, name TEXT)");
+
+    BatchInsertBuilder batch(*conn, "items", {"name"});
+    batch.setStreaming().setBatchSize(10);
+
+    for (int i = 0; i < 25; ++i) {
+        std::vector<Value> row{Value{"item" + std::to_string(i)}};
+        batch.addRow(std::move(row));
+    }
+
+    // Two full batches are already committed; five rows are buffered
+    ASSERT_EQ(batch.rowCount(), 5u);
+    auto stmt = conn->prepare("SELECT COUNT(*) FROM items");
+    stmt.step();
+    ASSERT_EQ(stmt.columnInt64(0), 20);
+    stmt.reset();
+
+    ASSERT_EQ(batch.execute(), 25);
+    ASSERT_EQ(batch.rowCount(), 0u);
+    stmt.step();
+    ASSERT_EQ(stmt.columnInt64(0), 25);
+}
+
+TEST(batch_insert_from_producer) {
+    auto conn = Connection::inMemory();
+    conn->execute("CREATE TABLE items (id INTEGER PRIMARY KEY, value INTEGER)");
+
+    BatchInsertBuilder batch(*conn, "items", {"value"});
+    batch.setBatchSize(8);
+
+    int64_t next = 0;
+    int64_t inserted = batch.insertFrom([&](std::vector<Value>& row) {
+        if (next == 37) {
+            return false;
+        }
+        row.assign(1, Value{next++});
+        return true;
+    });
+
+    ASSERT_EQ(inserted, 37);
+    ASSERT_EQ(batch.rowCount(), 0u);
+
+    auto stmt = conn->prepare("SELECT COUNT(*), SUM(value) FROM items");
+    stmt.step();
+    ASSERT_EQ(stmt.columnInt64(0), 37);
+    ASSERT_EQ(stmt.columnInt64(1), 36 * 37 / 2);
+}
+
+// ========== Repository Tests ==========
+
+struct Item {
+    int64_t id = 0;
+    std::string name;
+};
+
+class ItemRepository : public Repository<Item> {
+public:
+    explicit ItemRepository(Connection& conn) : Repository(conn, "items") {}
+
+protected:
+    Item fromRow(Statement& stmt) override {
+        return Item{stmt.columnInt64(0), stmt.columnString(1)};
+    }
+
+    void bindForInsert(Statement& stmt, const Item& item) override {
+        stmt.bind(1, item.name);
+    }
+};
+
+TEST(repository_reuses_statements) {
+    auto conn = Connection::inMemory();
+    conn->execute("CREATE TABLE items (id INTEGER PRIMARY KEY, name TEXT)");
+    conn->execute("INSERT INTO items (name) VALUES ('a'), ('b'), ('c')");
+
+    ItemRepository repo(*conn);
+    conn->statementCache().resetStats();
+
+    for (int i = 0; i < 10; ++i) {
+        ASSERT_TRUE(repo.findById(2).has_value());
+        ASSERT_TRUE(repo.exists(3));
+        ASSERT_EQ(repo.count(), 3);
+    }
+
+    // One prepare per distinct query, then reused
+    ASSERT_EQ(conn->statementCacheStats().misses, 3u);
+    ASSERT_EQ(repo.findById(2)->name, "b");
+    ASSERT_TRUE(!repo.findById(42).has_value());
+
+    ASSERT_TRUE(repo.deleteById(1));
+    ASSERT_TRUE(!repo.deleteById(1));
+    ASSERT_EQ(repo.count(), 2);
+}
+
+struct Employee {
+    int64_t id;
+    std::string name;
+    std::string manager;  // Loaded through the repository from fromRow()
+};
+
+class EmployeeRepository : public Repository<Employee> {
+public:
+    explicit EmployeeRepository(Connection& conn) : Repository(conn, "emp") {}
+
+protected:
+    Employee fromRow(Statement& stmt) override {
+        Employee e{stmt.columnInt64(0), stmt.columnString(1), ""};
+        if (!stmt.isNull(2)) {
+            // Both lookups run while the caller's statement is mid-step
+            int64_t managerId = stmt.columnInt64(2);
+            e.manager = findById(managerId)->name;
+            if (findByIds({managerId}).size() != 1) {
+                throw std::runtime_error("manager not found by findByIds");
+            }
+        }
+        return e;
+    }
+
+    void bindForInsert(Statement& stmt, const Employee& e) override {
+        stmt.bind(1, e.name);
+    }
+};
+
+TEST(repository_from_row_reenters) {
+    auto conn = Connection::inMemory();
+    conn->execute("CREATE TABLE emp (id INTEGER PRIMARY KEY, name TEXT, manager_id INTEGER)");
+    conn->execute("INSERT INTO emp VALUES (1, 'Ada', NULL), (2, 'Bob', 1), (3, 'Cy', 2)");
+
+    EmployeeRepository repo(*conn);
+    auto cy = repo.findById(3);
+    ASSERT_EQ(cy->name, "Cy");
+    ASSERT_EQ(cy->manager, "Bob");
+
+    auto staff = repo.findByIds({2, 3});
+    ASSERT_EQ(staff.size(), 2u);
+    for (const auto& e : staff) {
+        ASSERT_EQ(e.manager, e.id == 2 ? "Ada" : "Bob");
+    }
+    ASSERT_EQ(repo.findById(1)->manager, "");
+}
+
+TEST(repository_find_all_result_set) {
+    auto conn = Connection::inMemory();
+    conn->execute("CREATE TABLE items (id INTEGER PRIMARY KEY, name TEXT)");
+    conn->execute("INSERT INTO items (name) VALUES ('a'), ('b')");
+
+    ItemRepository repo(*conn);
+    ResultSet rows = repo.findAllResultSet();
+    ASSERT_EQ(rows.rowCount(), repo.findAll().size());
+    ASSERT_EQ(std::string(rows[1].text(1)), "b");
+}
+
+TEST(blob_stream_chunks_and_reopens) {
+    auto conn = Connection::inMemory();
+    conn->execute("CREATE TABLE items (id INTEGER PRIMARY KEY, name TEXT, data BLOB)");
+
+    // Reserve, then stream 300 KB in without a buffer of that size
+    std::string payload(300 * 1000, '\0');
+    for (size_t i = 0; i < payload.size(); ++i) {
+        payload[i] = static_cast<char>(i * 31 % 251);
+    }
+    auto insert = conn->prepare("INSERT INTO items (name, data) VALUES (?, ?)");
+    insert.bind(1, "big").bindZeroBlob(2, payload.size()).execute();
+    int64_t rowid = conn->lastInsertRowId();
+    {
+        BlobStream out(*conn, "items", "data", rowid, BlobMode::ReadWrite);
+        std::istringstream in(payload);
+        ASSERT_EQ(out.copyFrom(in, 4096), payload.size());
+        ASSERT_EQ(out.remaining(), 0);
+        ASSERT_THROWS(out.write("x", 1), DatabaseException);  // Can't grow
+    }
+
+    ItemRepository repo(*conn);
+    BlobStream in = repo.openBlob(rowid, "data");
+    ASSERT_EQ(in.size(), payload.size());
+    size_t chunks = 0;
+    std::string copy;
+    in.forEachChunk([&](BlobView chunk) {
+        ++chunks;
+        copy.append(reinterpret_cast<const char*>(chunk.data), chunk.size);
+    });
+    ASSERT_EQ(chunks, 5u);  // 64 KiB chunks
+    ASSERT_TRUE(copy == payload);
+
+    char middle[3];
+    in.readAt(1000, middle, 3);
+    ASSERT_TRUE(std::string(middle, 3) == payload.substr(1000, 3));
+
+    // One handle walks other rows
+    conn->execute("INSERT INTO items (name, data) VALUES ('small', x'0102030405')");
+    in.reopen(conn->lastInsertRowId());
+    ASSERT_EQ(in.size(), 5);
+    uint8_t bytes[8];
+    ASSERT_EQ(in.read(bytes, sizeof(bytes)), 5u);
+    ASSERT_EQ(bytes[4], 5);
+    ASSERT_THROWS(in.reopen(999), DatabaseException);
+
+    // Updating the row expires an open handle
+    BlobStream stale(*conn, "items", "data", rowid);
+    conn->execute("UPDATE items SET name = 'renamed' WHERE id = " + std::to_string(rowid));
+    ASSERT_THROWS(stale.readChunk(), DatabaseException);
+    ASSERT_THROWS(BlobStream(*conn, "items", "missing", rowid), DatabaseException);
+}
+
+TEST(repository_find_by_ids) {
+    auto conn = Connection::inMemory();
+    conn->execute("CREATE TABLE items (id INTEGER PRIMARY KEY, name TEXT)");
+
+    BatchInsertBuilder batch(*conn, "items", {"name"});
+    for (int i = 0; i < 200; ++i) {
+        batch.addRow({Value{"item" + std::to_string(i)}});
+    }
+    batch.execute();
+
+    ItemRepository repo(*conn);
+    std::vector<int64_t> ids;
+    for (int64_t id = 1; id <= 150; id += 2) {
+        ids.push_back(id);
+    }
+    ids.push_back(9999);  // Missing ids are skipped
+
+    auto items = repo.findByIds(ids);
+    ASSERT_EQ(items.size(), 75u);
+    for (const auto& item : items) {
+        ASSERT_TRUE(item.id % 2 == 1 && item.id < 150);
+    }
+    ASSERT_TRUE(repo.findByIds({}).empty());
+}
+
+TEST(repository_for_each) {
+    auto conn = Connection::inMemory();
+    conn->execute("CREATE TABLE items (id INTEGER PRIMARY KEY, name TEXT)");
+    conn->execute("INSERT INTO items (name) VALUES ('a'), ('b'), ('c')");
+
+    ItemRepository repo(*conn);
+    int visited = 0;
+    repo.forEach([&](const Item&) { ++visited; });
+    ASSERT_EQ(visited, 3);
+
+    visited = 0;
+    repo.forEach([&](const Item& item) {
+        ++visited;
+        return item.name != "b";  // Stop after "b"
+    });
+    ASSERT_EQ(visited, 2);
+}
+
+// ========== Typed Repository Tests ==========
+
+struct Person {
+    int64_t id = 0;
+    std::string name;
+    std::optional<int> age;
+    double score = 0.0;
+    std::vector<uint8_t> avatar;
+};
+
+namespace sqlite3db {
+template<>
+struct EntitySchema<Person> {
+    static constexpr const char* table = "people";
+    static constexpr auto primaryKey = column("id", &Person::id);
+    static constexpr auto columns = std::make_tuple(
+        column("name", &Person::name),
+        column("age", &Person::age),
+        column("score", &Person::score),
+        column("avatar", &Person::avatar));
+};
+} // namespace sqlite3db
+
+TEST(typed_repository_crud) {
+    auto conn = Connection::inMemory();
+    conn->execute("CREATE TABLE people (id INTEGER PRIMARY KEY, name TEXT NOT NULL, "
+                  "age INTEGER, score REAL, avatar BLOB)");
+
+    TypedRepository<Person> people(*conn);
+    int64_t aliceId = people.insert(Person{0, "Alice", 30, 9.5, {1, 2}});
+    int64_t bobId = people.insert(Person{0, "Bob", std::nullopt, 7.0, {}});
+    ASSERT_EQ(people.count(), 2);
+
+    auto alice = people.findById(aliceId);
+    ASSERT_TRUE(alice.has_value());
+    ASSERT_EQ(alice->name, "Alice");
+    ASSERT_EQ(*alice->age, 30);
+    ASSERT_TRUE(alice->score == 9.5);
+    ASSERT_EQ(alice->avatar.size(), 2u);
+
+    auto bob = people.findById(bobId);
+    ASSERT_TRUE(!bob->age.has_value());
+
+    bob->age = 41;
+    ASSERT_TRUE(people.update(*bob));
+    ASSERT_EQ(*people.findById(bobId)->age, 41);
+
+    auto all = people.findAll();
+    ASSERT_EQ(all.size(), 2u);
+
+    // A nested scan doesn't restart the outer one
+    size_t pairs = 0;
+    people.forEach([&](const Person&) { pairs += people.findAll().size(); });
+    ASSERT_EQ(pairs, 4u);
+
+    ASSERT_TRUE(people.deleteById(aliceId));
+    ASSERT_TRUE(!people.findById(aliceId).has_value());
+    ASSERT_EQ(people.count(), 1);
+}
+
+// ========== Connection Pool Tests ==========
+
+TEST(connection_pool_reader_writer) {
+    TempDatabase db("pool");
+    PoolOptions opts;
+    opts.readerCount = 2;
+    ConnectionPool pool(db.path, opts);
+
+    {
+        auto writer = pool.acquireWriter();
+        ASSERT_TRUE(writer.isWriter());
+        writer->execute("CREATE TABLE test (id INTEGER PRIMARY KEY)");
+        writer->execute("INSERT INTO test DEFAULT VALUES");
+    }
+
+    auto r1 = pool.acquireReader();
+    auto r2 = pool.acquireReader();
+    ASSERT_EQ(pool.idleReaders(), 0u);
+    ASSERT_EQ(QueryBuilder(*r1, "test").count(), 1);
+
+    // Readers are read-only
+    ASSERT_THROWS(r2->execute("INSERT INTO test DEFAULT VALUES"), DatabaseException);
+
+    // Bounded wait when the pool is exhausted
+    ASSERT_THROWS(pool.acquireReader(std::chrono::milliseconds(10)), ConnectionException);
+
+    r1.release();
+    ASSERT_EQ(pool.idleReaders(), 1u);
+}
+
+TEST(connection_pool_concurrent_readers) {
+    TempDatabase db("pool_threads");
+    PoolOptions opts;
+    opts.readerCount = 3;
+    ConnectionPool pool(db.path, opts);
+
+    {
+        auto writer = pool.acquireWriter();
+        writer->execute("CREATE TABLE test (id INTEGER PRIMARY KEY)");
+        writer->execute("INSERT INTO test DEFAULT VALUES");
+    }
+
+    std::atomic<int> total{0};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 6; ++t) {
+        threads.emplace_back([&] {
+            for (int i = 0; i < 20; ++i) {
+                auto reader = pool.acquireReader();
+                total += static_cast<int>(QueryBuilder(*reader, "test").count());
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    ASSERT_EQ(total.load(), 120);
+    ASSERT_EQ(pool.idleReaders(), 3u);
+}
+
+TEST(connection_pool_rolls_back_abandoned_transaction) {
+    TempDatabase db("pool_txn");
+    ConnectionPool pool(db.path);
+
+    {
+        auto writer = pool.acquireWriter();
+        writer->execute("CREATE TABLE test (id INTEGER PRIMARY KEY)");
+        writer->execute("BEGIN");
+        writer->execute("INSERT INTO test DEFAULT VALUES");
+        // Returned without COMMIT
+    }
+
+    auto writer = pool.acquireWriter();
+    ASSERT_TRUE(sqlite3_get_autocommit(writer->handle()) != 0);
+    ASSERT_EQ(QueryBuilder(*writer, "test").count(), 0);
+    ASSERT_EQ(pool.checkHealth(), 0u);
+}
+
+TEST(connection_pool_keeps_connection_when_reopen_fails) {
+    TempDatabase db("pool_reopen");
+    PoolOptions opts;
+    opts.readerCount = 1;
+    ConnectionPool pool(db.path, opts);
+
+    // Fail both health checks (every statement interrupted), then make
+    // the path unopenable
+    auto interruptAll = [](void*) { return 1; };
+    sqlite3_progress_handler(pool.acquireWriter()->handle(), 1, interruptAll, nullptr);
+    sqlite3_progress_handler(pool.acquireReader()->handle(), 1, interruptAll, nullptr);
+    db.removeFiles();
+    std::filesystem::create_directory(db.path);
+
+    ASSERT_THROWS(pool.acquireWriter(), ConnectionException);
+    ASSERT_THROWS(pool.acquireReader(), ConnectionException);
+    ASSERT_TRUE(pool.writerIdle());
+    ASSERT_EQ(pool.idleReaders(), 1u);
+
+    // Once the path opens again, the next acquire reopens from the same slots
+    std::filesystem::remove(db.path);
+    {
+        auto writer = pool.acquireWriter(std::chrono::milliseconds(10));
+        writer->execute("CREATE TABLE test (id INTEGER PRIMARY KEY)");
+    }
+    auto reader = pool.acquireReader(std::chrono::milliseconds(10));
+    ASSERT_EQ(QueryBuilder(*reader, "test").count(), 0);
+}
+
+TEST(connection_pool_rejects_memory) {
+    ASSERT_THROWS(ConnectionPool pool(":memory:"), ConnectionException);
+}
+
+TEST(parallel_query_shards_match_serial) {
+    TempDatabase db("parallel");
+    PoolOptions poolOpts;
+    poolOpts.readerCount = 3;
+    ConnectionPool pool(db.path, poolOpts);
+    {
+        auto writer = pool.acquireWriter();
+        writer->execute("CREATE TABLE orders (id INTEGER PRIMARY KEY, amount REAL, status TEXT)");
+        BatchInsertBuilder batch(*writer, "orders", {"amount", "status"});
+        for (int i = 0; i < 1000; ++i) {
+            batch.addRow({Value{i * 0.5}, Value{i % 4 == 0 ? "open" : "closed"}});
+        }
+        batch.execute();
+    }
+
+    ParallelOptions opts;
+    opts.shards = 7;  // More shards than readers
+    ParallelQuery parallel(pool, opts);
+    auto open = [](Connection& c) { return QueryBuilder(c, "orders").where("status", "=", Value{"open"}); };
+
+    auto shards = parallel.plan(open);
+    ASSERT_EQ(shards.size(), 7u);
+    ASSERT_EQ(shards.front().first, 1);
+    ASSERT_EQ(shards.back().last, 1000);
+    for (size_t i = 1; i < shards.size(); ++i) {
+        ASSERT_EQ(shards[i].first, shards[i - 1].last + 1);
+    }
+
+    ASSERT_EQ(parallel.count(open), 250);
+    ASSERT_TRUE(std::abs(parallel.sum(open, "amount") - 62250.0) < 1e-6);
+
+    auto rows = parallel.fetchAll([](Connection& c) { return QueryBuilder(c, "orders").select("id"); });
+    ASSERT_EQ(rows.size(), 1000u);
+    for (size_t i = 0; i < rows.size(); ++i) {
+        ASSERT_EQ(std::get<int64_t>(rows[i][0]), static_cast<int64_t>(i + 1));  // Key order
+    }
+
+    auto longest = parallel.mapReduce(open,
+        [](QueryBuilder& q) { return q.select("MAX(amount)").fetchOne(); },
+        0.0, [](double best, std::optional<std::vector<Value>> row) {
+            auto* v = std::get_if<double>(&(*row)[0]);
+            return v ? std::max(best, *v) : best;
+        });
+    ASSERT_TRUE(longest == 498.0);
+
+    ASSERT_THROWS(parallel.count([](Connection& c) { return QueryBuilder(c, "orders").where("nope", "=", Value{1}); }),
+                  QueryException);
+    ASSERT_EQ(pool.idleReaders(), 3u);
+
+    ParallelOptions empty;
+    empty.keyRange = std::make_pair(int64_t(5), int64_t(4));
+    ASSERT_EQ(ParallelQuery(pool, empty).count(open), 0);
+}
+
+// ========== Write Queue Tests ==========
+
+TEST(write_queue_group_commits) {
+    TempDatabase db("write_queue");
+    {
+        Connection setup(db.path);
+        setup.execute("CREATE TABLE events (id INTEGER PRIMARY KEY, n INTEGER)");
+    }
+
+    WriteQueueOptions opts;
+    opts.maxBatchDelay = std::chrono::milliseconds(5);
+    WriteQueue queue(db.path, opts);
+
+    std::vector<std::thread> threads;
+    std::atomic<int> ok{0};
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&, t] {
+            std::vector<std::future<int64_t>> ids;
+            for (int i = 0; i < 25; ++i) {
+                ids.push_back(queue.submitInsert("events", {"n"}, {Value{int64_t(t * 100 + i)}}));
+            }
+            for (auto& id : ids) {
+                if (id.get() > 0) ++ok;
+            }
+        });
+    }
+    for (auto& th : threads) th.join();
+
+    ASSERT_EQ(ok.load(), 100);
+    auto stats = queue.stats();
+    ASSERT_EQ(stats.jobs, 100u);
+    ASSERT_TRUE(stats.batches < 100u);  // Writes were grouped
+
+    Connection reader(db.path);
+    auto count = reader.prepare("SELECT COUNT(*) FROM events");
+    count.step();
+    ASSERT_EQ(count.columnInt(0), 100);
+}
+
+TEST(write_queue_isolates_failed_jobs) {
+    TempDatabase db("write_queue_fail");
+    {
+        Connection setup(db.path);
+        setup.execute("CREATE TABLE t (id INTEGER PRIMARY KEY, v TEXT UNIQUE)");
+    }
+
+    WriteQueueOptions opts;
+    opts.maxBatchDelay = std::chrono::milliseconds(20);
+    WriteQueue queue(db.path, opts);
+
+    auto first = queue.submit([](Connection& c) { c.execute("INSERT INTO t (v) VALUES ('a')"); });
+    auto dup = queue.submit([](Connection& c) {
+        c.execute("INSERT INTO t (v) VALUES ('b')");
+        c.execute("INSERT INTO t (v) VALUES ('a')");  // Violates UNIQUE
+    });
+    auto value = queue.submit([](Connection& c) {
+        c.execute("INSERT INTO t (v) VALUES ('c')");
+        return std::string("done");
+    });
+    queue.flush().get();
+
+    first.get();
+    ASSERT_THROWS(dup.get(), ConstraintException);
+    ASSERT_EQ(value.get(), std::string("done"));
+
+    Connection reader(db.path);
+    auto stmt = reader.prepare("SELECT group_concat(v, '') FROM (SELECT v FROM t ORDER BY v)");
+    stmt.step();
+    ASSERT_EQ(stmt.columnString(0), std::string("ac"));  // 'b' rolled back with its job
+
+    queue.stop();
+    ASSERT_THROWS(queue.flush(), DatabaseException);
+}
+
+// ========== Async Executor Tests ==========
+
+TEST(async_executor_runs_builders) {
+    TempDatabase db("async");
+    AsyncExecutor executor(db.path);
+
+    executor.submit([](Connection& c) {
+        c.execute("CREATE TABLE users (id INTEGER PRIMARY KEY, name TEXT)");
+    }).get();
+
+    auto id = executor.insert([](Connection& c) {
+        return InsertBuilder(c, "users").value("name", Value{"Alice"});
+    });
+    ASSERT_EQ(id.get(), 1);
+
+    auto total = executor.transaction([](Connection& c, Transaction&) {
+        c.execute("INSERT INTO users (name) VALUES ('Bob')");
+        return c.changes();
+    });
+    ASSERT_EQ(total.get(), 1);
+
+    auto rows = executor.fetchAll([](Connection& c) { return QueryBuilder(c, "users").orderBy("id"); });
+    auto count = executor.count([](Connection& c) { return QueryBuilder(c, "users"); });
+    auto bob = executor.fetchOne([](Connection& c) {
+        return QueryBuilder(c, "users").select("name").where("id", "=", Value{int64_t(2)});
+    });
+
+    ASSERT_EQ(rows.get().size(), 2u);
+    ASSERT_EQ(count.get(), 2);
+    ASSERT_EQ(std::get<std::string>((*bob.get())[0]), std::string("Bob"));
+}
+
+TEST(async_executor_cancels_running_and_queued) {
+    AsyncExecutor executor(Connection::inMemory());
+
+    auto endless = executor.submit([](Connection& c) {
+        c.execute("WITH RECURSIVE n(x) AS (SELECT 1 UNION ALL SELECT x + 1 FROM n) "
+                  "SELECT count(*) FROM n");
+    });
+    auto queued = executor.submit([](Connection&) { return 42; });
+
+    queued.cancel();
+    ASSERT_THROWS(queued.get(), InterruptedException);
+    ASSERT_THROWS(endless.get(std::chrono::milliseconds(20)), InterruptedException);
+    ASSERT_THROWS(endless.get(), InterruptedException);  // The statement's own outcome
+
+    // The connection is usable again after the interrupt
+    auto next = executor.submit([](Connection& c) {
+        auto stmt = c.prepare("SELECT 7");
+        stmt.step();
+        return stmt.columnInt(0);
+    });
+    ASSERT_EQ(next.get(), 7);
+}
+
+// ========== Checkpoint Tests ==========
+
+TEST(checkpoint_manager_background_and_manual) {
+    TempDatabase db("checkpoint");
+    ConnectionOptions writerOpts;
+    writerOpts.walAutoCheckpoint = 250;
+    Connection writer(db.path, writerOpts);
+    writer.execute("CREATE TABLE t (id INTEGER PRIMARY KEY, payload TEXT)");
+
+    CheckpointOptions opts;
+    opts.pollInterval = std::chrono::milliseconds(10);
+    opts.frameThreshold = 20;
+    CheckpointManager checkpoints(db.path, opts);
+    checkpoints.attach(writer);
+
+    for (int i = 0; i < 100; ++i) {
+        writer.execute("INSERT INTO t (payload) VALUES (randomblob(2000))");
+    }
+
+    // The frame trigger wakes the background thread
+    for (int i = 0; i < 200 && checkpoints.metrics().checkpoints == 0; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    ASSERT_TRUE(checkpoints.metrics().checkpoints > 0);
+    ASSERT_TRUE(checkpoints.metrics().framesCheckpointed > 0);
+
+    // A reader pinning a snapshot keeps PASSIVE from finishing
+    {
+        Connection reader(db.path);
+        Transaction snapshot(reader);
+        reader.prepare("SELECT COUNT(*) FROM t").step();
+        writer.execute("INSERT INTO t (payload) VALUES (randomblob(2000))");
+        checkpoints.stop();
+        ASSERT_TRUE(!checkpoints.checkpoint(CheckpointMode::Passive).complete());
+    }
+
+    CheckpointResult result = checkpoints.checkpoint(CheckpointMode::Truncate);
+    ASSERT_TRUE(result.complete());
+    ASSERT_EQ(checkpoints.walSizeBytes(), 0);
+    ASSERT_TRUE(checkpoints.metrics().truncateCheckpoints >= 1u);
+
+    // Detaching restores the writer's own setting, not SQLite's default
+    checkpoints.detach(writer);
+    auto autoCheckpoint = writer.prepare("PRAGMA wal_autocheckpoint");
+    ASSERT_TRUE(autoCheckpoint.step());
+    ASSERT_EQ(autoCheckpoint.columnInt(0), 250);
+}
+
+// ========== Backup Tests ==========
+
+TEST(backup_steps_and_warm_loads_memory) {
+    TempDatabase file("backup");
+    auto cache = Connection::inMemory();
+    cache->execute("CREATE TABLE kv (k INTEGER PRIMARY KEY, v TEXT)");
+    cache->execute("WITH RECURSIVE n(i) AS (SELECT 1 UNION ALL SELECT i + 1 FROM n WHERE i < 2000) "
+                   "INSERT INTO kv SELECT i, printf('value %d', i) FROM n");
+
+    // Dump in small steps, reporting progress
+    BackupOptions opts;
+    opts.pagesPerStep = 4;
+    opts.stepDelay = std::chrono::milliseconds(0);
+    std::vector<BackupProgress> reports;
+    opts.onProgress = [&](const BackupProgress& p) { reports.push_back(p); return true; };
+    cache->backupTo(file.path, opts);
+    ASSERT_TRUE(reports.size() > 2);
+    ASSERT_TRUE(reports.front().remaining > 0);
+    ASSERT_EQ(reports.back().remaining, 0);
+    ASSERT_TRUE(reports.back().fraction() == 1.0);
+
+    // Warm-load a fresh in-memory database from the file
+    auto restored = Connection::inMemory();
+    restored->enableResultCache();
+    restored->execute("CREATE TABLE kv (k INTEGER PRIMARY KEY, v TEXT)");
+    ASSERT_EQ(QueryBuilder(*restored, "kv").cached().count(), 0);
+    restored->loadFrom(file.path);
+    ASSERT_EQ(QueryBuilder(*restored, "kv").cached().count(), 2000);
+
+    // Cancelling leaves the destination as it was
+    restored->execute("DELETE FROM kv WHERE k > 10");
+    BackupOptions cancel;
+    cancel.pagesPerStep = 1;
+    cancel.onProgress = [](const BackupProgress&) { return false; };
+    ASSERT_THROWS(restored->loadFrom(file.path, cancel), InterruptedException);
+    ASSERT_EQ(QueryBuilder(*restored, "kv").count(), 10);
+}
+
+TEST(backup_vacuum_into_snapshot) {
+    TempDatabase snapshot("vacuum_into");
+    auto conn = Connection::inMemory();
+    conn->execute("CREATE TABLE t (id INTEGER PRIMARY KEY, payload BLOB)");
+    conn->execute("WITH RECURSIVE n(i) AS (SELECT 1 UNION ALL SELECT i + 1 FROM n WHERE i < 200) "
+                  "INSERT INTO t (payload) SELECT randomblob(1000) FROM n");
+    conn->execute("DELETE FROM t WHERE id > 20");
+
+    conn->vacuumInto(snapshot.path);
+    auto copy = Connection::open(snapshot.path);
+    ASSERT_EQ(QueryBuilder(*copy, "t").count(), 20);
+    auto freelist = copy->prepare("PRAGMA freelist_count");
+    freelist.step();
+    ASSERT_EQ(freelist.columnInt(0), 0);
+
+    // VACUUM INTO never overwrites
+    ASSERT_THROWS(conn->vacuumInto(snapshot.path), QueryException);
+}
+
+// ========== Bulk Import/Export Tests ==========
+
+TEST(bulk_import_csv_and_export_round_trip) {
+    TempDatabase file("bulk_csv");
+    {
+        std::ofstream out(file.path, std::ios::binary);
+        out << "sku,name,qty\r\n";
+        for (int i = 0; i < 5000; ++i) {
+            out << "s" << i << ",item " << i << "," << i << "\n";
+        }
+        out << "quoted,\"comma, \"\"quote\"\"\nnewline\",\n";  // Empty qty
+    }
+
+    auto conn = Connection::inMemory();
+    conn->execute("CREATE TABLE stock (sku TEXT PRIMARY KEY, name TEXT, qty INTEGER)");
+    conn->execute("CREATE INDEX idx_stock_qty ON stock(qty)");
+
+    ImportOptions opts;
+    opts.batchSize = 700;
+    opts.emptyAsNull = true;
+    opts.bulkLoadPragmas = true;
+    opts.rebuildIndexes = true;
+    ASSERT_EQ(importFile(*conn, "stock", file.path, opts), 5001);
+    ASSERT_EQ(QueryBuilder(*conn, "stock").count(), 5001);
+    ASSERT_TRUE(conn->schemaCatalog()->table("stock")->index("idx_stock_qty") != nullptr);
+
+    auto odd = conn->prepare("SELECT name, qty, typeof(qty) FROM stock WHERE sku = 'quoted'");
+    ASSERT_TRUE(odd.step());
+    ASSERT_EQ(odd.columnString(0), "comma, \"quote\"\nnewline");
+    ASSERT_TRUE(odd.isNull(1));
+    auto typed = conn->prepare("SELECT typeof(qty) FROM stock WHERE sku = 's42'");
+    typed.step();
+    ASSERT_EQ(typed.columnString(0), "integer");  // Column affinity
+
+    // Export and re-import into a copy
+    QueryBuilder all(*conn, "stock");
+    all.orderBy("sku");
+    std::ostringstream csv;
+    ASSERT_EQ(exportQuery(all, csv), 5001);
+    ASSERT_TRUE(csv.str().rfind("sku,name,qty\n", 0) == 0);
+
+    conn->execute("CREATE TABLE copy (sku TEXT PRIMARY KEY, name TEXT, qty INTEGER)");
+    ImportOptions serial;
+    serial.parallelParse = false;
+    serial.emptyAsNull = true;
+    ASSERT_EQ(importText(*conn, "copy", csv.str(), serial), 5001);
+    auto same = conn->prepare("SELECT COUNT(*) FROM stock JOIN copy USING (sku) "
+                              "WHERE stock.name = copy.name AND stock.qty IS copy.qty");
+    same.step();
+    ASSERT_EQ(same.columnInt(0), 5001);
+
+    // Malformed input names the record
+    conn->execute("CREATE TABLE small (a PRIMARY KEY, b)");
+    ImportOptions noHeader;
+    noHeader.header = false;
+    noHeader.batchSize = 1;
+    try {
+        importText(*conn, "small", "1,2\n3,4\n5\n", noHeader);
+        ASSERT_TRUE(false);
+    } catch (const DatabaseException& e) {
+        ASSERT_TRUE(std::string(e.what()).find("record 3") != std::string::npos);
+    }
+
+    // Batches committed before a failed insert stay
+    ASSERT_THROWS(importText(*conn, "small", "1,2\n1,3\n", noHeader), ConstraintException);
+    ASSERT_EQ(QueryBuilder(*conn, "small").count(), 1);
+}
+
+TEST(bulk_import_ndjson_and_export) {
+    auto conn = Connection::inMemory();
+    conn->execute("CREATE TABLE events (id INTEGER PRIMARY KEY, kind TEXT, score REAL, tags TEXT, ok INTEGER)");
+
+    std::string input =
+        "{\"id\": 1, \"kind\": \"click\", \"score\": 1.5, \"tags\": [\"a\", {\"b\": 1}], \"ok\": true}\n"
+        "\n"
+        "{\"kind\": \"caf\\u00e9 \\\"x\\\"\", \"id\": 2, \"extra\": null}\r\n"
+        "{\"id\": 3, \"score\": -2e3, \"ok\": false}\n";
+
+    ImportOptions ndjson;
+    ndjson.format = DataFormat::NdJson;
+    ASSERT_EQ(importText(*conn, "events", input, ndjson), 3);
+
+    auto rows = QueryBuilder(*conn, "events").orderBy("id").fetchAll();
+    ASSERT_EQ(rows.size(), 3);
+    ASSERT_TRUE(std::get<double>(rows[0][2]) == 1.5);
+    ASSERT_EQ(std::get<std::string>(rows[0][3]), "[\"a\", {\"b\": 1}]");
+    ASSERT_EQ(std::get<int64_t>(rows[0][4]), 1);
+    ASSERT_EQ(std::get<std::string>(rows[1][1]), "caf\xc3\xa9 \"x\"");
+    ASSERT_TRUE(std::holds_alternative<NullValue>(rows[1][2]));
+    ASSERT_TRUE(std::get<double>(rows[2][2]) == -2000.0);
+
+    QueryBuilder query(*conn, "events");
+    query.select(std::vector<std::string>{"id", "kind", "ok"}).orderBy("id").limit(2);
+    std::ostringstream out;
+    ExportOptions json;
+    json.format = DataFormat::NdJson;
+    ASSERT_EQ(exportQuery(query, out, json), 2);
+    ASSERT_EQ(out.str(),
+              "{\"id\":1,\"kind\":\"click\",\"ok\":1}\n"
+              "{\"id\":2,\"kind\":\"caf\xc3\xa9 \\\"x\\\"\",\"ok\":null}\n");
+
+    ImportOptions broken = ndjson;
+    broken.columns = {"id"};
+    ASSERT_THROWS(importText(*conn, "events", "{\"id\": 9}\n{\"id\" 10}\n", broken), DatabaseException);
+}
+
+TEST(bulk_import_quotes_names_and_reads_fifos) {
+    auto conn = Connection::inMemory();
+    conn->execute("CREATE TABLE \"order items\" (\"first name\" TEXT, \"order\" INTEGER, "
+                  "\"say \"\"hi\"\"\" TEXT)");
+    conn->execute("CREATE INDEX \"idx \"\"order\"\"\" ON \"order items\" (\"order\")");
+
+    // Header names with spaces, keywords and quotes
+    ImportOptions opts;
+    opts.rebuildIndexes = true;
+    ASSERT_EQ(importText(*conn, "order items",
+                         "first name,order,\"say \"\"hi\"\"\"\nAda,1,x\nBob,2,y\n", opts), 2);
+    ASSERT_EQ(conn->schemaCatalog()->table("order items")->indexes.size(), 1u);
+
+    ImportOptions json;
+    json.format = DataFormat::NdJson;
+    ASSERT_EQ(importText(*conn, "order items", "{\"first name\": \"Cy\", \"order\": 3}\n", json), 1);
+
+    // A FIFO has no size to map; it is read to end of file
+    TempDatabase fifo("bulk_fifo");
+    ASSERT_EQ(::mkfifo(fifo.path.c_str(), 0600), 0);
+    std::thread producer([&] {
+        std::ofstream out(fifo.path);
+        out << "first name,order\nDee,4\nEve,5\n";
+    });
+    int64_t piped = importFile(*conn, "order items", fifo.path);
+    producer.join();
+    ASSERT_EQ(piped, 2);
+
+    auto stmt = conn->prepare("SELECT COUNT(*), SUM(\"order\") FROM \"order items\"");
+    ASSERT_TRUE(stmt.step());
+    ASSERT_EQ(stmt.columnInt(0), 5);
+    ASSERT_EQ(stmt.columnInt(1), 15);
+}
+
 // ========== Exception Tests ==========
 
 TEST(exception_query) {
@@ -355,6 +2208,68 @@ TEST(exception_constraint) {
     );
 }
 
+TEST(exception_busy) {
+    TempDatabase db("busy");
+    ConnectionOptions opts;
+    opts.busyTimeoutMs = 0;
+    Connection holder(db.path, opts);
+    Connection other(db.path, opts);
+    holder.execute("CREATE TABLE t (id INTEGER PRIMARY KEY)");
+
+    Transaction lock(holder, TransactionType::Immediate);
+    ASSERT_THROWS(other.execute("INSERT INTO t DEFAULT VALUES"), BusyException);
+    ASSERT_THROWS(other.prepare("INSERT INTO t DEFAULT VALUES").execute(), BusyException);
+}
+
+// ========== Retry Tests ==========
+
+TEST(retry_backoff_grows_and_caps) {
+    RetryPolicy policy;
+    policy.jitter = false;
+    policy.initialBackoff = std::chrono::milliseconds(2);
+    policy.maxBackoff = std::chrono::milliseconds(10);
+
+    ASSERT_EQ(policy.backoff(1).count(), 2000);
+    ASSERT_EQ(policy.backoff(2).count(), 4000);
+    ASSERT_EQ(policy.backoff(3).count(), 8000);
+    ASSERT_EQ(policy.backoff(4).count(), 10000);
+
+    int attempts = 0;
+    ASSERT_THROWS(withRetry(RetryPolicy::none(), [&] {
+        ++attempts;
+        throw QueryException("syntax", "SELEC 1", SQLITE_ERROR);
+    }), QueryException);
+    ASSERT_EQ(attempts, 1);  // Real errors are not retried
+}
+
+TEST(retry_transaction_restarts_on_busy) {
+    TempDatabase db("retry");
+    ConnectionOptions opts;
+    opts.busyTimeoutMs = 0;
+    Connection holder(db.path, opts);
+    Connection writer(db.path, opts);
+    holder.execute("CREATE TABLE t (id INTEGER PRIMARY KEY, v INTEGER)");
+
+    Transaction lock(holder, TransactionType::Immediate);
+
+    RetryPolicy policy;
+    policy.initialBackoff = std::chrono::milliseconds(1);
+    int attempts = 0;
+    int64_t id = withTransaction(writer, policy, [&](Transaction&) {
+        if (++attempts == 2) {
+            lock.commit();  // The competing writer finishes
+        }
+        writer.execute("INSERT INTO t (v) VALUES (7)");
+        return writer.lastInsertRowId();
+    });
+
+    ASSERT_EQ(attempts, 2);
+    ASSERT_EQ(id, 1);
+    auto stmt = holder.prepare("SELECT COUNT(*) FROM t");
+    stmt.step();
+    ASSERT_EQ(stmt.columnInt(0), 1);
+}
+
 // ========== Main ==========
 
 int main() {
@@ -367,12 +2282,29 @@ int main() {
     RUN_TEST(connection_open_memory);
     RUN_TEST(connection_execute_basic);
     RUN_TEST(connection_options);
+    RUN_TEST(connection_performance_pragmas);
 
     std::cout << "\nStatement tests:\n";
     RUN_TEST(statement_bind_and_execute);
     RUN_TEST(statement_query_results);
     RUN_TEST(statement_null_handling);
     RUN_TEST(statement_named_parameters);
+    RUN_TEST(statement_column_views);
+    RUN_TEST(statement_bind_static);
+
+    std::cout << "\nStatement cache tests:\n";
+    RUN_TEST(statement_cache_hit_and_miss);
+    RUN_TEST(statement_cache_returns_clean_handles);
+    RUN_TEST(statement_cache_eviction);
+    RUN_TEST(statement_cache_disabled);
+
+    std::cout << "\nSQL function tests:\n";
+    RUN_TEST(sql_scalar_functions);
+    RUN_TEST(sql_aggregate_and_window_functions);
+
+    std::cout << "\nProfiler tests:\n";
+    RUN_TEST(profiler_collects_statement_stats);
+    RUN_TEST(profiler_slow_query_callback);
 
     std::cout << "\nTransaction tests:\n";
     RUN_TEST(transaction_commit);
@@ -384,21 +2316,96 @@ int main() {
     std::cout << "\nMigration tests:\n";
     RUN_TEST(migration_apply);
     RUN_TEST(migration_partial);
+    RUN_TEST(migration_baseline_and_single_transaction);
+    RUN_TEST(migration_baseline_concurrent_cold_start);
 
     std::cout << "\nSchema validator tests:\n";
     RUN_TEST(schema_validator_pass);
     RUN_TEST(schema_validator_fail);
+    RUN_TEST(schema_catalog_snapshot);
+    RUN_TEST(schema_catalog_tolerates_stale_views);
+
+    std::cout << "\nIndex advisor tests:\n";
+    RUN_TEST(index_advisor_suggests_and_migrates);
+    RUN_TEST(index_advisor_reads_profile);
+    RUN_TEST(index_advisor_quotes_keyword_columns);
 
     std::cout << "\nQuery builder tests:\n";
     RUN_TEST(query_builder_select);
     RUN_TEST(query_builder_count);
+    RUN_TEST(query_builder_stream);
+    RUN_TEST(query_builder_compiled);
+
+    std::cout << "\nResult cache tests:\n";
+    RUN_TEST(result_cache_hits_and_invalidates);
+    RUN_TEST(result_cache_count_has_own_keys);
+    RUN_TEST(result_cache_skips_uncommitted_and_external_writes);
+
+    std::cout << "\nResource limit tests:\n";
+    RUN_TEST(memory_stats_and_sql_limits);
+    RUN_TEST(query_timeout_interrupts_long_statements);
+
+    std::cout << "\nColumnar tests:\n";
+    RUN_TEST(columnar_reader_fills_typed_batches);
+    RUN_TEST(columnar_reader_types_expressions);
+
+    std::cout << "\nResult set tests:\n";
+    RUN_TEST(result_set_matches_fetch_all);
 
     std::cout << "\nBatch insert tests:\n";
     RUN_TEST(batch_insert);
+    RUN_TEST(batch_insert_multi_row_values);
+    RUN_TEST(batch_upsert_updates_in_place);
+    RUN_TEST(batch_insert_streaming);
+    RUN_TEST(batch_insert_from_producer);
+
+    std::cout << "\nRepository tests:\n";
+    RUN_TEST(repository_reuses_statements);
+    RUN_TEST(repository_find_by_ids);
+    RUN_TEST(repository_find_all_result_set);
+    RUN_TEST(repository_from_row_reenters);
+    RUN_TEST(repository_for_each);
+    RUN_TEST(blob_stream_chunks_and_reopens);
+
+    std::cout << "\nTyped repository tests:\n";
+    RUN_TEST(typed_repository_crud);
+
+    std::cout << "\nConnection pool tests:\n";
+    RUN_TEST(connection_pool_reader_writer);
+    RUN_TEST(connection_pool_concurrent_readers);
+    RUN_TEST(connection_pool_rolls_back_abandoned_transaction);
+    RUN_TEST(connection_pool_keeps_connection_when_reopen_fails);
+    RUN_TEST(connection_pool_rejects_memory);
+    RUN_TEST(parallel_query_shards_match_serial);
+
+    std::cout << "\nWrite queue tests:\n";
+    RUN_TEST(write_queue_group_commits);
+    RUN_TEST(write_queue_isolates_failed_jobs);
+
+    std::cout << "\nAsync executor tests:\n";
+    RUN_TEST(async_executor_runs_builders);
+    RUN_TEST(async_executor_cancels_running_and_queued);
+
+    std::cout << "\nCheckpoint tests:\n";
+    RUN_TEST(checkpoint_manager_background_and_manual);
+
+    std::cout << "\nBackup tests:\n";
+    RUN_TEST(backup_steps_and_warm_loads_memory);
+    RUN_TEST(backup_vacuum_into_snapshot);
+
+    std::cout << "\nBulk import/export tests:\n";
+    RUN_TEST(bulk_import_csv_and_export_round_trip);
+    RUN_TEST(bulk_import_ndjson_and_export);
+    RUN_TEST(bulk_import_quotes_names_and_reads_fifos);
 
     std::cout << "\nException tests:\n";
     RUN_TEST(exception_query);
     RUN_TEST(exception_constraint);
+    RUN_TEST(exception_busy);
+
+    std::cout << "\nRetry tests:\n";
+    RUN_TEST(retry_backoff_grows_and_caps);
+    RUN_TEST(retry_transaction_restarts_on_busy);
 
     std::cout << "\n" << std::string(40, '=') << "\n";
     std::cout << "Results: " << passed << " passed, " << failed << " failed\n";